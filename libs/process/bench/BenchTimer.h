@@ -0,0 +1,72 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        BenchTimer.h
+// Project:     scLib
+// Purpose:     Timing helpers for process benchmarks
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SCPROCBENCHTIMER_H__
+#define _SCPROCBENCHTIMER_H__
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file BenchTimer.h
+/// \brief Timing helpers for process benchmarks
+///
+/// Benchmarks in this directory are standalone programs, each one is built
+/// from its source file and the library sources it lists in its header.
+
+// ----------------------------------------------------------------------------
+// Headers
+// ----------------------------------------------------------------------------
+#include <vector>
+#include <algorithm>
+
+#include "sc/dtypes.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+// ----------------------------------------------------------------------------
+// Functions
+// ----------------------------------------------------------------------------
+/// Returns monotonic time in ms, comparable between processes
+inline double benchNowMs()
+{
+#ifdef WIN32
+  LARGE_INTEGER freq, counter;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&counter);
+  return counter.QuadPart * 1000.0 / freq.QuadPart;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+#endif
+}
+
+/// Returns percentile (0 - 100) of samples, sorts samples
+inline double benchPercentile(std::vector<double> &samples, double percent)
+{
+  if (samples.empty())
+    return 0.0;
+  std::sort(samples.begin(), samples.end());
+  size_t pos = static_cast<size_t>(percent / 100.0 * (samples.size() - 1) + 0.5);
+  return samples[SC_MIN(pos, samples.size() - 1)];
+}
+
+inline double benchMean(const std::vector<double> &samples)
+{
+  double sum = 0.0;
+  for(std::vector<double>::const_iterator it = samples.begin(), epos = samples.end(); it != epos; ++it)
+    sum += *it;
+  return samples.empty()?0.0:sum / samples.size();
+}
+
+#endif // _SCPROCBENCHTIMER_H__
@@ -0,0 +1,178 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        OutputCaptureBench.cpp
+// Project:     scLib
+// Purpose:     Cost of capturing child output into shared memory (Linux)
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file OutputCaptureBench.cpp
+/// \brief Cost of capturing child output into shared memory (Linux)
+///
+/// Program is its own child: it writes given amount of data to stdout.
+/// Measured is time from spawn until whole output is in a shared memory
+/// block, for:
+/// - pipe, read() into scString, memcpy into block (usual way),
+/// - scProcessOutputCapture in ocmStream mode (splice from pipe to block),
+/// - scProcessOutputCapture in ocmDirect mode (child writes to block).
+///
+/// Build together with library sources: ProcessOutputCapture.cpp,
+/// ProcessLauncher.cpp, LinuxProcess.cpp, process.cpp, AnonSharedMemory.cpp,
+/// SharedMemory.cpp and SharedMemoryWarmer.cpp.
+///
+/// Usage: OutputCaptureBench [sizeMB=256] [chunkKB=64] [repeat=5]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "sc/proc/ProcessLauncher.h"
+#include "sc/proc/ProcessOutputCapture.h"
+#include "BenchTimer.h"
+
+// ----------------------------------------------------------------------------
+// Private declarations
+// ----------------------------------------------------------------------------
+/// argument which starts program as writing child
+const char *BENCH_WRITER_ARG = "--writer";
+const size_t BENCH_READ_BUFFER_SIZE = 64 * 1024;
+
+enum BenchMethod {
+  bmCopy,
+  bmStream,
+  bmDirect
+};
+
+// ----------------------------------------------------------------------------
+// Private functions
+// ----------------------------------------------------------------------------
+static void runWriter(size_t totalSize, size_t chunkSize)
+{
+  std::vector<char> chunk(chunkSize, 'x');
+  size_t left = totalSize;
+  while(left > 0) {
+    ssize_t res = write(STDOUT_FILENO, &chunk[0], SC_MIN(left, chunkSize));
+    if (res <= 0)
+      _exit(1);
+    left -= static_cast<size_t>(res);
+  }
+  _exit(0);
+}
+
+static scProcessId startWriter(const scString &exePath, const scString &params, int outputFd)
+{
+  scSpawnRequest request(exePath, params);
+  request.outputFd = outputFd;
+  scProcessId res = scProcessLauncher::spawn(request);
+  // static spawn leaves descriptor to caller
+  close(outputFd);
+  return res;
+}
+
+static size_t captureByCopy(const scString &exePath, const scString &params, size_t capacity)
+{
+  int fds[2];
+  if (pipe(fds) != 0)
+    return 0;
+
+  scAnonSharedMemory memory("bench_copy", capacity);
+  scProcessId pid = startWriter(exePath, params, fds[1]);
+
+  scString output;
+  std::vector<char> buffer(BENCH_READ_BUFFER_SIZE);
+  ssize_t res;
+  while((res = read(fds[0], &buffer[0], buffer.size())) > 0)
+    output.append(&buffer[0], static_cast<size_t>(res));
+  close(fds[0]);
+
+  size_t size = SC_MIN(output.size(), capacity);
+  memcpy(memory.getAddress(), output.data(), size);
+
+  waitpid(static_cast<pid_t>(pid), SC_NULL, 0);
+  return size;
+}
+
+static size_t captureToBlock(const scString &exePath, const scString &params, size_t capacity, scOutputCaptureMode mode)
+{
+  scProcessOutputCapture capture("bench_capture", capacity, mode);
+  scProcessId pid = startWriter(exePath, params, capture.releaseChildFd());
+
+  if (mode == ocmDirect)
+    // there is no end of output notification, wait for exit
+    waitpid(static_cast<pid_t>(pid), SC_NULL, 0);
+  capture.readAll();
+  if (mode != ocmDirect)
+    waitpid(static_cast<pid_t>(pid), SC_NULL, 0);
+
+  return capture.getSize();
+}
+
+static void runScenario(const char *title, BenchMethod method, const scString &exePath, const scString &params,
+  size_t totalSize, uint repeat)
+{
+  double bestMs = 0.0, sumMs = 0.0;
+  size_t size = 0;
+  for(uint i = 0; i < repeat; i++)
+  {
+    double start = benchNowMs();
+    if (method == bmCopy)
+      size = captureByCopy(exePath, params, totalSize);
+    else
+      size = captureToBlock(exePath, params, totalSize, (method == bmStream)?ocmStream:ocmDirect);
+    double elapsedMs = benchNowMs() - start;
+
+    sumMs += elapsedMs;
+    if ((i == 0) || (elapsedMs < bestMs))
+      bestMs = elapsedMs;
+  }
+
+  printf("%-28s %10.1fms %10.1fms %10.0fMB/s %s\n", title, bestMs, sumMs / repeat,
+    (bestMs > 0.0)?(totalSize / (1024.0 * 1024.0)) / (bestMs / 1000.0):0.0, (size == totalSize)?"":"size mismatch");
+}
+
+// ----------------------------------------------------------------------------
+// Main
+// ----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  if ((argc > 3) && (strcmp(argv[1], BENCH_WRITER_ARG) == 0))
+    runWriter(strtoul(argv[2], SC_NULL, 10), strtoul(argv[3], SC_NULL, 10));
+
+  size_t sizeMB = (argc > 1)?strtoul(argv[1], SC_NULL, 10):256;
+  size_t chunkKB = (argc > 2)?strtoul(argv[2], SC_NULL, 10):64;
+  uint repeat = (argc > 3)?static_cast<uint>(atoi(argv[3])):5;
+  repeat = SC_MAX(repeat, 1U);
+  size_t totalSize = sizeMB * 1024 * 1024;
+  size_t chunkSize = SC_MAX(chunkKB, static_cast<size_t>(1)) * 1024;
+
+  char exePath[4096];
+  ssize_t len = readlink("/proc/self/exe", exePath, sizeof(exePath) - 1);
+  if (len <= 0) {
+    perror("readlink");
+    return 1;
+  }
+  exePath[len] = '\0';
+
+  char params[128];
+  snprintf(params, sizeof(params), "%s %lu %lu", BENCH_WRITER_ARG, static_cast<unsigned long>(totalSize),
+    static_cast<unsigned long>(chunkSize));
+
+  printf("output: %luMB in %luKB writes, repeat: %u\n", static_cast<unsigned long>(sizeMB),
+    static_cast<unsigned long>(chunkKB), repeat);
+  printf("%-28s %12s %12s %14s\n", "method", "best", "mean", "throughput");
+
+  runScenario("pipe + string + memcpy", bmCopy, exePath, params, totalSize, repeat);
+  runScenario("capture ocmStream", bmStream, exePath, params, totalSize, repeat);
+  runScenario("capture ocmDirect", bmDirect, exePath, params, totalSize, repeat);
+
+  return 0;
+}
@@ -0,0 +1,176 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        ProcEnumBench.cpp
+// Project:     scLib
+// Purpose:     Cost of process enumeration by executable (Linux)
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file ProcEnumBench.cpp
+/// \brief Cost of process enumeration by executable (Linux)
+///
+/// Starts growing number of idle copies of itself and measures
+/// Linux_proc::CountProcessByExec (single /proc pass, executables compared
+/// by dev & inode) against snapshot-per-process lookup, the way
+/// W32_proc::CountProcessByExec works: each listed process is looked up
+/// again in a fresh /proc listing before its executable path is compared.
+/// Second method is quadratic, it is skipped above maxQuadratic processes.
+///
+/// Build together with library source LinuxProcess.cpp.
+///
+/// Usage: ProcEnumBench [maxProcesses=4000] [maxQuadratic=2000] [repeat=5]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <dirent.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "sc/proc/LinuxProcess.h"
+#include "BenchTimer.h"
+
+// ----------------------------------------------------------------------------
+// Private functions
+// ----------------------------------------------------------------------------
+static bool isPidName(const char *name, unsigned long &pid)
+{
+  char *endPtr;
+  if ((name[0] < '0') || (name[0] > '9'))
+    return false;
+  pid = strtoul(name, &endPtr, 10);
+  return (*endPtr == '\0');
+}
+
+/// Finds process in a new listing of /proc and reads its executable path
+static bool lookupExePath(unsigned long pid, char *output, size_t outputSize)
+{
+  DIR *dir = opendir("/proc");
+  if (dir == SC_NULL)
+    return false;
+
+  bool found = false;
+  struct dirent *entry;
+  unsigned long entryPid;
+  while (!found && ((entry = readdir(dir)) != SC_NULL))
+    found = isPidName(entry->d_name, entryPid) && (entryPid == pid);
+  closedir(dir);
+
+  if (!found)
+    return false;
+
+  char linkName[48];
+  snprintf(linkName, sizeof(linkName), "/proc/%lu/exe", pid);
+  ssize_t len = readlink(linkName, output, outputSize - 1);
+  if (len <= 0)
+    return false;
+  output[len] = '\0';
+  return true;
+}
+
+static unsigned int countBySnapshotPerProcess(const char *exePath)
+{
+  DIR *dir = opendir("/proc");
+  if (dir == SC_NULL)
+    return 0;
+
+  unsigned int res = 0;
+  unsigned long self = static_cast<unsigned long>(getpid());
+  char path[4096];
+  struct dirent *entry;
+  unsigned long pid;
+  while ((entry = readdir(dir)) != SC_NULL)
+  {
+    if (!isPidName(entry->d_name, pid) || (pid == self))
+      continue;
+    if (lookupExePath(pid, path, sizeof(path)) && (strcasecmp(path, exePath) == 0))
+      res++;
+  }
+  closedir(dir);
+  return res;
+}
+
+static void startIdle(std::vector<pid_t> &children, unsigned int count)
+{
+  while (children.size() < count)
+  {
+    pid_t pid = fork();
+    if (pid == 0) {
+      for(;;)
+        pause();
+    }
+    if (pid < 0) {
+      perror("fork");
+      break;
+    }
+    children.push_back(pid);
+  }
+}
+
+static void stopIdle(std::vector<pid_t> &children)
+{
+  for(std::vector<pid_t>::const_iterator it = children.begin(), epos = children.end(); it != epos; ++it)
+    kill(*it, SIGKILL);
+  for(std::vector<pid_t>::const_iterator it = children.begin(), epos = children.end(); it != epos; ++it)
+    waitpid(*it, SC_NULL, 0);
+  children.clear();
+}
+
+// ----------------------------------------------------------------------------
+// Main
+// ----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  unsigned int maxProcesses = (argc > 1)?static_cast<unsigned int>(atoi(argv[1])):4000;
+  unsigned int maxQuadratic = (argc > 2)?static_cast<unsigned int>(atoi(argv[2])):2000;
+  unsigned int repeat = (argc > 3)?static_cast<unsigned int>(atoi(argv[3])):5;
+  repeat = SC_MAX(repeat, 1U);
+
+  char exePath[4096];
+  ssize_t len = readlink("/proc/self/exe", exePath, sizeof(exePath) - 1);
+  if (len <= 0) {
+    perror("readlink");
+    return 1;
+  }
+  exePath[len] = '\0';
+
+  std::vector<pid_t> children;
+  printf("%10s %10s %14s %14s %10s\n", "copies", "found", "single pass", "per process", "ratio");
+
+  for(unsigned int count = 250; count <= maxProcesses; count *= 2)
+  {
+    startIdle(children, count);
+
+    unsigned int found = 0;
+    double start = benchNowMs();
+    for(unsigned int i = 0; i < repeat; i++)
+      found = Linux_proc::CountProcessByExec(exePath, true);
+    double singleMs = (benchNowMs() - start) / repeat;
+
+    if (children.size() <= maxQuadratic) {
+      start = benchNowMs();
+      unsigned int quadFound = countBySnapshotPerProcess(exePath);
+      double quadMs = benchNowMs() - start;
+      if (quadFound != found)
+        printf("warning: per process method found %u\n", quadFound);
+      printf("%10u %10u %12.2fms %12.2fms %9.1fx\n", static_cast<unsigned int>(children.size()), found,
+        singleMs, quadMs, (singleMs > 0.0)?quadMs / singleMs:0.0);
+    } else {
+      printf("%10u %10u %12.2fms %14s %10s\n", static_cast<unsigned int>(children.size()), found, singleMs, "-", "-");
+    }
+
+    if (children.size() < count)
+      break;
+  }
+
+  stopIdle(children);
+  return 0;
+}
@@ -0,0 +1,99 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        ProcessLauncherBench.cpp
+// Project:     scLib
+// Purpose:     Spawn rate of process launcher (Linux)
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file ProcessLauncherBench.cpp
+/// \brief Spawn rate of process launcher (Linux)
+///
+/// Starts given number of short-lived processes through scProcessLauncher
+/// with growing concurrency limit and reports spawns per second. Baseline
+/// is the thread-per-process pattern reduced to its system calls: one
+/// fork + exec followed by blocking waitpid per process.
+///
+/// Build together with library sources: ProcessLauncher.cpp,
+/// LinuxProcess.cpp and process.cpp.
+///
+/// Usage: ProcessLauncherBench [processCount=2000] [command=/bin/true]
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "sc/proc/ProcessLauncher.h"
+#include "BenchTimer.h"
+
+// ----------------------------------------------------------------------------
+// Private functions
+// ----------------------------------------------------------------------------
+static double runForkExec(const char *command, uint processCount)
+{
+  double start = benchNowMs();
+  for(uint i = 0; i < processCount; i++)
+  {
+    pid_t pid = fork();
+    if (pid == 0) {
+      execl(command, command, static_cast<char *>(SC_NULL));
+      _exit(127);
+    }
+    if (pid > 0)
+      waitpid(pid, SC_NULL, 0);
+  }
+  return benchNowMs() - start;
+}
+
+static double runLauncher(const char *command, uint processCount, uint maxRunning, uint &failedCount)
+{
+  scProcessLauncher launcher(maxRunning);
+  std::vector<scSpawnRequest> requests(processCount, scSpawnRequest(command, ""));
+
+  double start = benchNowMs();
+  launcher.launch(requests);
+  launcher.waitForAll();
+  double res = benchNowMs() - start;
+
+  failedCount = launcher.getFailedCount();
+  return res;
+}
+
+// ----------------------------------------------------------------------------
+// Main
+// ----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  uint processCount = (argc > 1)?static_cast<uint>(atoi(argv[1])):2000;
+  const char *command = (argc > 2)?argv[2]:"/bin/true";
+  processCount = SC_MAX(processCount, 1U);
+
+  printf("processes: %u, command: %s\n", processCount, command);
+  printf("%-24s %10s %12s %10s\n", "method", "limit", "spawns/s", "failed");
+
+  double elapsedMs = runForkExec(command, processCount);
+  printf("%-24s %10s %12.0f %10s\n", "fork + exec + waitpid", "1", processCount * 1000.0 / elapsedMs, "-");
+
+  const uint limits[] = {1, 4, 16, 64, 0};
+  for(uint i = 0; i < sizeof(limits) / sizeof(limits[0]); i++)
+  {
+    uint failedCount = 0;
+    elapsedMs = runLauncher(command, processCount, limits[i], failedCount);
+    char limitText[16];
+    if (limits[i] > 0)
+      snprintf(limitText, sizeof(limitText), "%u", limits[i]);
+    else
+      snprintf(limitText, sizeof(limitText), "none");
+    printf("%-24s %10s %12.0f %10u\n", "scProcessLauncher", limitText, processCount * 1000.0 / elapsedMs, failedCount);
+  }
+
+  return 0;
+}
@@ -0,0 +1,148 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        ZygoteStartBench.cpp
+// Project:     scLib
+// Purpose:     Time to first instruction of helper started from zygote (Linux)
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file ZygoteStartBench.cpp
+/// \brief Time to first instruction of helper started from zygote (Linux)
+///
+/// Program is its own helper. Measured is time from spawn request until the
+/// helper runs its job code: helper writes CLOCK_MONOTONIC time to its
+/// stdout (pipe passed as outputFd) as the first thing it does. Compared
+/// are posix_spawn + exec (scProcessLauncher::spawn) and fork from template
+/// (scProcessZygote::spawn), optionally with initialization cost simulated
+/// in helper, which the template pays only once.
+///
+/// Build together with library sources: ProcessZygote.cpp,
+/// ProcessLauncher.cpp, LinuxProcess.cpp and process.cpp.
+///
+/// Usage: ZygoteStartBench [iterations=500] [initMs=0]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "sc/proc/ProcessZygote.h"
+#include "BenchTimer.h"
+
+// ----------------------------------------------------------------------------
+// Private declarations
+// ----------------------------------------------------------------------------
+/// argument which starts program as helper
+const char *BENCH_HELPER_ARG = "--helper";
+/// environment variable with simulated initialization time of helper
+const char *BENCH_INIT_ENV = "SC_ZYGOTE_BENCH_INIT_MS";
+
+// ----------------------------------------------------------------------------
+// Private functions
+// ----------------------------------------------------------------------------
+static void initializeHelper()
+{
+  const char *value = getenv(BENCH_INIT_ENV);
+  if (value == SC_NULL)
+    return;
+
+  double end = benchNowMs() + atof(value);
+  while(benchNowMs() < end)
+    ;
+}
+
+static void runHelperJob()
+{
+  double now = benchNowMs();
+  ssize_t res = write(STDOUT_FILENO, &now, sizeof(now));
+  _exit((res == static_cast<ssize_t>(sizeof(now)))?0:1);
+}
+
+/// \return Returns false if helper could not be started
+static bool measureStart(const scString &exePath, scProcessZygote *zygote, double &delayMs)
+{
+  int fds[2];
+  if (pipe(fds) != 0)
+    return false;
+
+  scSpawnRequest request(exePath, BENCH_HELPER_ARG);
+  request.outputFd = fds[1];
+
+  double start = benchNowMs();
+  scProcessId pid = (zygote != SC_NULL)?zygote->spawn(request):scProcessLauncher::spawn(request);
+  close(fds[1]);
+
+  double helperTime = 0.0;
+  bool res = (pid != 0) && (read(fds[0], &helperTime, sizeof(helperTime)) == static_cast<ssize_t>(sizeof(helperTime)));
+  close(fds[0]);
+
+  if ((pid != 0) && (zygote == SC_NULL))
+    waitpid(static_cast<pid_t>(pid), SC_NULL, 0);
+
+  delayMs = helperTime - start;
+  return res;
+}
+
+static void runScenario(const char *title, const scString &exePath, scProcessZygote *zygote, uint iterations)
+{
+  std::vector<double> delays;
+  double delayMs;
+  for(uint i = 0; i < iterations; i++)
+    if (measureStart(exePath, zygote, delayMs))
+      delays.push_back(delayMs);
+
+  double mean = benchMean(delays);
+  double p50 = benchPercentile(delays, 50);
+  double p99 = benchPercentile(delays, 99);
+  printf("%-24s %8u %10.3fms %10.3fms %10.3fms\n", title, static_cast<uint>(delays.size()), p50, p99, mean);
+}
+
+// ----------------------------------------------------------------------------
+// Main
+// ----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  if ((argc > 1) && (strcmp(argv[1], BENCH_HELPER_ARG) == 0)) {
+    initializeHelper();
+    // returns in forked child when started as template
+    std::vector<scString> args;
+    scProcessZygote::serve(args);
+    runHelperJob();
+  }
+
+  uint iterations = (argc > 1)?static_cast<uint>(atoi(argv[1])):500;
+  const char *initMs = (argc > 2)?argv[2]:"0";
+  setenv(BENCH_INIT_ENV, initMs, 1);
+
+  char exePath[4096];
+  ssize_t len = readlink("/proc/self/exe", exePath, sizeof(exePath) - 1);
+  if (len <= 0) {
+    perror("readlink");
+    return 1;
+  }
+  exePath[len] = '\0';
+
+  printf("iterations: %u, helper initialization: %sms\n", iterations, initMs);
+  printf("%-24s %8s %12s %12s %12s\n", "method", "started", "p50", "p99", "mean");
+
+  runScenario("posix_spawn + exec", exePath, SC_NULL, iterations);
+
+  scProcessZygote zygote(exePath, BENCH_HELPER_ARG);
+  double delayMs;
+  // first request waits for initialization of template
+  if (!zygote.start() || !measureStart(exePath, &zygote, delayMs)) {
+    fprintf(stderr, "Template process could not be started\n");
+    return 1;
+  }
+  runScenario("fork from template", exePath, &zygote, iterations);
+
+  return 0;
+}
@@ -10,6 +10,7 @@
 #ifndef _LIMITSINGLEINSTANCE_H__
 #define _LIMITSINGLEINSTANCE_H__
 
+#ifdef WIN32
 #include <windows.h> 
 
 //This code is from Q243953 in case you lose the article and wonder
@@ -44,4 +45,22 @@ public:
     return (ERROR_ALREADY_EXISTS == m_dwLastError);
   }
 };
+#else
+#include "sc/proc/SingleInstance.h"
+
+// Abstract Unix socket, see scSingleInstance for forwarding to running instance
+class scLimitSingleInstance
+{
+protected:
+  scSingleInstance m_instance;
+
+public:
+  scLimitSingleInstance(const char *strMutexName): m_instance(strMutexName) {}
+
+  bool IsAnotherInstanceRunning() 
+  {
+    return m_instance.isAnotherInstanceRunning();
+  }
+};
+#endif
 #endif // _LIMITSINGLEINSTANCE_H__
@@ -0,0 +1,142 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        LinuxProcess.h
+// Project:     scLib
+// Purpose:     Process-related functions. Linux /proc.
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SCLINUXPROCESS_H__
+#define _SCLINUXPROCESS_H__
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file LinuxProcess.h
+///
+/// Linux counterpart of W32Process.h, used by proc:: functions.
+/// Process list is taken in one pass over /proc (getdents64), executables
+/// are compared by device and inode of /proc/<pid>/exe target, so a scan
+/// costs one stat per process, without per-process snapshots.
+/// Processes of other users whose exe link cannot be accessed are not
+/// matched by executable.
+
+// ----------------------------------------------------------------------------
+// Headers
+// ----------------------------------------------------------------------------
+#include <vector>
+#include <sys/types.h>
+
+#include "sc/dtypes.h"
+#include "sc/proc/ptypes.h"
+
+// ----------------------------------------------------------------------------
+// Simple type definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Forward class definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Constants
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Functions
+// ----------------------------------------------------------------------------
+namespace Linux_proc {
+
+#ifndef TA_FAILED
+#define TA_FAILED 0
+#define TA_SUCCESS_CLEAN 1
+#define TA_SUCCESS_KILL 2
+#define TA_SUCCESS_ANY 3
+#endif
+
+/// Identity of executable file
+struct ExecId {
+  dev_t dev;
+  ino_t inode;
+};
+
+/// Receives entries of /proc process directories
+class ProcessDirEnumerator {
+public:
+  ProcessDirEnumerator() {}
+  virtual ~ProcessDirEnumerator() {}
+  /// \param[in] dirInode inode of /proc/<pid>, changes when pid is reused
+  /// \param[in] procFd descriptor of /proc, for *at() calls
+  virtual void operator()(unsigned long pid, unsigned long long dirInode, int procFd) = 0;
+};
+
+unsigned long GetParentProcessId(unsigned long processId);
+bool ProcessExists(unsigned long pid);
+/// Reads parent and start time (clock ticks since boot) from /proc/<pid>/stat
+bool ReadProcessStat(unsigned long pid, unsigned long &ppid, unsigned long long &startTime);
+
+/// Asks process to finish, kills it after timeout
+/// @param[in] a_timeout timeout in ms
+unsigned int TerminateAppShort(unsigned long pid, unsigned long a_timeout);
+/// Sends SIGTERM to all processes, waits for all of them together (pidfd + epoll)
+/// and sends SIGKILL to each one still running after its timeout
+/// @param[in] timeouts timeout in ms per process, last value is used for the rest
+/// @param[out] results TA_* code per process, can be NULL
+/// @return Returns number of terminated processes
+unsigned int TerminateProcesses(const std::vector<unsigned long> &pids, const std::vector<unsigned long> &timeouts,
+  std::vector<unsigned int> *results);
+/// Collects process and its descendants from one /proc scan, parents first.
+/// Current process and its descendants are skipped.
+/// @return Returns number of processes
+unsigned int GetProcessTree(unsigned long rootPid, std::vector<unsigned long> &output);
+/// Terminates process with all descendants. Tree is frozen (cgroup.freeze
+/// or SIGSTOP with rescans), signalled with SIGTERM and thawed, processes
+/// still running after timeout are killed. When root process has its own
+/// cgroup v2 containing only processes of the tree, cgroup.kill is used at
+/// the end, so descendants forked during timeout do not escape.
+/// Terminated processes which are children of current process are reaped.
+/// @param[in] a_timeout timeout in ms, shared by all processes, 0 - kill at once
+/// @param[out] stats can be NULL
+/// @return Returns number of terminated processes, including ones killed by cgroup.kill
+unsigned int TerminateProcessTree(unsigned long rootPid, unsigned long a_timeout, scProcessTreeStats *stats);
+/// Applies scheduling and placement to one thread
+/// @param[in] tid thread id, 0 - calling thread
+/// @return Returns false if any setting failed. NUMA policy can be set only for calling thread.
+bool SetThreadScheduling(unsigned long tid, const scSchedulingParams &params);
+/// Applies scheduling and placement to all threads of process
+/// @param[in] pid 0 - current process
+/// @return Returns false if any setting failed. NUMA policy can be set only for calling thread of current process.
+bool SetProcessScheduling(unsigned long pid, const scSchedulingParams &params);
+/// Applies all settings to calling thread without allocations, for child between fork and exec
+bool SetSchedulingBeforeExec(const scSchedulingParams &params);
+/// Asks process to finish (SIGTERM)
+void PostCloseApp(unsigned long pid);
+scString GetExePath(unsigned long pid);
+/// Returns false if file does not exist
+bool GetExecId(const char *path, ExecId &output);
+bool GetProcessExecId(unsigned long pid, ExecId &output);
+
+bool CloseProcessByExec(const char *szExeName, bool excludeCurrent = true);
+/// Processes are terminated together, a_timeout is shared by all of them
+/// @param[in] a_timeout timeout in ms
+bool TerminateAppByExec(const char *szExeName, bool excludeCurrent = true, unsigned int a_timeout = 0);
+unsigned int CountProcessByExec(const char *szExeName, bool excludeCurrent = true);
+unsigned int EnumProcessByExec(const char *szExeName, bool excludeCurrent = true, scProcessEnumerator *enumProc = SC_NULL);
+unsigned int EnumProcesses(bool excludeCurrent = true, scProcessEnumerator *enumProc = SC_NULL);
+/// Single pass over /proc
+/// @param[in] execId executable to be matched, NULL for all processes
+unsigned int ScanProcesses(const ExecId *execId, bool excludeCurrent, scProcessEnumerator *enumProc);
+/// Single pass over /proc, returns number of processes
+unsigned int ScanProcessDir(ProcessDirEnumerator *enumProc);
+/// Reads executable identity relative to /proc descriptor
+bool GetProcessExecIdAt(int procFd, unsigned long pid, ExecId &output);
+
+}; // namespace Linux_proc
+
+
+// ----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+#endif // _SCLINUXPROCESS_H__
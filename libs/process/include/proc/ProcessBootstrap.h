@@ -0,0 +1,116 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        ProcessBootstrap.h
+// Project:     scLib
+// Purpose:     Shared memory block with data prepared for child processes
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SCPROCBOOTSTRAP_H__
+#define _SCPROCBOOTSTRAP_H__
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file ProcessBootstrap.h
+/// \brief Shared memory block with data prepared for child processes
+///
+/// Parent stores tables it already prepared in a named shared memory block
+/// (or reuses existing one of the same version) and passes block name to
+/// the child in environment variable SC_PROC_BOOTSTRAP. Child maps the block
+/// read-only at startup instead of rebuilding tables from disk.
+/// Data should be position-independent (offsets, not pointers).
+/// Block is created exclusively. Parent which finds block created by another
+/// one waits (up to SC_PROC_BOOTSTRAP_READY_TIMEOUT_MS) until it is filled and
+/// reuses it. Block of other version or size, or one left unfilled after the
+/// timeout (its creator died), is removed and created again (POSIX only).
+///
+/// Usage:
+/// \code
+///     // parent
+///     scProcessBootstrap boot("helper_tables", TABLES_VERSION, tablesSize, &tablesWriter);
+///     proc::startProcess(helperPath, params, false, false, boot.getName());
+///
+///     // child
+///     std::auto_ptr<scProcessBootstrap> boot(scProcessBootstrap::openInherited());
+///     if (boot.get() != SC_NULL)
+///       tables = static_cast<const Tables *>(boot->getData());
+///     else
+///       loadTables(tables);
+/// \endcode
+
+// ----------------------------------------------------------------------------
+// Headers
+// ----------------------------------------------------------------------------
+#include <memory>
+
+#include "sc/dtypes.h"
+#include "sc/proc/SharedMemory.h"
+#include "sc/proc/SharedMemoryBlock.h"
+
+// ----------------------------------------------------------------------------
+// Simple type definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Forward class definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Constants
+// ----------------------------------------------------------------------------
+/// environment variable with name of bootstrap block
+#define SC_PROC_BOOTSTRAP_ENV "SC_PROC_BOOTSTRAP"
+/// max wait for block being filled by another parent
+const uint SC_PROC_BOOTSTRAP_READY_TIMEOUT_MS = 10000;
+
+// ----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+class scProcessBootstrap {
+public:
+  /// Parent: creates block filled by writer, or reuses existing block with the same version and size
+  /// \param[in] a_useFlags use scsmOwner to remove block when object is destroyed
+  scProcessBootstrap(const scString &name, uint version, size_t size, scShmWinWriterIntf *writer, uint a_useFlags = scsmOwner);
+  /// Child: attaches existing block read-only
+  scProcessBootstrap(const scString &name);
+  virtual ~scProcessBootstrap();
+
+  /// Attaches block passed by parent, returns SC_NULL if there is none,
+  /// it is gone or not ready
+  static scProcessBootstrap *openInherited();
+  /// Returns name of block passed by parent, empty if none
+  static scString getInheritedName();
+
+  const void *getData() const;
+  size_t getDataSize() const;
+  uint getVersion() const;
+  const scString &getName() const;
+  /// Returns true if existing block was used instead of creating a new one
+  bool isReused() const;
+protected:
+  enum ExistingState {
+    esReused,
+    esStale,
+    esGone
+  };
+  /// \return Returns false if block already exists
+  bool createBlock(uint version, size_t size, scShmWinWriterIntf *writer, uint a_useFlags);
+  /// Waits until existing block is filled, uses it if version and size match
+  ExistingState openExisting(uint version, size_t size);
+  void checkHeader();
+private:
+  scProcessBootstrap(const scProcessBootstrap &);
+  scProcessBootstrap &operator=(const scProcessBootstrap &);
+private:
+  std::auto_ptr<scSharedMemory> m_memory;
+  scString m_name;
+  const char *m_data;
+  size_t m_dataSize;
+  uint m_version;
+  bool m_reused;
+};
+
+#endif // _SCPROCBOOTSTRAP_H__
@@ -0,0 +1,202 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        ProcessLauncher.h
+// Project:     scLib
+// Purpose:     Launching of many processes with limited concurrency
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SCPROCLAUNCHER_H__
+#define _SCPROCLAUNCHER_H__
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file ProcessLauncher.h
+/// \brief Launching of many processes with limited concurrency
+///
+/// Replacement for scStartProcessThread which does not need a thread per
+/// process. Requests are queued and started from the calling thread, at most
+/// maxRunning processes run at once. Exits of all started processes are
+/// tracked in one event loop (poll), which also starts queued requests.
+///
+/// On Linux processes are started with posix_spawn (vfork-based in glibc),
+/// without shell - params are split into arguments, double and single quotes
+/// group words. lowPriority selects SCHED_BATCH spawn attribute and lowers
+/// nice value, minimized (hidden window) starts process in new session with
+/// standard streams redirected to /dev/null. Exits are tracked with pidfd in
+/// one epoll set.
+/// On Win32 processes are started with CreateProcess, exits are tracked with
+/// WaitForMultipleObjects.
+///
+/// Usage:
+/// \code
+///     scProcessLauncher launcher(16);
+///     std::vector<scSpawnRequest> requests;
+///     for(uint i = 0; i < fileCount; i++)
+///       requests.push_back(scSpawnRequest(converterPath, files[i], true, true));
+///     launcher.launch(requests);
+///     launcher.waitForAll();
+/// \endcode
+
+// ----------------------------------------------------------------------------
+// Headers
+// ----------------------------------------------------------------------------
+#include <vector>
+#include <deque>
+#include <map>
+
+#include "sc/dtypes.h"
+#include "sc/proc/ptypes.h"
+
+// ----------------------------------------------------------------------------
+// Simple type definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Forward class definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Constants
+// ----------------------------------------------------------------------------
+/// exit code reported when it cannot be read (process is not a child)
+const int SC_PROC_EXIT_CODE_UNKNOWN = -1;
+
+// ----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+struct scSpawnRequest {
+  scString command;
+  scString params;
+  bool minimized;
+  bool lowPriority;
+  /// name of scProcessBootstrap block passed to child, empty if none
+  scString bootstrapName;
+  /// applied before exec (Linux: fork is used instead of posix_spawn)
+  scSchedulingParams scheduling;
+  /// Linux: descriptor used as child's stdout (see scProcessOutputCapture),
+  /// -1 - inherited. Closed by launch() once process is started, static
+  /// spawn() and spawners leave it open for the caller to close.
+  int outputFd;
+
+  scSpawnRequest(): minimized(false), lowPriority(false), outputFd(-1) {}
+  scSpawnRequest(const scString &a_command, const scString &a_params, bool a_minimized = false, bool a_lowPriority = false,
+    const scString &a_bootstrapName = scString("")):
+    command(a_command), params(a_params), minimized(a_minimized), lowPriority(a_lowPriority), bootstrapName(a_bootstrapName),
+    outputFd(-1) {}
+};
+
+/// Receives exits of launched processes
+class scProcessExitObserverIntf {
+public:
+  scProcessExitObserverIntf() {}
+  virtual ~scProcessExitObserverIntf() {}
+  /// \param[in] pid 0 if process could not be started
+  virtual void processExited(uint requestNo, scProcessId pid, int exitCode) = 0;
+};
+
+/// Starts process for request, used to replace default spawn method
+class scProcessSpawnerIntf {
+public:
+  scProcessSpawnerIntf() {}
+  virtual ~scProcessSpawnerIntf() {}
+  /// \return Returns ID of started process, 0 on failure
+  virtual scProcessId spawn(const scSpawnRequest &request) = 0;
+#ifndef WIN32
+  /// Used by scProcessLauncher. Spawners which start processes that are not
+  /// children of the caller return pidfd opened before the process could be
+  /// reaped, otherwise its pid could be reused before launcher opens one.
+  /// \param[out] pidFd pidfd owned by caller, -1 - launcher opens it by pid
+  virtual scProcessId spawnWithPidFd(const scSpawnRequest &request, int &pidFd)
+  {
+    pidFd = -1;
+    return spawn(request);
+  }
+#endif
+};
+
+class scProcessLauncher {
+public:
+  /// \param[in] maxRunning limit of processes running at once, 0 - no limit
+  scProcessLauncher(uint maxRunning = 0);
+  /// Finished processes are reaped, running processes are not stopped.
+  /// On Linux ownership of still running children passes to the caller,
+  /// they stay zombies after exit until reaped (e.g. waitpid(-1, ...)),
+  /// call waitForAll() before destruction to avoid that.
+  virtual ~scProcessLauncher();
+
+  void setObserver(scProcessExitObserverIntf *observer);
+  void setSpawner(scProcessSpawnerIntf *spawner);
+
+  /// Queues request and starts it if limit allows
+  /// \return Returns request number
+  uint launch(const scSpawnRequest &request);
+  /// Queues all requests
+  /// \return Returns number of first request, next ones are consecutive
+  uint launch(const std::vector<scSpawnRequest> &requests);
+
+  /// Processes exits and starts queued requests
+  /// \param[in] timeoutMs time to wait for first exit, 0 - do not wait
+  /// \return Returns number of processes which finished
+  uint poll(uint timeoutMs);
+  /// Waits until all requests are started and finished
+  /// \param[in] timeoutMs 0 - infinite
+  /// \return Returns false on timeout
+  bool waitForAll(uint timeoutMs = 0);
+
+  uint getRunningCount() const;
+  uint getQueuedCount() const;
+  uint getStartedCount() const;
+  uint getFailedCount() const;
+
+  /// Starts process without tracking, default spawn method. Unlike launch(),
+  /// request.outputFd is not closed - spawners call it and launcher closes
+  /// the descriptor after its spawner returns.
+  /// \return Returns ID of started process, 0 on failure
+  static scProcessId spawn(const scSpawnRequest &request);
+  /// Splits parameters into arguments, quotes group words, no other shell syntax
+  static void splitParams(const scString &params, std::vector<scString> &output);
+protected:
+  struct QueuedRequest {
+    uint requestNo;
+    scSpawnRequest request;
+  };
+  struct RunningProcess {
+    uint requestNo;
+    scProcessId pid;
+#ifdef WIN32
+    void *handle;
+#else
+    /// pidfd, -1 when exit is polled
+    int fd;
+#endif
+  };
+  typedef std::deque<QueuedRequest> RequestQueue;
+  typedef std::map<uint, RunningProcess> RunningMap;
+
+  void startQueued();
+  bool startProcess(const QueuedRequest &queued);
+  void finishProcess(RunningMap::iterator it, int exitCode);
+  uint waitForExits(uint timeoutMs);
+#ifndef WIN32
+  /// Checks processes without pidfd
+  uint checkPolledExits();
+#endif
+private:
+  scProcessLauncher(const scProcessLauncher &);
+  scProcessLauncher &operator=(const scProcessLauncher &);
+private:
+  uint m_maxRunning;
+  scProcessExitObserverIntf *m_observer;
+  scProcessSpawnerIntf *m_spawner;
+  uint m_nextRequestNo;
+  uint m_startedCount;
+  uint m_failedCount;
+  RequestQueue m_queue;
+  RunningMap m_running;
+  int m_epollFd;
+};
+
+#endif // _SCPROCLAUNCHER_H__
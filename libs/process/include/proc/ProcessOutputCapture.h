@@ -0,0 +1,120 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        ProcessOutputCapture.h
+// Project:     scLib
+// Purpose:     Captures child process output into shared memory block
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SCPROCOUTCAPTURE_H__
+#define _SCPROCOUTCAPTURE_H__
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file ProcessOutputCapture.h
+/// \brief Captures child process output into shared memory block (Linux)
+///
+/// Output of child is stored in anonymous shared memory (memfd) without
+/// copying it through buffers of launching process:
+/// - ocmStream: child writes to a pipe, data is moved from pipe to block
+///   with splice. Each poll passes newly arrived part of block to consumer,
+///   end of output is detected when all writers are closed.
+/// - ocmDirect: child's stdout is the block descriptor itself, writes land
+///   in block pages. Size is read from shared file offset, there is no
+///   notification - read output when process finished.
+/// In ocmStream output which does not fit in block is discarded, see
+/// isTruncated(). In ocmDirect block cannot grow, write which does not fit
+/// fails in child with EPERM.
+/// Block can be registered as scSharedMemoryBlock (not as owner) or sent
+/// to other process with scAnonSharedMemory::sendTo.
+/// Not thread-safe.
+///
+/// Usage:
+/// \code
+///     scProcessOutputCapture capture("helper_out", 64 * 1024 * 1024);
+///     scSpawnRequest request(helperPath, params);
+///     request.outputFd = capture.releaseChildFd();
+///     launcher.launch(request);
+///     while(capture.poll(100, &parser))
+///       launcher.poll(0);
+/// \endcode
+
+// ----------------------------------------------------------------------------
+// Headers
+// ----------------------------------------------------------------------------
+#include <memory>
+
+#include "sc/dtypes.h"
+#include "sc/proc/AnonSharedMemory.h"
+#include "sc/proc/SharedMemoryBlock.h"
+
+// ----------------------------------------------------------------------------
+// Simple type definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Forward class definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Constants
+// ----------------------------------------------------------------------------
+enum scOutputCaptureMode {
+  ocmStream,  ///< pipe, moved to block with splice
+  ocmDirect   ///< child writes to block descriptor
+};
+
+// ----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+class scProcessOutputCapture {
+public:
+  /// \param[in] name block name, for diagnostics only
+  /// \param[in] capacity max size of captured output
+  scProcessOutputCapture(const scString &name, size_t capacity, scOutputCaptureMode mode = ocmStream);
+  virtual ~scProcessOutputCapture();
+
+  scOutputCaptureMode getMode() const;
+  /// Returns descriptor for child's stdout (scSpawnRequest::outputFd),
+  /// caller takes ownership and has to close it after child is started
+  int releaseChildFd();
+
+  /// Moves available output into block, passes new part of block to consumer
+  /// \param[in] timeoutMs max wait for output, 0 - do not wait (ocmStream only)
+  /// \return Returns false when output is finished (ocmStream only)
+  bool poll(uint timeoutMs, scShmWinConsumerIntf *consumer = SC_NULL);
+  /// Reads output until all writers are closed (ocmStream) or once (ocmDirect)
+  void readAll(scShmWinConsumerIntf *consumer = SC_NULL);
+
+  const char *getData();
+  /// Returns size of captured output
+  size_t getSize() const;
+  size_t getCapacity() const;
+  /// Returns true if output was larger than block (ocmDirect: block was filled)
+  bool isTruncated() const;
+  /// Block with output, owned by capture object
+  scAnonSharedMemory *getMemory();
+protected:
+  /// Moves data from pipe to block until pipe is empty
+  /// \return Returns false on end of output
+  bool transfer();
+  /// Updates size from offset of descriptor shared with child
+  void updateDirectSize();
+  void closeReadFd();
+private:
+  scProcessOutputCapture(const scProcessOutputCapture &);
+  scProcessOutputCapture &operator=(const scProcessOutputCapture &);
+private:
+  scOutputCaptureMode m_mode;
+  std::auto_ptr<scAnonSharedMemory> m_memory;
+  size_t m_capacity;
+  size_t m_size;
+  bool m_truncated;
+  int m_readFd;
+  int m_childFd;
+  int m_nullFd;
+};
+
+#endif // _SCPROCOUTCAPTURE_H__
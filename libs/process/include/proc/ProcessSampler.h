@@ -0,0 +1,169 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        ProcessSampler.h
+// Project:     scLib
+// Purpose:     Periodic sampling of process resource usage
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SCPROCSAMPLER_H__
+#define _SCPROCSAMPLER_H__
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file ProcessSampler.h
+/// \brief Periodic sampling of process resource usage (Linux)
+///
+/// Files /proc/<pid>/stat, statm, io and status are opened once per process
+/// and re-read with pread on each sample, into fixed buffers parsed without
+/// allocations. Descriptors keep pointing to the original process, so a
+/// reused pid is never sampled by mistake - process which finished is
+/// removed from sampler.
+/// Optionally CPU time and context switches are taken from taskstats
+/// (netlink, needs CAP_NET_ADMIN) in one batch of requests for all
+/// processes, then stat and status files are not read.
+/// Samples are stored in a ring buffer, the oldest ones are overwritten.
+/// Not thread-safe.
+///
+/// Usage:
+/// \code
+///     scProcessSampler sampler(4096);
+///     sampler.addProcess(helperPid);
+///     ...
+///     // every 100 ms
+///     sampler.sample();
+///     ...
+///     sampler.enumSamples(&reportWriter);
+/// \endcode
+
+// ----------------------------------------------------------------------------
+// Headers
+// ----------------------------------------------------------------------------
+#include <vector>
+#include <boost/cstdint.hpp>
+
+#include "sc/dtypes.h"
+#include "sc/proc/ptypes.h"
+
+// ----------------------------------------------------------------------------
+// Simple type definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Forward class definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Constants
+// ----------------------------------------------------------------------------
+const uint SC_PROC_SAMPLER_DEF_CAPACITY = 4096;
+
+/// Sampled values, also used as valid flags of sample
+enum scProcessSampleField {
+  psfCpu = 1,
+  psfMemory = 2,
+  psfIo = 4,
+  psfContextSwitches = 8,
+  psfAll = 15
+};
+
+// ----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+/// Resource usage of process at given time, totals since process start
+struct scProcessSample {
+  /// CLOCK_MONOTONIC, in ns
+  boost::uint64_t time;
+  boost::uint64_t cpuUserUs;
+  boost::uint64_t cpuSystemUs;
+  boost::uint64_t rssBytes;
+  /// storage I/O
+  boost::uint64_t readBytes;
+  boost::uint64_t writeBytes;
+  boost::uint32_t voluntarySwitches;
+  boost::uint32_t involuntarySwitches;
+  boost::uint32_t pid;
+  /// scProcessSampleField values which are valid
+  boost::uint32_t fields;
+};
+
+class scProcessSampleEnumerator {
+public:
+  scProcessSampleEnumerator() {}
+  virtual ~scProcessSampleEnumerator() {}
+  virtual void operator()(const scProcessSample &sample) = 0;
+};
+
+class scProcessSampler {
+public:
+  /// \param[in] capacity number of samples kept in ring buffer
+  /// \param[in] fields scProcessSampleField values to be sampled
+  scProcessSampler(uint capacity = SC_PROC_SAMPLER_DEF_CAPACITY, uint fields = psfAll);
+  virtual ~scProcessSampler();
+
+  /// Opens /proc files of process
+  /// \return Returns false if process does not exist
+  bool addProcess(scProcessId pid);
+  void removeProcess(scProcessId pid);
+  uint getProcessCount() const;
+  /// Switches CPU and context switch sampling to taskstats
+  /// \return Returns false if taskstats is not available
+  bool useTaskstats(bool value = true);
+  bool isUsingTaskstats() const;
+
+  /// Takes one sample of each process, finished processes are removed
+  /// \return Returns number of samples taken
+  uint sample();
+  /// Enumerates samples from the oldest one
+  /// \param[in] pid process to be listed, 0 - all processes
+  /// \return Returns number of enumerated samples
+  uint enumSamples(scProcessSampleEnumerator *enumProc, scProcessId pid = 0) const;
+  bool getLastSample(scProcessId pid, scProcessSample &output) const;
+  uint getSampleCount() const;
+  void clearSamples();
+protected:
+  struct Entry {
+    scProcessId pid;
+    int statFd;
+    int statmFd;
+    int ioFd;
+    int statusFd;
+    /// start time reported by taskstats, detects reused pid
+    boost::uint32_t startTime;
+    scProcessSample current;
+    scProcessSample last;
+  };
+  typedef std::vector<Entry> EntryList;
+
+  /// Reads values not filled by taskstats
+  /// \return Returns false if process finished
+  bool readEntry(Entry &entry);
+  void closeEntry(Entry &entry);
+  /// Reads file from start into buffer
+  /// \return Returns false on error
+  bool readFile(int fd);
+  void pushSample(const scProcessSample &sample);
+  bool openTaskstats();
+  void closeTaskstats();
+  /// Reads CPU and context switches of all processes in one batch
+  void readTaskstats();
+private:
+  scProcessSampler(const scProcessSampler &);
+  scProcessSampler &operator=(const scProcessSampler &);
+private:
+  uint m_fields;
+  EntryList m_entries;
+  std::vector<scProcessSample> m_ring;
+  uint m_ringStart;
+  uint m_ringCount;
+  std::vector<char> m_buffer;
+  int m_taskstatsSocket;
+  boost::uint16_t m_taskstatsFamily;
+  boost::uint32_t m_taskstatsSeq;
+  boost::uint64_t m_ticksPerSecond;
+  boost::uint64_t m_pageSize;
+};
+
+#endif // _SCPROCSAMPLER_H__
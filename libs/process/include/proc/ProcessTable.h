@@ -0,0 +1,142 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        ProcessTable.h
+// Project:     scLib
+// Purpose:     Live table of system processes updated from kernel events
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SCPROCTABLE_H__
+#define _SCPROCTABLE_H__
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file ProcessTable.h
+///
+/// \brief Live table of system processes updated from kernel events (Linux)
+///
+/// Table is filled by one /proc scan, then updated incrementally from
+/// fork/exec/exit events of kernel proc connector (netlink). Subscribing
+/// needs CAP_NET_ADMIN, without it table is refreshed by diff of /proc
+/// scans, not more often than once per refresh interval.
+/// Pending changes are applied at the beginning of each query, so queries
+/// are answered from memory: existence, parent and count by executable
+/// cost one hash lookup (plus one stat of queried executable path).
+/// Not thread-safe.
+///
+/// Usage:
+/// \code
+///     scProcessTable table;
+///     table.start();
+///     ...
+///     if (table.countByExec(workerPath) < workerLimit)
+///       startWorker();
+/// \endcode
+
+// ----------------------------------------------------------------------------
+// Headers
+// ----------------------------------------------------------------------------
+#include <set>
+#include <boost/cstdint.hpp>
+#include <boost/unordered_map.hpp>
+
+#include "sc/dtypes.h"
+#include "sc/proc/ptypes.h"
+#include "sc/proc/LinuxProcess.h"
+
+// ----------------------------------------------------------------------------
+// Simple type definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Forward class definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Constants
+// ----------------------------------------------------------------------------
+const uint SC_PROC_TABLE_DEF_REFRESH_MS = 1000;
+
+// ----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+struct scProcessInfo {
+  scProcessId pid;
+  scProcessId ppid;
+  Linux_proc::ExecId exec;
+  bool execValid;
+  /// Clock ticks since boot
+  unsigned long long startTime;
+};
+
+class scProcessTable {
+public:
+  /// \param[in] refreshMs minimal interval of /proc rescans when events are not available
+  scProcessTable(uint refreshMs = SC_PROC_TABLE_DEF_REFRESH_MS);
+  virtual ~scProcessTable();
+
+  /// Subscribes to events and performs initial scan
+  void start();
+  void stop();
+  /// Returns true if table is updated from kernel events
+  bool isEventDriven() const;
+  /// Applies pending changes, called by queries
+  void update();
+  /// Rescans /proc, e.g. after event loss
+  void resync();
+
+  bool exists(scProcessId pid);
+  /// Returns 0 if process is unknown
+  scProcessId getParent(scProcessId pid);
+  bool getInfo(scProcessId pid, scProcessInfo &output);
+  uint countByExec(const scString &execPath, bool excludeCurrent = true);
+  uint enumByExec(const scString &execPath, bool excludeCurrent = true, scProcessEnumerator *enumProc = SC_NULL);
+  uint getProcessCount();
+protected:
+  struct ExecKey {
+    dev_t dev;
+    ino_t inode;
+    bool operator==(const ExecKey &rhs) const { return (dev == rhs.dev) && (inode == rhs.inode); }
+  };
+  struct ExecKeyHash {
+    size_t operator()(const ExecKey &key) const;
+  };
+  struct Entry {
+    scProcessInfo info;
+    unsigned long long dirInode;
+    uint scanNo;
+  };
+  typedef boost::unordered_map<scProcessId, Entry> EntryMap;
+  typedef std::set<scProcessId> PidSet;
+  typedef boost::unordered_map<ExecKey, PidSet, ExecKeyHash> ExecIndex;
+  friend class scProcessTableScanner;
+
+  bool subscribe();
+  void unsubscribe();
+  void readEvents();
+  void scanDiff();
+  void onFork(scProcessId parentPid, scProcessId childPid);
+  void onExec(scProcessId pid);
+  void onExit(scProcessId pid);
+  void addEntry(scProcessId pid, unsigned long long dirInode, int procFd);
+  void removeEntry(scProcessId pid);
+  void setExec(Entry &entry, bool valid, const Linux_proc::ExecId &exec);
+  bool findExec(const scString &execPath, ExecKey &output);
+  static boost::uint64_t getTimeMs();
+private:
+  scProcessTable(const scProcessTable &);
+  scProcessTable &operator=(const scProcessTable &);
+private:
+  uint m_refreshMs;
+  int m_socket;
+  bool m_started;
+  bool m_resyncNeeded;
+  uint m_scanNo;
+  boost::uint64_t m_lastScanTime;
+  EntryMap m_entries;
+  ExecIndex m_execIndex;
+};
+
+#endif // _SCPROCTABLE_H__
@@ -0,0 +1,121 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        ProcessZygote.h
+// Project:     scLib
+// Purpose:     Pre-forked template process for fast repeated launches
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SCPROCZYGOTE_H__
+#define _SCPROCZYGOTE_H__
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file ProcessZygote.h
+/// \brief Pre-forked template process for fast repeated launches (Linux)
+///
+/// Helper binary is started once as a template ("zygote"). After its
+/// initialization it calls scProcessZygote::serve(), which waits for
+/// requests on a Unix socket. For each request the template forks, the
+/// child receives arguments, environment and standard stream descriptors
+/// (SCM_RIGHTS) and returns from serve() to run the helper job, so exec,
+/// dynamic linking and initialization are paid once. Pid of the child is
+/// sent back to the requesting process together with pidfd, which template
+/// opens before the child can be reaped, so launcher never tracks a reused
+/// pid.
+///
+/// scProcessZygote is a spawner for scProcessLauncher, requests for other
+/// commands (or when the template cannot be started) use normal spawn.
+/// Children are not children of the launching process, so their exit codes
+/// are reported as SC_PROC_EXIT_CODE_UNKNOWN.
+/// Template process must be single-threaded when it calls serve().
+///
+/// Helper side:
+/// \code
+///     int main(int argc, char *argv[])
+///     {
+///       initialize();
+///       std::vector<scString> args;
+///       if (!scProcessZygote::serve(args))
+///         args.assign(argv, argv + argc);
+///       return runJob(args);
+///     }
+/// \endcode
+///
+/// Launching side:
+/// \code
+///     scProcessZygote zygote(helperPath);
+///     scProcessLauncher launcher(16);
+///     launcher.setSpawner(&zygote);
+///     launcher.launch(scSpawnRequest(helperPath, params));
+/// \endcode
+
+// ----------------------------------------------------------------------------
+// Headers
+// ----------------------------------------------------------------------------
+#include <vector>
+
+#include "sc/dtypes.h"
+#include "sc/proc/ptypes.h"
+#include "sc/proc/ProcessLauncher.h"
+
+// ----------------------------------------------------------------------------
+// Simple type definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Forward class definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Constants
+// ----------------------------------------------------------------------------
+/// environment variable set for template process, value: socket descriptor
+#define SC_PROC_ZYGOTE_ENV "SC_PROC_ZYGOTE_FD"
+
+// ----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+class scProcessZygote: public scProcessSpawnerIntf {
+public:
+  /// \param[in] command helper executable, requests for it are forked from template
+  /// \param[in] params parameters of template process
+  scProcessZygote(const scString &command, const scString &params = scString(""));
+  /// Stops template process
+  virtual ~scProcessZygote();
+
+  /// Starts template process, called by first spawn if needed
+  bool start();
+  /// Closes request socket, template process exits
+  void stop();
+  bool isRunning() const;
+  /// Returns pid of template process, 0 if not running
+  scProcessId getTemplatePid() const;
+
+  /// Forks child from template, not thread-safe
+  /// \return Returns ID of started process, 0 on failure
+  virtual scProcessId spawn(const scSpawnRequest &request);
+  /// As spawn(), returns pidfd of child received from template
+  virtual scProcessId spawnWithPidFd(const scSpawnRequest &request, int &pidFd);
+
+  /// Serves fork requests when started as template, returns in forked child
+  /// \param[out] args arguments of request, first one is command
+  /// \return Returns false if process was not started as template
+  static bool serve(std::vector<scString> &args);
+protected:
+  /// \return Returns false if request could not be delivered
+  /// \param[out] pidFd -1 if template could not open it
+  bool requestFork(const scSpawnRequest &request, scProcessId &pid, int &pidFd);
+private:
+  scProcessZygote(const scProcessZygote &);
+  scProcessZygote &operator=(const scProcessZygote &);
+private:
+  scString m_command;
+  scString m_params;
+  int m_socket;
+  scProcessId m_pid;
+};
+
+#endif // _SCPROCZYGOTE_H__
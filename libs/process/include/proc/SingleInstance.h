@@ -0,0 +1,122 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        SingleInstance.h
+// Project:     scLib
+// Purpose:     Single instance lock with forwarding of invocations
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SCSINGLEINSTANCE_H__
+#define _SCSINGLEINSTANCE_H__
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file SingleInstance.h
+/// \brief Single instance lock with forwarding of invocations (Linux)
+///
+/// First instance binds abstract Unix socket named after application and
+/// user, the name is released by kernel when process exits, so there are
+/// no stale locks. Next instances connect to it and forward arguments,
+/// working directory, environment and standard stream descriptors
+/// (SCM_RIGHTS). Primary instance runs the invocation with its already
+/// initialized state, writes directly to caller's terminal or pipes and
+/// returns exit code, so repeated invocations do not pay full startup.
+/// Only processes of the same user are served.
+///
+/// Usage:
+/// \code
+///     int main(int argc, char *argv[])
+///     {
+///       scSingleInstance instance("mytool");
+///       int exitCode;
+///       if (instance.forward(std::vector<scString>(argv, argv + argc), exitCode))
+///         return exitCode;
+///       initialize();
+///       if (!instance.isPrimary())
+///         return runCommand(argc, argv);
+///       ...
+///       // in event loop of primary
+///       instance.serve(&commandHandler, 100);
+///     }
+/// \endcode
+
+// ----------------------------------------------------------------------------
+// Headers
+// ----------------------------------------------------------------------------
+#include <vector>
+
+#include "sc/dtypes.h"
+#include "sc/proc/ptypes.h"
+
+// ----------------------------------------------------------------------------
+// Simple type definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Forward class definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Constants
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+/// Invocation forwarded by other instance
+struct scInstanceRequest {
+  /// first one is program name
+  std::vector<scString> args;
+  /// "NAME=value" entries
+  std::vector<scString> env;
+  scString workDir;
+  /// process which forwarded request
+  scProcessId pid;
+  /// standard streams of forwarding process, closed after handler returns
+  int stdinFd;
+  int stdoutFd;
+  int stderrFd;
+};
+
+class scInstanceRequestHandlerIntf {
+public:
+  scInstanceRequestHandlerIntf() {}
+  virtual ~scInstanceRequestHandlerIntf() {}
+  /// \return Returns exit code for forwarding process
+  virtual int handleRequest(const scInstanceRequest &request) = 0;
+};
+
+class scSingleInstance {
+public:
+  /// Becomes primary instance or connects to existing one
+  /// \param[in] name application name, unique per user
+  scSingleInstance(const scString &name);
+  virtual ~scSingleInstance();
+
+  bool isPrimary() const;
+  bool isAnotherInstanceRunning() const;
+  /// Returns listening socket of primary instance for use in event loop, -1 if none
+  int getHandle() const;
+
+  /// Runs invocation in primary instance, waits for its result
+  /// \param[out] exitCode exit code returned by handler
+  /// \return Returns false if there is no primary instance or it did not respond
+  bool forward(const std::vector<scString> &args, int &exitCode);
+  /// Handles pending requests, one at a time
+  /// \param[in] timeoutMs max wait for first request
+  /// \return Returns number of handled requests
+  uint serve(scInstanceRequestHandlerIntf *handler, uint timeoutMs = 0);
+protected:
+  void handleConnection(int connFd, scInstanceRequestHandlerIntf *handler);
+private:
+  scSingleInstance(const scSingleInstance &);
+  scSingleInstance &operator=(const scSingleInstance &);
+private:
+  int m_socket;
+  bool m_primary;
+  bool m_anotherRunning;
+};
+
+#endif // _SCSINGLEINSTANCE_H__
@@ -16,7 +16,8 @@
 /** \file StartProcessThread.h
 \brief Thread used to start process in background.
 
-Long description
+Uses one thread per started process, for launching many processes
+use scProcessLauncher (ProcessLauncher.h) instead.
 */
 
 // ----------------------------------------------------------------------------
@@ -45,7 +46,9 @@ Long description
 class scStartProcessThread: public wxThread
 {
 public:
-    scStartProcessThread(const scString& command, const scString &params, bool a_minimized, bool a_lowPriority); 
+    /// @param[in] bootstrapName name of scProcessBootstrap block passed to child, empty if none
+    scStartProcessThread(const scString& command, const scString &params, bool a_minimized, bool a_lowPriority,
+      const scString &bootstrapName = scString(""));
     virtual ExitCode Entry();
     virtual void OnExit();
     static void WaitForAll();
@@ -54,6 +57,7 @@ private:
     scString m_params;
     bool m_minimized;
     bool m_lowPriority;
+    scString m_bootstrapName;
 };
 
 
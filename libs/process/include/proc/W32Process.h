@@ -49,6 +49,10 @@ namespace W32_proc {
 
 unsigned long GetParentProcessId(unsigned long processId);
 bool ProcessExists(unsigned long pid);
+/// Collects process and its descendants from one snapshot, parents first.
+/// Current process and its descendants are skipped.
+/// @return Returns number of processes
+unsigned int GetProcessTree(unsigned long rootPid, std::vector<unsigned long> &output);
 
 /// @param[in] a_timeout timeout in ms
 DWORD WINAPI TerminateAppShort(DWORD dwPID, DWORD dwTimeout);
@@ -60,6 +64,18 @@ bool TerminateAppByExec(LPSTR szExeName, bool excludeCurrent = true, unsigned in
 unsigned int CountProcessByExec(LPSTR szExeName, bool excludeCurrent = true);
 unsigned int EnumProcessByExec(LPSTR szExeName, bool excludeCurrent = true, scProcessEnumerator *enumProc = SC_NULL);
 unsigned int EnumProcesses(bool excludeCurrent = true, scProcessEnumerator *enumProc = SC_NULL);
+/// Starts process, returns its ID or 0 on failure
+/// @param[in] envEntry "NAME=value" added to inherited environment, can be NULL
+/// @param[out] processHandle process handle to be closed by caller, can be NULL
+/// @param[in] scheduling applied before process starts running, can be NULL
+DWORD StartApp(LPCSTR szCommand, LPCSTR szParams, bool minimized, bool lowPriority, LPCSTR envEntry = NULL,
+  HANDLE *processHandle = NULL, const scSchedulingParams *scheduling = NULL);
+/// Applies scheduling to process, policies are mapped to priority classes.
+/// I/O class (background mode) only for current process, NUMA policy is not supported.
+/// @param[in] pid 0 - current process
+bool SetProcessScheduling(unsigned long pid, const scSchedulingParams &params);
+/// @param[in] tid 0 - calling thread
+bool SetThreadScheduling(unsigned long tid, const scSchedulingParams &params);
 
 }; // namespace W32_proc
 
@@ -20,6 +20,8 @@
 // ----------------------------------------------------------------------------
 // Headers
 // ----------------------------------------------------------------------------
+#include <vector>
+
 #include "sc/dtypes.h"
 #include "sc/proc/ptypes.h"
 
@@ -47,14 +49,40 @@ void sleepThisThreadMs(uint msecs);
 void sleepThisThreadUs(uint microSecs);
 
 scProcessId getCurrentProcessId();
+/// Returns system id of calling thread (not wxThread id)
+unsigned long getCurrentThreadId();
 scProcessId getParentProcessId(scProcessId processId);
 scProcessId getParentProcessId();
+/// Linux: finished child of calling process is reaped here, its exit status is lost
 bool processExists(scProcessId processId);
 
+/// Applies CPU affinity, scheduling policy, nice value, I/O priority and NUMA
+/// memory policy to all threads of process. Values left default are not changed.
+/// NUMA memory policy is set only for calling thread of current process
+/// (inherited by threads and processes started later).
+/// Use scSpawnRequest::scheduling to apply settings before exec.
+/// @param[in] processId 0 - current process
+/// @return Returns false if any setting failed
+bool setProcessScheduling(scProcessId processId, const scSchedulingParams &params);
+/// @param[in] threadId system thread id, 0 - calling thread
+/// @return Returns false if any setting failed
+bool setThreadScheduling(unsigned long threadId, const scSchedulingParams &params);
+
 void closeProcess(scProcessId processId);
 /// @param[in] a_timeout timeout in ms
 bool terminateProcess(scProcessId processId, unsigned long a_timeout = 0);
 
+/// Terminate several processes together
+/// @param[in] a_timeout timeout in ms, shared by all processes
+/// @return Returns number of terminated processes
+uint terminateProcesses(const std::vector<scProcessId> &pids, unsigned long a_timeout = 0);
+
+/// Terminate process with all its descendants, found in one process snapshot
+/// @param[in] a_timeout timeout in ms, shared by all processes
+/// @param[out] stats process count, terminated count and duration, can be NULL
+/// @return Returns number of terminated processes
+uint terminateProcessTree(scProcessId processId, unsigned long a_timeout = 0, scProcessTreeStats *stats = SC_NULL);
+
 void closeProcessByExec(const scString &execPath, bool excludeCurrent = true);
 
 /// Terminate process selected by executable path
@@ -66,6 +94,15 @@ bool terminateProcessByExec(const scString &execPath, bool excludeCurrent = true
 unsigned int countProcessByExec(const scString &execPath, bool excludeCurrent = true);
 unsigned int enumProcessByExec(const scString &execPath, bool excludeCurrent = true, scProcessEnumerator *enumProc = SC_NULL);
 
+/// Start process
+/// Linux: started process is a child of caller, it is reaped when processExists()
+/// finds it finished (or by caller's own waitpid). Command is searched in PATH and
+/// started directly, params are split like in scProcessLauncher::splitParams.
+/// @param[in] bootstrapName name of scProcessBootstrap block passed to child, empty if none
+/// @return Returns ID of started process, 0 on failure
+scProcessId startProcess(const scString &command, const scString &params, bool minimized = false, bool lowPriority = false,
+  const scString &bootstrapName = scString(""));
+
 }; // namespace
 
 // ----------------------------------------------------------------------------
@@ -20,6 +20,8 @@
 // ----------------------------------------------------------------------------
 // Headers
 // ----------------------------------------------------------------------------
+#include <vector>
+
 #include "sc/dtypes.h"
 
 // ----------------------------------------------------------------------------
@@ -34,6 +36,73 @@ public:
   virtual void operator()(scProcessId pid) = 0;
 };
 
+/// Scheduling policy, spDefault - not changed
+enum scSchedPolicy {
+  spDefault = 0,
+  spNormal,
+  /// CPU-bound, non-interactive
+  spBatch,
+  /// runs only when CPU is otherwise idle
+  spIdle,
+  /// real-time, needs privileges
+  spFifo,
+  spRoundRobin
+};
+
+/// I/O priority class, icDefault - not changed
+enum scIoClass {
+  icDefault = 0,
+  icRealTime,
+  icBestEffort,
+  icIdle
+};
+
+/// NUMA memory policy, npDefault - not changed
+enum scNumaPolicy {
+  npDefault = 0,
+  /// allocate on node of CPU which runs the thread
+  npLocal,
+  npBind,
+  npInterleave,
+  npPreferred
+};
+
+const int SC_PROC_NICE_UNCHANGED = 100;
+
+/// Scheduling and placement of process or thread, default values do not change anything
+struct scSchedulingParams {
+  scSchedPolicy policy;
+  /// static priority of spFifo and spRoundRobin, 1 - 99
+  int priority;
+  /// -20 - 19, SC_PROC_NICE_UNCHANGED - not changed
+  int nice;
+  /// CPU affinity, empty - not changed
+  std::vector<uint> cpus;
+  scIoClass ioClass;
+  /// 0 (highest) - 7, for icRealTime and icBestEffort
+  int ioLevel;
+  scNumaPolicy numaPolicy;
+  /// nodes for npBind, npInterleave and npPreferred
+  std::vector<uint> numaNodes;
+
+  scSchedulingParams(): policy(spDefault), priority(0), nice(SC_PROC_NICE_UNCHANGED), ioClass(icDefault), ioLevel(4),
+    numaPolicy(npDefault) {}
+  bool isDefault() const {
+    return (policy == spDefault) && (nice == SC_PROC_NICE_UNCHANGED) && cpus.empty() && (ioClass == icDefault) &&
+      (numaPolicy == npDefault);
+  }
+};
+
+/// Result of process tree termination
+struct scProcessTreeStats {
+  /// processes found in tree
+  uint processCount;
+  uint terminatedCount;
+  unsigned long durationMs;
+  /// true if tree was killed with its cgroup (cgroup.kill)
+  bool cgroupUsed;
+};
+
 // ----------------------------------------------------------------------------
 // Forward class definitions
 // ----------------------------------------------------------------------------
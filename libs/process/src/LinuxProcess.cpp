@@ -0,0 +1,1002 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        LinuxProcess.cpp
+// Project:     scLib
+// Purpose:     Process-related functions. Linux /proc.
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <set>
+#include <map>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <dirent.h>
+#include <time.h>
+#include <sched.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <sys/syscall.h>
+#include <sys/epoll.h>
+
+#include "sc/proc/LinuxProcess.h"
+
+#ifdef TRACE_IO_TIME
+#include "perf/Timer.h"
+using namespace perf;
+#endif
+
+namespace Linux_proc {
+
+// ----------------------------------------------------------------------------
+// /proc scanning
+// ----------------------------------------------------------------------------
+const size_t LINUX_PROC_DIR_BUFFER_SIZE = 64 * 1024;
+const unsigned long LINUX_PROC_WAIT_STEP_MS = 10;
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+#ifndef SYS_pidfd_send_signal
+#define SYS_pidfd_send_signal 424
+#endif
+
+// layout used by getdents64, not provided by libc headers
+struct linux_dirent64 {
+  unsigned long long d_ino;
+  long long d_off;
+  unsigned short d_reclen;
+  unsigned char d_type;
+  char d_name[1];
+};
+
+static bool parsePid(const char *name, unsigned long &pid)
+{
+  if ((*name < '1') || (*name > '9'))
+    return false;
+
+  unsigned long res = 0;
+  for(; *name != '\0'; ++name) {
+    if ((*name < '0') || (*name > '9'))
+      return false;
+    res = res * 10 + (*name - '0');
+  }
+  pid = res;
+  return true;
+}
+
+static void sleepMs(unsigned long value)
+{
+  struct timespec ts;
+  ts.tv_sec = value / 1000;
+  ts.tv_nsec = (value % 1000) * 1000000L;
+  nanosleep(&ts, SC_NULL);
+}
+
+static unsigned long long getTimeMs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<unsigned long long>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
+// process being terminated, fd is -1 if pidfd is not supported and exit is polled
+struct TerminateItem {
+  unsigned long pid;
+  int fd;
+  unsigned long long deadline;
+  unsigned int result;
+  bool done;
+};
+
+static bool sendSignal(const TerminateItem &item, int sig)
+{
+  if (item.fd >= 0)
+    return (syscall(SYS_pidfd_send_signal, item.fd, sig, SC_NULL, 0) == 0);
+  return (kill(static_cast<pid_t>(item.pid), sig) == 0);
+}
+
+/// Result for signal which was not sent, ESRCH: process exited meanwhile
+static unsigned int signalFailureResult()
+{
+  return (errno == ESRCH)?TA_SUCCESS_CLEAN:TA_FAILED;
+}
+
+static void finishItem(int epollFd, TerminateItem &item, unsigned int result)
+{
+  item.result = result;
+  item.done = true;
+  if (item.fd >= 0) {
+    if (epollFd >= 0)
+      epoll_ctl(epollFd, EPOLL_CTL_DEL, item.fd, SC_NULL);
+    close(item.fd);
+    item.fd = -1;
+  }
+}
+
+class scLinuxCollectEnumerator: public scProcessEnumerator {
+public:
+  scLinuxCollectEnumerator(): scProcessEnumerator() {}
+  virtual void operator()(scProcessId pid) { m_pids.push_back(pid); }
+  std::vector<unsigned long> &getPids() { return m_pids; }
+protected:
+  std::vector<unsigned long> m_pids;
+};
+
+// filters entries of /proc by executable
+class scLinuxExecFilter: public ProcessDirEnumerator {
+public:
+  scLinuxExecFilter(const ExecId *execId, bool excludeCurrent, scProcessEnumerator *enumProc):
+    ProcessDirEnumerator(), m_execId(execId), m_enumProc(enumProc), m_count(0)
+  {
+    m_skipPid = excludeCurrent?static_cast<unsigned long>(getpid()):0;
+  }
+
+  virtual void operator()(unsigned long pid, unsigned long long, int procFd)
+  {
+    if (pid == m_skipPid)
+      return;
+
+    if (m_execId != SC_NULL) {
+      ExecId execId;
+      if (!GetProcessExecIdAt(procFd, pid, execId) || (execId.dev != m_execId->dev) || (execId.inode != m_execId->inode))
+        return;
+    }
+
+    if (m_enumProc != SC_NULL)
+      (*m_enumProc)(pid);
+    ++m_count;
+  }
+
+  unsigned int getCount() const { return m_count; }
+protected:
+  const ExecId *m_execId;
+  scProcessEnumerator *m_enumProc;
+  unsigned long m_skipPid;
+  unsigned int m_count;
+};
+
+unsigned int ScanProcessDir(ProcessDirEnumerator *enumProc)
+{
+#ifdef TRACE_IO_TIME
+  Timer::start("proc-scan");
+#endif
+  unsigned int res = 0;
+  int dirFd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (dirFd >= 0)
+  {
+    std::vector<char> buffer(LINUX_PROC_DIR_BUFFER_SIZE);
+
+    for(;;) {
+      long readSize = syscall(SYS_getdents64, dirFd, &buffer[0], buffer.size());
+      if (readSize <= 0)
+        break;
+
+      for(long pos = 0; pos < readSize; ) {
+        const linux_dirent64 *entry = reinterpret_cast<const linux_dirent64 *>(&buffer[pos]);
+        pos += entry->d_reclen;
+
+        unsigned long pid;
+        if (((entry->d_type != DT_DIR) && (entry->d_type != DT_UNKNOWN)) || !parsePid(entry->d_name, pid))
+          continue;
+
+        (*enumProc)(pid, entry->d_ino, dirFd);
+        ++res;
+      }
+    }
+    close(dirFd);
+  }
+#ifdef TRACE_IO_TIME
+  Timer::stop("proc-scan");
+#endif
+  return res;
+}
+
+unsigned int ScanProcesses(const ExecId *execId, bool excludeCurrent, scProcessEnumerator *enumProc)
+{
+  scLinuxExecFilter filter(execId, excludeCurrent, enumProc);
+  ScanProcessDir(&filter);
+  return filter.getCount();
+}
+
+bool GetProcessExecIdAt(int procFd, unsigned long pid, ExecId &output)
+{
+  char exeName[32];
+  struct stat st;
+  // relative to /proc, stat follows the link to executable
+  snprintf(exeName, sizeof(exeName), "%lu/exe", pid);
+  if (fstatat(procFd, exeName, &st, 0) != 0)
+    return false;
+  output.dev = st.st_dev;
+  output.inode = st.st_ino;
+  return true;
+}
+
+bool GetExecId(const char *path, ExecId &output)
+{
+  struct stat st;
+  if (stat(path, &st) != 0)
+    return false;
+  output.dev = st.st_dev;
+  output.inode = st.st_ino;
+  return true;
+}
+
+bool GetProcessExecId(unsigned long pid, ExecId &output)
+{
+  char exeName[48];
+  snprintf(exeName, sizeof(exeName), "/proc/%lu/exe", pid);
+  return GetExecId(exeName, output);
+}
+
+scString GetExePath(unsigned long pid)
+{
+  char exeName[48];
+  char path[4096];
+  snprintf(exeName, sizeof(exeName), "/proc/%lu/exe", pid);
+  ssize_t len = readlink(exeName, path, sizeof(path) - 1);
+  if (len <= 0)
+    return scString("");
+  return scString(path, len);
+}
+
+bool ReadProcessStat(unsigned long pid, unsigned long &ppid, unsigned long long &startTime)
+{
+  char fname[48];
+  char buffer[1024];
+  snprintf(fname, sizeof(fname), "/proc/%lu/stat", pid);
+
+  int fd = open(fname, O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+  ssize_t len = read(fd, buffer, sizeof(buffer) - 1);
+  close(fd);
+  if (len <= 0)
+    return false;
+  buffer[len] = '\0';
+
+  // command name can contain spaces and ')', fields start after last ')'
+  const char *cptr = strrchr(buffer, ')');
+  if (cptr == SC_NULL)
+    return false;
+
+  char state;
+  int ppidValue;
+  unsigned long long startValue;
+  // fields 3 (state), 4 (ppid) ... 22 (starttime)
+  if (sscanf(cptr + 1, " %c %d %*d %*d %*d %*d %*u %*u %*u %*u %*u %*u %*u %*d %*d %*d %*d %*d %*d %llu",
+        &state, &ppidValue, &startValue) != 3)
+    return false;
+
+  ppid = static_cast<unsigned long>(ppidValue);
+  startTime = startValue;
+  return true;
+}
+
+unsigned long GetParentProcessId(unsigned long processId)
+{
+  unsigned long ppid;
+  unsigned long long startTime;
+  if (!ReadProcessStat(processId, ppid, startTime))
+    return 0;
+  return ppid;
+}
+
+bool ProcessExists(unsigned long pid)
+{
+  if (pid == 0)
+    return false;
+  // own finished child stays as zombie until it is reaped, kill() would report it alive
+  pid_t res;
+  do {
+    res = waitpid(static_cast<pid_t>(pid), SC_NULL, WNOHANG);
+  } while((res < 0) && (errno == EINTR));
+  if (res == static_cast<pid_t>(pid))
+    return false;
+  // EPERM: process exists, but belongs to other user
+  return (kill(static_cast<pid_t>(pid), 0) == 0) || (errno == EPERM);
+}
+
+void PostCloseApp(unsigned long pid)
+{
+  kill(static_cast<pid_t>(pid), SIGTERM);
+}
+
+unsigned int TerminateAppShort(unsigned long pid, unsigned long a_timeout)
+{
+  std::vector<unsigned long> pids(1, pid);
+  std::vector<unsigned long> timeouts(1, a_timeout);
+  std::vector<unsigned int> results;
+  TerminateProcesses(pids, timeouts, &results);
+  return results[0];
+}
+
+unsigned int TerminateProcesses(const std::vector<unsigned long> &pids, const std::vector<unsigned long> &timeouts,
+  std::vector<unsigned int> *results)
+{
+  unsigned long long startTime = getTimeMs();
+  std::vector<TerminateItem> items(pids.size());
+  int epollFd = epoll_create1(EPOLL_CLOEXEC);
+  size_t pending = 0;
+  bool polled = false;
+
+  for(size_t i = 0; i < pids.size(); i++)
+  {
+    TerminateItem &item = items[i];
+    item.pid = pids[i];
+    item.deadline = startTime + (timeouts.empty()?0:timeouts[SC_MIN(i, timeouts.size() - 1)]);
+    item.result = TA_FAILED;
+    item.done = false;
+    item.fd = (epollFd >= 0)?static_cast<int>(syscall(SYS_pidfd_open, static_cast<pid_t>(item.pid), 0)):-1;
+
+    if ((item.fd < 0) && (epollFd >= 0) && (errno == ESRCH)) {
+      // already gone
+      item.result = TA_SUCCESS_CLEAN;
+      item.done = true;
+      continue;
+    }
+
+    if (item.fd >= 0) {
+      struct epoll_event event;
+      std::memset(&event, 0, sizeof(event));
+      event.events = EPOLLIN;
+      event.data.u32 = static_cast<uint32_t>(i);
+      epoll_ctl(epollFd, EPOLL_CTL_ADD, item.fd, &event);
+    } else {
+      // ENOSYS, EMFILE / ENFILE with many processes: signal and poll with kill()
+      polled = true;
+    }
+
+    // whole set is asked to finish at once
+    if (!sendSignal(item, SIGTERM)) {
+      finishItem(epollFd, item, signalFailureResult());
+      continue;
+    }
+    ++pending;
+  }
+
+  std::vector<struct epoll_event> events(SC_MAX(pending, static_cast<size_t>(1)));
+  while (pending > 0)
+  {
+    unsigned long long now = getTimeMs();
+    unsigned long long nextDeadline = 0;
+    bool hasDeadline = false;
+
+    for(size_t i = 0; i < items.size(); i++)
+    {
+      TerminateItem &item = items[i];
+      if (item.done)
+        continue;
+
+      if ((item.fd < 0) && !ProcessExists(item.pid)) {
+        finishItem(epollFd, item, TA_SUCCESS_CLEAN);
+        --pending;
+      } else if (item.deadline <= now) {
+        finishItem(epollFd, item, sendSignal(item, SIGKILL)?TA_SUCCESS_KILL:signalFailureResult());
+        --pending;
+      } else if (!hasDeadline || (item.deadline < nextDeadline)) {
+        nextDeadline = item.deadline;
+        hasDeadline = true;
+      }
+    }
+
+    if (pending == 0)
+      break;
+
+    int waitMs = static_cast<int>(nextDeadline - now);
+    if (polled)
+      waitMs = SC_MIN(waitMs, static_cast<int>(LINUX_PROC_WAIT_STEP_MS));
+
+    if (epollFd < 0) {
+      sleepMs(waitMs);
+      continue;
+    }
+
+    // pidfd becomes readable when process exits
+    int cnt = epoll_wait(epollFd, &events[0], static_cast<int>(events.size()), waitMs);
+    for(int i = 0; i < cnt; i++)
+    {
+      TerminateItem &item = items[events[i].data.u32];
+      if (!item.done) {
+        finishItem(epollFd, item, TA_SUCCESS_CLEAN);
+        --pending;
+      }
+    }
+  }
+
+  if (epollFd >= 0)
+    close(epollFd);
+
+  unsigned int res = 0;
+  if (results != SC_NULL)
+    results->resize(items.size());
+  for(size_t i = 0; i < items.size(); i++) {
+    if ((items[i].result & TA_SUCCESS_ANY) != 0)
+      ++res;
+    if (results != SC_NULL)
+      (*results)[i] = items[i].result;
+  }
+  return res;
+}
+
+bool CloseProcessByExec(const char *szExeName, bool excludeCurrent)
+{
+  ExecId execId;
+  if (!GetExecId(szExeName, execId))
+    return false;
+
+  scLinuxCollectEnumerator enumer;
+  ScanProcesses(&execId, excludeCurrent, &enumer);
+
+  std::vector<unsigned long> &pids = enumer.getPids();
+  for(std::vector<unsigned long>::const_iterator it = pids.begin(), epos = pids.end(); it != epos; ++it)
+    PostCloseApp(*it);
+  return !pids.empty();
+}
+
+bool TerminateAppByExec(const char *szExeName, bool excludeCurrent, unsigned int a_timeout)
+{
+  ExecId execId;
+  if (!GetExecId(szExeName, execId))
+    return false;
+
+  scLinuxCollectEnumerator enumer;
+  ScanProcesses(&execId, excludeCurrent, &enumer);
+
+  std::vector<unsigned long> &pids = enumer.getPids();
+  if (pids.empty())
+    return false;
+
+  // total time is the timeout, not timeout per process
+  TerminateProcesses(pids, std::vector<unsigned long>(1, a_timeout), SC_NULL);
+  return true;
+}
+
+unsigned int CountProcessByExec(const char *szExeName, bool excludeCurrent)
+{
+  return EnumProcessByExec(szExeName, excludeCurrent, SC_NULL);
+}
+
+unsigned int EnumProcessByExec(const char *szExeName, bool excludeCurrent, scProcessEnumerator *enumProc)
+{
+  ExecId execId;
+  if (!GetExecId(szExeName, execId))
+    return 0;
+  return ScanProcesses(&execId, excludeCurrent, enumProc);
+}
+
+unsigned int EnumProcesses(bool excludeCurrent, scProcessEnumerator *enumProc)
+{
+  return ScanProcesses(SC_NULL, excludeCurrent, enumProc);
+}
+
+// ----------------------------------------------------------------------------
+// Scheduling
+// ----------------------------------------------------------------------------
+// ioprio and mempolicy values, not provided by libc headers
+const int LINUX_IOPRIO_CLASS_SHIFT = 13;
+const int LINUX_IOPRIO_WHO_PROCESS = 1;
+const int LINUX_MPOL_PREFERRED = 1;
+const int LINUX_MPOL_BIND = 2;
+const int LINUX_MPOL_INTERLEAVE = 3;
+const int LINUX_MPOL_LOCAL = 4;
+const unsigned int LINUX_MAX_NUMA_NODES = 1024;
+
+static bool setMemoryPolicy(const scSchedulingParams &params)
+{
+  const unsigned int bitsPerWord = sizeof(unsigned long) * 8;
+  unsigned long mask[LINUX_MAX_NUMA_NODES / (sizeof(unsigned long) * 8)];
+  std::memset(mask, 0, sizeof(mask));
+
+  for(std::vector<uint>::const_iterator it = params.numaNodes.begin(), epos = params.numaNodes.end(); it != epos; ++it)
+    if (*it < LINUX_MAX_NUMA_NODES)
+      mask[*it / bitsPerWord] |= (1UL << (*it % bitsPerWord));
+
+  int mode;
+  switch (params.numaPolicy) {
+    case npLocal:
+      return (syscall(SYS_set_mempolicy, LINUX_MPOL_LOCAL, SC_NULL, 0) == 0);
+    case npBind:
+      mode = LINUX_MPOL_BIND;
+      break;
+    case npInterleave:
+      mode = LINUX_MPOL_INTERLEAVE;
+      break;
+    case npPreferred:
+      mode = LINUX_MPOL_PREFERRED;
+      break;
+    default:
+      return true;
+  }
+
+  return (syscall(SYS_set_mempolicy, mode, mask, LINUX_MAX_NUMA_NODES + 1) == 0);
+}
+
+/// Applies settings without memory policy, does not allocate (used after fork)
+static bool setTaskScheduling(pid_t tid, const scSchedulingParams &params)
+{
+  bool res = true;
+
+  if (!params.cpus.empty()) {
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for(std::vector<uint>::const_iterator it = params.cpus.begin(), epos = params.cpus.end(); it != epos; ++it)
+      if (*it < CPU_SETSIZE)
+        CPU_SET(*it, &cpuSet);
+    res = (sched_setaffinity(tid, sizeof(cpuSet), &cpuSet) == 0) && res;
+  }
+
+  if (params.policy != spDefault) {
+    struct sched_param param;
+    std::memset(&param, 0, sizeof(param));
+    int policy;
+    switch (params.policy) {
+      case spBatch:
+        policy = SCHED_BATCH;
+        break;
+      case spIdle:
+        policy = SCHED_IDLE;
+        break;
+      case spFifo:
+        policy = SCHED_FIFO;
+        param.sched_priority = params.priority;
+        break;
+      case spRoundRobin:
+        policy = SCHED_RR;
+        param.sched_priority = params.priority;
+        break;
+      default:
+        policy = SCHED_OTHER;
+        break;
+    }
+    res = (sched_setscheduler(tid, policy, &param) == 0) && res;
+  }
+
+  // nice value is per thread on Linux
+  if (params.nice != SC_PROC_NICE_UNCHANGED)
+    res = (setpriority(PRIO_PROCESS, tid, params.nice) == 0) && res;
+
+  if (params.ioClass != icDefault) {
+    int ioClass = (params.ioClass == icRealTime)?1:((params.ioClass == icBestEffort)?2:3);
+    int ioLevel = (params.ioClass == icIdle)?0:SC_MIN(SC_MAX(params.ioLevel, 0), 7);
+    res = (syscall(SYS_ioprio_set, LINUX_IOPRIO_WHO_PROCESS, tid, (ioClass << LINUX_IOPRIO_CLASS_SHIFT) | ioLevel) == 0) && res;
+  }
+
+  return res;
+}
+
+bool SetThreadScheduling(unsigned long tid, const scSchedulingParams &params)
+{
+  bool currentThread = (tid == 0) || (tid == static_cast<unsigned long>(syscall(SYS_gettid)));
+  bool res = setTaskScheduling(static_cast<pid_t>(tid), params);
+
+  // memory policy can be set only by the thread itself
+  if (params.numaPolicy != npDefault)
+    res = (currentThread && setMemoryPolicy(params)) && res;
+
+  return res;
+}
+
+bool SetProcessScheduling(unsigned long pid, const scSchedulingParams &params)
+{
+  bool currentProcess = (pid == 0) || (pid == static_cast<unsigned long>(getpid()));
+  if (pid == 0)
+    pid = static_cast<unsigned long>(getpid());
+
+  char dirName[48];
+  snprintf(dirName, sizeof(dirName), "/proc/%lu/task", pid);
+  DIR *dir = opendir(dirName);
+  if (dir == SC_NULL)
+    return false;
+
+  bool res = true;
+  unsigned int count = 0;
+  struct dirent *entry;
+  unsigned long tid;
+  while((entry = readdir(dir)) != SC_NULL) {
+    if (!parsePid(entry->d_name, tid))
+      continue;
+    // thread can finish during the loop
+    if (!setTaskScheduling(static_cast<pid_t>(tid), params) && (errno != ESRCH))
+      res = false;
+    ++count;
+  }
+  closedir(dir);
+
+  if (params.numaPolicy != npDefault)
+    res = (currentProcess && setMemoryPolicy(params)) && res;
+
+  return res && (count > 0);
+}
+
+bool SetSchedulingBeforeExec(const scSchedulingParams &params)
+{
+  bool res = setTaskScheduling(0, params);
+  if (params.numaPolicy != npDefault)
+    res = setMemoryPolicy(params) && res;
+  return res;
+}
+
+// ----------------------------------------------------------------------------
+// Process tree
+// ----------------------------------------------------------------------------
+const unsigned int LINUX_PROC_TREE_FREEZE_PASSES = 3;
+const unsigned long LINUX_PROC_TREE_REAP_TIMEOUT_MS = 1000;
+const unsigned int LINUX_PROC_TREE_MAX_DEPTH = 256;
+const unsigned long LINUX_PROC_CGROUP_FREEZE_TIMEOUT_MS = 1000;
+
+// collects parent of each process during /proc scan
+class scLinuxParentCollector: public ProcessDirEnumerator {
+public:
+  typedef std::multimap<unsigned long, unsigned long> ChildMap;
+
+  scLinuxParentCollector(unsigned long rootPid): ProcessDirEnumerator(), m_rootPid(rootPid), m_rootFound(false) {}
+
+  virtual void operator()(unsigned long pid, unsigned long long, int)
+  {
+    unsigned long ppid;
+    unsigned long long startTime;
+    if (!ReadProcessStat(pid, ppid, startTime))
+      return;
+    if (pid == m_rootPid)
+      m_rootFound = true;
+    else
+      m_children.insert(std::make_pair(ppid, pid));
+  }
+
+  bool isRootFound() const { return m_rootFound; }
+  const ChildMap &getChildren() const { return m_children; }
+protected:
+  unsigned long m_rootPid;
+  bool m_rootFound;
+  ChildMap m_children;
+};
+
+static bool readTextFile(const scString &path, scString &output)
+{
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+
+  output.clear();
+  char buffer[4096];
+  ssize_t len;
+  while((len = read(fd, buffer, sizeof(buffer))) > 0)
+    output.append(buffer, len);
+  close(fd);
+  return (len == 0);
+}
+
+static bool writeTextFile(const scString &path, const char *value)
+{
+  int fd = open(path.c_str(), O_WRONLY | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+
+  size_t len = strlen(value);
+  bool res = (write(fd, value, len) == static_cast<ssize_t>(len));
+  close(fd);
+  return res;
+}
+
+/// Finds mount point of cgroup v2 hierarchy (/sys/fs/cgroup, or e.g. /sys/fs/cgroup/unified in hybrid mode)
+static bool getCgroupRoot(scString &output)
+{
+  scString content;
+  if (!readTextFile("/proc/self/mounts", content))
+    return false;
+
+  // "<device> <mount point> <type> ..."
+  for(size_t pos = 0; pos < content.size(); ) {
+    size_t endPos = content.find('\n', pos);
+    if (endPos == scString::npos)
+      endPos = content.size();
+
+    size_t dirPos = content.find(' ', pos);
+    size_t typePos = (dirPos < endPos)?content.find(' ', dirPos + 1):scString::npos;
+    if ((typePos < endPos) && (content.compare(typePos, 9, " cgroup2 ") == 0)) {
+      output = content.substr(dirPos + 1, typePos - dirPos - 1);
+      return true;
+    }
+    pos = endPos + 1;
+  }
+  return false;
+}
+
+/// Reads cgroup v2 path of process, relative to cgroup root
+static bool getProcessCgroup(unsigned long pid, scString &output)
+{
+  char fname[48];
+  snprintf(fname, sizeof(fname), "/proc/%lu/cgroup", pid);
+
+  scString content;
+  if (!readTextFile(fname, content))
+    return false;
+
+  // unified hierarchy: "0::<path>"
+  size_t pos = (content.compare(0, 3, "0::") == 0)?0:content.find("\n0::");
+  if (pos == scString::npos)
+    return false;
+  if (pos > 0)
+    ++pos;
+
+  size_t endPos = content.find('\n', pos);
+  output = content.substr(pos + 3, (endPos == scString::npos)?scString::npos:(endPos - pos - 3));
+  return !output.empty();
+}
+
+/// Freezes cgroup, waits (bounded) until all its processes are frozen
+static bool freezeCgroup(const scString &dir)
+{
+  if (!writeTextFile(dir + "/cgroup.freeze", "1"))
+    return false;
+
+  // freezing is asynchronous, processes can still fork until it is reported
+  unsigned long long endTime = getTimeMs() + LINUX_PROC_CGROUP_FREEZE_TIMEOUT_MS;
+  scString events;
+  while(readTextFile(dir + "/cgroup.events", events) && ((scString("\n") + events).find("\nfrozen 1") == scString::npos)) {
+    if (getTimeMs() >= endTime)
+      // signals are delivered to partially frozen group too
+      break;
+    sleepMs(LINUX_PROC_WAIT_STEP_MS);
+  }
+  return true;
+}
+
+/// Collects processes of cgroup and its sub-groups
+static void readCgroupProcs(const scString &dir, std::set<unsigned long> &output)
+{
+  scString content;
+  if (readTextFile(dir + "/cgroup.procs", content)) {
+    const char *cptr = content.c_str();
+    char *endPtr;
+    for(;;) {
+      unsigned long pid = strtoul(cptr, &endPtr, 10);
+      if (endPtr == cptr)
+        break;
+      output.insert(pid);
+      cptr = endPtr;
+    }
+  }
+
+  DIR *dirPtr = opendir(dir.c_str());
+  if (dirPtr == SC_NULL)
+    return;
+
+  struct dirent *entry;
+  while((entry = readdir(dirPtr)) != SC_NULL)
+    if ((entry->d_type == DT_DIR) && (entry->d_name[0] != '.'))
+      readCgroupProcs(dir + "/" + entry->d_name, output);
+  closedir(dirPtr);
+}
+
+/// Checks if process forked after tree snapshot descends from the tree
+static bool isTreeMember(unsigned long pid, const std::set<unsigned long> &treePids)
+{
+  unsigned long ppid;
+  unsigned long long startTime;
+  for(unsigned int level = 0; level < LINUX_PROC_TREE_MAX_DEPTH; level++) {
+    if (!ReadProcessStat(pid, ppid, startTime))
+      // already finished
+      return true;
+    if (treePids.find(ppid) != treePids.end())
+      return true;
+    if (ppid <= 1)
+      return false;
+    pid = ppid;
+  }
+  return false;
+}
+
+/// Returns directory of root's cgroup if it can be killed as a whole
+static bool findTreeCgroup(unsigned long rootPid, const std::vector<unsigned long> &pids, scString &output)
+{
+  scString rootGroup, ownGroup;
+  if (!getProcessCgroup(rootPid, rootGroup) || !getProcessCgroup(getpid(), ownGroup))
+    return false;
+
+  // shared or containing current process
+  if ((rootGroup == "/") || (ownGroup == rootGroup) || (ownGroup.compare(0, rootGroup.size() + 1, rootGroup + "/") == 0))
+    return false;
+
+  scString dir;
+  if (!getCgroupRoot(dir))
+    return false;
+  dir += rootGroup;
+  if (access((dir + "/cgroup.kill").c_str(), W_OK) != 0)
+    return false;
+
+  std::set<unsigned long> groupPids;
+  readCgroupProcs(dir, groupPids);
+
+  std::set<unsigned long> treePids(pids.begin(), pids.end());
+  for(std::set<unsigned long>::const_iterator it = groupPids.begin(), epos = groupPids.end(); it != epos; ++it)
+    if ((treePids.find(*it) == treePids.end()) && !isTreeMember(*it, treePids))
+      return false;
+
+  output = dir;
+  return true;
+}
+
+/// Stops tree with SIGSTOP, rescans for children forked before their parent stopped
+static void stopTree(unsigned long rootPid, std::vector<unsigned long> &pids)
+{
+  std::set<unsigned long> known(pids.begin(), pids.end());
+  for(std::vector<unsigned long>::const_iterator it = pids.begin(), epos = pids.end(); it != epos; ++it)
+    kill(static_cast<pid_t>(*it), SIGSTOP);
+
+  std::vector<unsigned long> current;
+  for(unsigned int pass = 0; pass < LINUX_PROC_TREE_FREEZE_PASSES; pass++) {
+    current.clear();
+    GetProcessTree(rootPid, current);
+
+    bool added = false;
+    for(std::vector<unsigned long>::const_iterator it = current.begin(), epos = current.end(); it != epos; ++it) {
+      if (!known.insert(*it).second)
+        continue;
+      pids.push_back(*it);
+      kill(static_cast<pid_t>(*it), SIGSTOP);
+      added = true;
+    }
+
+    if (!added)
+      break;
+  }
+}
+
+/// Waits until processes exit (including zombies), reaps own children
+static void waitForExit(const std::vector<unsigned long> &pids, unsigned long timeoutMs)
+{
+  unsigned long long deadline = getTimeMs() + timeoutMs;
+  int epollFd = epoll_create1(EPOLL_CLOEXEC);
+  std::vector<int> fds;
+  std::vector<unsigned long> polled;
+
+  for(size_t i = 0; i < pids.size(); i++) {
+    int fd = (epollFd >= 0)?static_cast<int>(syscall(SYS_pidfd_open, static_cast<pid_t>(pids[i]), 0)):-1;
+    if (fd >= 0) {
+      struct epoll_event event;
+      std::memset(&event, 0, sizeof(event));
+      event.events = EPOLLIN;
+      event.data.u64 = (static_cast<unsigned long long>(i) << 32) | static_cast<unsigned int>(fd);
+      epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+      fds.push_back(fd);
+    } else if ((epollFd < 0) || (errno == ENOSYS)) {
+      polled.push_back(pids[i]);
+    }
+  }
+
+  size_t pending = fds.size();
+  std::vector<struct epoll_event> events(SC_MAX(pending, static_cast<size_t>(1)));
+  for(;;) {
+    while(!polled.empty() && !ProcessExists(polled.back()))
+      polled.pop_back();
+
+    unsigned long long now = getTimeMs();
+    if (((pending == 0) && polled.empty()) || (now >= deadline))
+      break;
+
+    int waitMs = static_cast<int>(deadline - now);
+    if (!polled.empty())
+      waitMs = SC_MIN(waitMs, static_cast<int>(LINUX_PROC_WAIT_STEP_MS));
+
+    if (pending == 0) {
+      sleepMs(waitMs);
+      continue;
+    }
+
+    // pidfd becomes readable when process exits, stays readable, so remove it
+    int cnt = epoll_wait(epollFd, &events[0], static_cast<int>(events.size()), waitMs);
+    for(int i = 0; i < cnt; i++) {
+      int fd = static_cast<int>(events[i].data.u64 & 0xffffffffULL);
+      if (epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, SC_NULL) != 0)
+        continue;
+      --pending;
+      // own child stays as zombie until reaped, pidfd keeps its pid from reuse
+      pid_t pid = static_cast<pid_t>(pids[static_cast<size_t>(events[i].data.u64 >> 32)]);
+      while((waitpid(pid, SC_NULL, WNOHANG) < 0) && (errno == EINTR))
+        ;
+    }
+  }
+
+  for(std::vector<int>::const_iterator it = fds.begin(), epos = fds.end(); it != epos; ++it)
+    close(*it);
+  if (epollFd >= 0)
+    close(epollFd);
+}
+
+unsigned int GetProcessTree(unsigned long rootPid, std::vector<unsigned long> &output)
+{
+  scLinuxParentCollector collector(rootPid);
+  ScanProcessDir(&collector);
+
+  unsigned long currentPid = static_cast<unsigned long>(getpid());
+  if (!collector.isRootFound() || (rootPid == currentPid))
+    return 0;
+
+  typedef scLinuxParentCollector::ChildMap ChildMap;
+  const ChildMap &children = collector.getChildren();
+
+  size_t startSize = output.size();
+  output.push_back(rootPid);
+  for(size_t i = startSize; i < output.size(); i++) {
+    std::pair<ChildMap::const_iterator, ChildMap::const_iterator> range = children.equal_range(output[i]);
+    for(ChildMap::const_iterator it = range.first; it != range.second; ++it)
+      if (it->second != currentPid)
+        output.push_back(it->second);
+  }
+
+  return output.size() - startSize;
+}
+
+unsigned int TerminateProcessTree(unsigned long rootPid, unsigned long a_timeout, scProcessTreeStats *stats)
+{
+  unsigned long long startTime = getTimeMs();
+  std::vector<unsigned long> pids;
+  unsigned int res = 0;
+  bool useCgroup = false;
+
+  if (GetProcessTree(rootPid, pids) > 0) {
+    scString groupDir;
+    useCgroup = findTreeCgroup(rootPid, pids, groupDir);
+
+    // frozen tree cannot fork while it is being signalled
+    if (!useCgroup || !freezeCgroup(groupDir))
+      stopTree(rootPid, pids);
+
+    if (a_timeout > 0) {
+      for(std::vector<unsigned long>::const_iterator it = pids.begin(), epos = pids.end(); it != epos; ++it)
+        kill(static_cast<pid_t>(*it), SIGTERM);
+
+      // let processes handle SIGTERM
+      if (useCgroup)
+        writeTextFile(groupDir + "/cgroup.freeze", "0");
+      for(std::vector<unsigned long>::const_iterator it = pids.begin(), epos = pids.end(); it != epos; ++it)
+        kill(static_cast<pid_t>(*it), SIGCONT);
+    }
+
+    res = TerminateProcesses(pids, std::vector<unsigned long>(1, a_timeout), SC_NULL);
+
+    if (useCgroup) {
+      // also kills processes forked after freeze was lifted and ones which
+      // survived the timeout, all of them are still listed in the group
+      std::set<unsigned long> groupPids;
+      freezeCgroup(groupDir);
+      readCgroupProcs(groupDir, groupPids);
+
+      useCgroup = writeTextFile(groupDir + "/cgroup.kill", "1");
+      writeTextFile(groupDir + "/cgroup.freeze", "0");
+
+      if (useCgroup) {
+        // tree members are already counted by TerminateProcesses
+        std::set<unsigned long> treePids(pids.begin(), pids.end());
+        for(std::set<unsigned long>::const_iterator it = groupPids.begin(), epos = groupPids.end(); it != epos; ++it)
+          if (treePids.find(*it) == treePids.end()) {
+            pids.push_back(*it);
+            res++;
+          }
+      }
+    }
+
+    waitForExit(pids, LINUX_PROC_TREE_REAP_TIMEOUT_MS);
+  }
+
+  if (stats != SC_NULL) {
+    stats->processCount = pids.size();
+    stats->terminatedCount = res;
+    stats->durationMs = static_cast<unsigned long>(getTimeMs() - startTime);
+    stats->cgroupUsed = useCgroup;
+  }
+
+  return res;
+}
+
+}; // namespace Linux_proc
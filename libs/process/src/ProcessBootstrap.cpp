@@ -0,0 +1,225 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        ProcessBootstrap.cpp
+// Project:     scLib
+// Purpose:     Shared memory block with data prepared for child processes
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#include "sc/proc/ProcessBootstrap.h"
+
+#include <cstdlib>
+
+#include <boost/cstdint.hpp>
+#include <boost/interprocess/exceptions.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/detail/atomic.hpp>
+#include <boost/interprocess/detail/os_thread_functions.hpp>
+
+#ifdef WIN32
+#include <windows.h>
+#endif
+
+#include "sc/utils.h"
+
+using namespace boost::interprocess::ipcdetail;
+
+// ----------------------------------------------------------------------------
+// shared layout
+// ----------------------------------------------------------------------------
+const boost::uint32_t SC_PROC_BOOTSTRAP_MAGIC = 0x5CB0075A;
+const uint SC_PROC_BOOTSTRAP_WAIT_STEP_MS = 10;
+/// creations lost to other parents before constructor gives up
+const uint SC_PROC_BOOTSTRAP_MAX_ATTEMPTS = 3;
+
+// data starts at cache line boundary
+struct scProcBootstrapHeader {
+  boost::uint32_t magic;      // set when data is complete
+  boost::uint32_t version;
+  boost::uint64_t blockSize;
+  boost::uint64_t dataSize;
+  char pad[64 - 2 * sizeof(boost::uint32_t) - 2 * sizeof(boost::uint64_t)];
+};
+
+inline void proc_bootstrap_fence()
+{
+#ifdef WIN32
+  MemoryBarrier();
+#else
+  __sync_synchronize();
+#endif
+}
+
+// ----------------------------------------------------------------------------
+// scProcessBootstrap
+// ----------------------------------------------------------------------------
+scProcessBootstrap::scProcessBootstrap(const scString &name, uint version, size_t size, scShmWinWriterIntf *writer, uint a_useFlags):
+  m_name(name), m_data(SC_NULL), m_dataSize(0), m_version(version), m_reused(false)
+{
+  for(uint attempt = 1; ; attempt++) {
+    if (createBlock(version, size, writer, a_useFlags))
+      return;
+
+    ExistingState state = openExisting(version, size);
+    if (state == esReused) {
+      m_reused = true;
+      return;
+    }
+
+    if (attempt >= SC_PROC_BOOTSTRAP_MAX_ATTEMPTS)
+      throw scError("Cannot create bootstrap block: ["+name+"]");
+
+    if (state == esStale) {
+#ifdef WIN32
+      throw scError("Bootstrap block with other version in use: ["+name+"]");
+#else
+      boost::interprocess::shared_memory_object::remove(name.c_str());
+#endif
+    }
+  }
+}
+
+bool scProcessBootstrap::createBlock(uint version, size_t size, scShmWinWriterIntf *writer, uint a_useFlags)
+{
+  try {
+    // never replaces block which other parent fills or serves
+    m_memory.reset(new scSharedMemory(m_name, scsmReadWrite, (a_useFlags & scsmOwner) | scsmCreate | scsmExclusive,
+      sizeof(scProcBootstrapHeader) + size));
+  }
+  catch(boost::interprocess::interprocess_exception &e) {
+    if (e.get_error_code() == boost::interprocess::already_exists_error)
+      return false;
+    throw;
+  }
+
+  scProcBootstrapHeader *header = static_cast<scProcBootstrapHeader *>(m_memory->getAddress());
+  atomic_write32(&header->magic, 0);
+  header->version = version;
+  header->blockSize = size;
+
+  char *data = reinterpret_cast<char *>(header + 1);
+  size_t dataSize = (size > 0)?writer->write(data, size):0;
+  header->dataSize = dataSize;
+
+  // children which see magic see complete data
+  proc_bootstrap_fence();
+  atomic_write32(&header->magic, SC_PROC_BOOTSTRAP_MAGIC);
+
+  m_data = data;
+  m_dataSize = dataSize;
+  return true;
+}
+
+scProcessBootstrap::scProcessBootstrap(const scString &name):
+  m_name(name), m_data(SC_NULL), m_dataSize(0), m_version(0), m_reused(true)
+{
+  m_memory.reset(new scSharedMemory(name, scsmReadOnly, 0, 0));
+  checkHeader();
+}
+
+scProcessBootstrap::~scProcessBootstrap()
+{
+}
+
+scProcessBootstrap::ExistingState scProcessBootstrap::openExisting(uint version, size_t size)
+{
+  for(uint waited = 0; ; waited += SC_PROC_BOOTSTRAP_WAIT_STEP_MS) {
+    try {
+      m_memory.reset(new scSharedMemory(m_name, scsmReadOnly, 0, 0));
+    }
+    catch(boost::interprocess::interprocess_exception &e) {
+      m_memory.reset();
+      if (e.get_error_code() == boost::interprocess::not_found_error)
+        // removed by its owner meanwhile
+        return esGone;
+      // created, but not sized yet
+    }
+
+    if ((m_memory.get() != SC_NULL) && (m_memory->getMappedSize() >= sizeof(scProcBootstrapHeader))) {
+      const scProcBootstrapHeader *header = static_cast<const scProcBootstrapHeader *>(m_memory->getAddress());
+      if (atomic_read32(const_cast<boost::uint32_t *>(&header->magic)) == SC_PROC_BOOTSTRAP_MAGIC) {
+        proc_bootstrap_fence();
+        if ((header->version != version) || (header->blockSize != size) ||
+            (m_memory->getMappedSize() < sizeof(scProcBootstrapHeader) + size))
+        {
+          m_memory.reset();
+          return esStale;
+        }
+
+        m_data = reinterpret_cast<const char *>(header + 1);
+        m_dataSize = static_cast<size_t>(header->dataSize);
+        return esReused;
+      }
+    }
+
+    if (waited >= SC_PROC_BOOTSTRAP_READY_TIMEOUT_MS) {
+      // creator died before block was filled
+      m_memory.reset();
+      return esStale;
+    }
+    thread_sleep(SC_PROC_BOOTSTRAP_WAIT_STEP_MS);
+  }
+}
+
+void scProcessBootstrap::checkHeader()
+{
+  const scProcBootstrapHeader *header = static_cast<const scProcBootstrapHeader *>(m_memory->getAddress());
+  if ((header == SC_NULL) || (atomic_read32(const_cast<boost::uint32_t *>(&header->magic)) != SC_PROC_BOOTSTRAP_MAGIC))
+    throw scError("Bootstrap block not ready: ["+m_name+"]");
+  proc_bootstrap_fence();
+
+  m_version = header->version;
+  m_data = reinterpret_cast<const char *>(header + 1);
+  m_dataSize = static_cast<size_t>(header->dataSize);
+}
+
+scString scProcessBootstrap::getInheritedName()
+{
+  const char *value = std::getenv(SC_PROC_BOOTSTRAP_ENV);
+  return (value != SC_NULL)?scString(value):scString("");
+}
+
+scProcessBootstrap *scProcessBootstrap::openInherited()
+{
+  scString name = getInheritedName();
+  if (name.empty())
+    return SC_NULL;
+
+  try {
+    return new scProcessBootstrap(name);
+  }
+  catch(boost::interprocess::interprocess_exception &) {
+    // parent is gone together with block
+    return SC_NULL;
+  }
+  catch(scError &) {
+    // block not filled
+    return SC_NULL;
+  }
+}
+
+const void *scProcessBootstrap::getData() const
+{
+  return m_data;
+}
+
+size_t scProcessBootstrap::getDataSize() const
+{
+  return m_dataSize;
+}
+
+uint scProcessBootstrap::getVersion() const
+{
+  return m_version;
+}
+
+const scString &scProcessBootstrap::getName() const
+{
+  return m_name;
+}
+
+bool scProcessBootstrap::isReused() const
+{
+  return m_reused;
+}
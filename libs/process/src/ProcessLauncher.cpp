@@ -0,0 +1,650 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        ProcessLauncher.cpp
+// Project:     scLib
+// Purpose:     Launching of many processes with limited concurrency
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+#ifdef WIN32
+#include <windows.h>
+#include "sc/proc/W32Process.h"
+#else
+#include <spawn.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/epoll.h>
+#endif
+
+#include "sc/proc/ProcessLauncher.h"
+#include "sc/proc/ProcessBootstrap.h"
+
+#ifndef WIN32
+#include "sc/proc/LinuxProcess.h"
+#endif
+
+#ifndef WIN32
+extern char **environ;
+#endif
+
+// ----------------------------------------------------------------------------
+// Private declarations
+// ----------------------------------------------------------------------------
+const uint SC_PROC_LAUNCHER_WAIT_STEP_MS = 10;
+const uint SC_PROC_LAUNCHER_EVENT_BATCH = 64;
+
+#ifndef WIN32
+#define UNIX_PROC_PRIORITY_BACKGROUD 5
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+#endif
+
+// ----------------------------------------------------------------------------
+// Private functions
+// ----------------------------------------------------------------------------
+static unsigned long long getTimeMs()
+{
+#ifdef WIN32
+  return GetTickCount();
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<unsigned long long>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+#endif
+}
+
+#ifndef WIN32
+static void sleepMs(uint value)
+{
+  struct timespec ts;
+  ts.tv_sec = value / 1000;
+  ts.tv_nsec = (value % 1000) * 1000000L;
+  nanosleep(&ts, SC_NULL);
+}
+
+/// Starts process with fork, used when settings have to be applied before exec
+static pid_t forkProcess(const scSpawnRequest &request, char **argv, char **envp)
+{
+  // receives errno of failed exec, closed by successful exec
+  int errPipe[2];
+  if (pipe2(errPipe, O_CLOEXEC) != 0)
+    return 0;
+
+  int nullFd = request.minimized?open("/dev/null", O_RDWR | O_CLOEXEC):-1;
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    // no allocations below, parent can be multithreaded
+    sigset_t sigs;
+    sigemptyset(&sigs);
+    sigprocmask(SIG_SETMASK, &sigs, SC_NULL);
+    signal(SIGPIPE, SIG_DFL);
+    signal(SIGCHLD, SIG_DFL);
+    signal(SIGHUP, SIG_DFL);
+
+    if (nullFd >= 0) {
+      setsid();
+      dup2(nullFd, STDIN_FILENO);
+      dup2(nullFd, STDOUT_FILENO);
+      dup2(nullFd, STDERR_FILENO);
+    }
+
+    if (request.outputFd >= 0)
+      dup2(request.outputFd, STDOUT_FILENO);
+
+    if (request.lowPriority) {
+      struct sched_param param;
+      memset(&param, 0, sizeof(param));
+      sched_setscheduler(0, SCHED_BATCH, &param);
+      setpriority(PRIO_PROCESS, 0, UNIX_PROC_PRIORITY_BACKGROUD);
+    }
+
+    // explicit settings override lowPriority
+    if (Linux_proc::SetSchedulingBeforeExec(request.scheduling))
+      execvpe(request.command.c_str(), argv, envp);
+
+    int err = errno;
+    ssize_t written = write(errPipe[1], &err, sizeof(err));
+    (void)written;
+    _exit(127);
+  }
+
+  close(errPipe[1]);
+  if (nullFd >= 0)
+    close(nullFd);
+
+  if (pid < 0) {
+    close(errPipe[0]);
+    return 0;
+  }
+
+  int err;
+  ssize_t len;
+  do {
+    len = read(errPipe[0], &err, sizeof(err));
+  } while((len < 0) && (errno == EINTR));
+  close(errPipe[0]);
+
+  if (len == sizeof(err)) {
+    waitpid(pid, SC_NULL, 0);
+    return 0;
+  }
+
+  return pid;
+}
+
+static pid_t spawnProcess(const scSpawnRequest &request)
+{
+  std::vector<scString> args;
+  args.push_back(request.command);
+  scProcessLauncher::splitParams(request.params, args);
+
+  std::vector<char *> argv;
+  for(std::vector<scString>::iterator it = args.begin(), epos = args.end(); it != epos; ++it)
+    argv.push_back(const_cast<char *>(it->c_str()));
+  argv.push_back(SC_NULL);
+
+  scString envEntry;
+  std::vector<char *> envp;
+  char **envPtr = environ;
+
+  if (!request.bootstrapName.empty()) {
+    envEntry = scString(SC_PROC_BOOTSTRAP_ENV) + "=" + request.bootstrapName;
+    size_t nameLen = strlen(SC_PROC_BOOTSTRAP_ENV) + 1;
+    for(char **item = environ; (item != SC_NULL) && (*item != SC_NULL); ++item)
+      if (strncmp(*item, envEntry.c_str(), nameLen) != 0)
+        envp.push_back(*item);
+    envp.push_back(const_cast<char *>(envEntry.c_str()));
+    envp.push_back(SC_NULL);
+    envPtr = &envp[0];
+  }
+
+  if (!request.scheduling.isDefault())
+    return forkProcess(request, &argv[0], envPtr);
+
+  posix_spawnattr_t attr;
+  posix_spawnattr_init(&attr);
+
+  // handlers are reset by exec, ignored signals and mask have to be reset here
+  short flags = POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF;
+  sigset_t sigs;
+  sigemptyset(&sigs);
+  posix_spawnattr_setsigmask(&attr, &sigs);
+  sigaddset(&sigs, SIGPIPE);
+  sigaddset(&sigs, SIGCHLD);
+  sigaddset(&sigs, SIGHUP);
+  posix_spawnattr_setsigdefault(&attr, &sigs);
+
+  if (request.lowPriority) {
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    flags |= POSIX_SPAWN_SETSCHEDULER;
+    posix_spawnattr_setschedpolicy(&attr, SCHED_BATCH);
+    posix_spawnattr_setschedparam(&attr, &param);
+  }
+
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+
+  if (request.minimized) {
+    // no window on Linux - detach from terminal and discard standard streams
+#ifdef POSIX_SPAWN_SETSID
+    flags |= POSIX_SPAWN_SETSID;
+#endif
+    posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+  }
+
+  if (request.outputFd >= 0)
+    posix_spawn_file_actions_adddup2(&actions, request.outputFd, STDOUT_FILENO);
+
+  posix_spawnattr_setflags(&attr, flags);
+
+  pid_t pid = 0;
+  int err = posix_spawnp(&pid, request.command.c_str(), &actions, &attr, &argv[0], envPtr);
+
+  posix_spawn_file_actions_destroy(&actions);
+  posix_spawnattr_destroy(&attr);
+
+  if (err != 0)
+    return 0;
+
+  if (request.lowPriority)
+    setpriority(PRIO_PROCESS, pid, UNIX_PROC_PRIORITY_BACKGROUD);
+
+  return pid;
+}
+
+/// Reaps child, returns SC_PROC_EXIT_CODE_UNKNOWN if process is not a child
+/// \param[out] exited true if process finished
+static int reapProcess(pid_t pid, bool &exited)
+{
+  int status = 0;
+  pid_t res;
+
+  do {
+    res = waitpid(pid, &status, WNOHANG);
+  } while((res < 0) && (errno == EINTR));
+
+  if (res == pid) {
+    exited = true;
+    if (WIFEXITED(status))
+      return WEXITSTATUS(status);
+    if (WIFSIGNALED(status))
+      return 128 + WTERMSIG(status);
+    return SC_PROC_EXIT_CODE_UNKNOWN;
+  }
+
+  if (res == 0)
+    exited = false;
+  else
+    // not a child (e.g. started by external spawner)
+    exited = (kill(pid, 0) != 0) && (errno != EPERM);
+
+  return SC_PROC_EXIT_CODE_UNKNOWN;
+}
+#endif
+
+// ----------------------------------------------------------------------------
+// scProcessLauncher
+// ----------------------------------------------------------------------------
+scProcessLauncher::scProcessLauncher(uint maxRunning):
+  m_maxRunning(maxRunning),
+  m_observer(SC_NULL),
+  m_spawner(SC_NULL),
+  m_nextRequestNo(1),
+  m_startedCount(0),
+  m_failedCount(0),
+  m_epollFd(-1)
+{
+#ifndef WIN32
+  m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+#endif
+}
+
+scProcessLauncher::~scProcessLauncher()
+{
+  for(RunningMap::iterator it = m_running.begin(), epos = m_running.end(); it != epos; ++it) {
+#ifdef WIN32
+    CloseHandle(it->second.handle);
+#else
+    if (it->second.fd >= 0)
+      close(it->second.fd);
+    // finished but not yet polled children would stay as zombies
+    bool exited;
+    reapProcess(static_cast<pid_t>(it->second.pid), exited);
+#endif
+  }
+
+#ifndef WIN32
+  for(RequestQueue::iterator it = m_queue.begin(), epos = m_queue.end(); it != epos; ++it)
+    if (it->request.outputFd >= 0)
+      close(it->request.outputFd);
+
+  if (m_epollFd >= 0)
+    close(m_epollFd);
+#endif
+}
+
+void scProcessLauncher::setObserver(scProcessExitObserverIntf *observer)
+{
+  m_observer = observer;
+}
+
+void scProcessLauncher::setSpawner(scProcessSpawnerIntf *spawner)
+{
+  m_spawner = spawner;
+}
+
+uint scProcessLauncher::launch(const scSpawnRequest &request)
+{
+  QueuedRequest queued;
+  queued.requestNo = m_nextRequestNo++;
+  queued.request = request;
+  m_queue.push_back(queued);
+
+  uint res = queued.requestNo;
+  startQueued();
+  return res;
+}
+
+uint scProcessLauncher::launch(const std::vector<scSpawnRequest> &requests)
+{
+  uint res = m_nextRequestNo;
+
+  QueuedRequest queued;
+  for(std::vector<scSpawnRequest>::const_iterator it = requests.begin(), epos = requests.end(); it != epos; ++it) {
+    queued.requestNo = m_nextRequestNo++;
+    queued.request = *it;
+    m_queue.push_back(queued);
+  }
+
+  startQueued();
+  return res;
+}
+
+uint scProcessLauncher::poll(uint timeoutMs)
+{
+  startQueued();
+  if (m_running.empty())
+    return 0;
+
+  uint res = waitForExits(timeoutMs);
+  startQueued();
+  return res;
+}
+
+bool scProcessLauncher::waitForAll(uint timeoutMs)
+{
+  unsigned long long deadline = getTimeMs() + timeoutMs;
+
+  startQueued();
+  while(!m_running.empty() || !m_queue.empty()) {
+    uint waitMs = 1000;
+    if (timeoutMs > 0) {
+      unsigned long long now = getTimeMs();
+      if (now >= deadline)
+        return false;
+      waitMs = static_cast<uint>(SC_MIN(deadline - now, static_cast<unsigned long long>(waitMs)));
+    }
+    poll(waitMs);
+  }
+
+  return true;
+}
+
+uint scProcessLauncher::getRunningCount() const
+{
+  return m_running.size();
+}
+
+uint scProcessLauncher::getQueuedCount() const
+{
+  return m_queue.size();
+}
+
+uint scProcessLauncher::getStartedCount() const
+{
+  return m_startedCount;
+}
+
+uint scProcessLauncher::getFailedCount() const
+{
+  return m_failedCount;
+}
+
+scProcessId scProcessLauncher::spawn(const scSpawnRequest &request)
+{
+#ifdef WIN32
+  scString envEntry;
+  if (!request.bootstrapName.empty())
+    envEntry = scString(SC_PROC_BOOTSTRAP_ENV) + "=" + request.bootstrapName;
+
+  return W32_proc::StartApp(request.command.c_str(), request.params.c_str(), request.minimized, request.lowPriority,
+    envEntry.empty()?NULL:envEntry.c_str(), NULL, &request.scheduling);
+#else
+  return spawnProcess(request);
+#endif
+}
+
+void scProcessLauncher::splitParams(const scString &params, std::vector<scString> &output)
+{
+  scString word;
+  bool inWord = false;
+  char quote = '\0';
+
+  for(scString::const_iterator it = params.begin(), epos = params.end(); it != epos; ++it) {
+    char c = *it;
+    if (quote != '\0') {
+      if (c == quote)
+        quote = '\0';
+      else
+        word += c;
+    } else if ((c == '"') || (c == '\'')) {
+      quote = c;
+      inWord = true;
+    } else if ((c == ' ') || (c == '\t') || (c == '\n') || (c == '\r')) {
+      if (inWord) {
+        output.push_back(word);
+        word.clear();
+        inWord = false;
+      }
+    } else {
+      word += c;
+      inWord = true;
+    }
+  }
+
+  if (inWord)
+    output.push_back(word);
+}
+
+void scProcessLauncher::startQueued()
+{
+  while(!m_queue.empty() && ((m_maxRunning == 0) || (m_running.size() < m_maxRunning))) {
+    QueuedRequest queued = m_queue.front();
+    m_queue.pop_front();
+    startProcess(queued);
+  }
+}
+
+bool scProcessLauncher::startProcess(const QueuedRequest &queued)
+{
+  RunningProcess process;
+  process.requestNo = queued.requestNo;
+
+#ifdef WIN32
+  process.handle = NULL;
+  if (m_spawner != SC_NULL) {
+    process.pid = m_spawner->spawn(queued.request);
+    if (process.pid != 0)
+      process.handle = OpenProcess(SYNCHRONIZE | PROCESS_QUERY_INFORMATION, FALSE, process.pid);
+  } else {
+    scString envEntry;
+    if (!queued.request.bootstrapName.empty())
+      envEntry = scString(SC_PROC_BOOTSTRAP_ENV) + "=" + queued.request.bootstrapName;
+
+    HANDLE handle = NULL;
+    process.pid = W32_proc::StartApp(queued.request.command.c_str(), queued.request.params.c_str(),
+      queued.request.minimized, queued.request.lowPriority, envEntry.empty()?NULL:envEntry.c_str(), &handle,
+      &queued.request.scheduling);
+    process.handle = handle;
+  }
+
+  if ((process.pid != 0) && (process.handle == NULL))
+    // already finished or not accessible, cannot be tracked
+    process.pid = 0;
+#else
+  process.fd = -1;
+  if (m_spawner != SC_NULL)
+    process.pid = m_spawner->spawnWithPidFd(queued.request, process.fd);
+  else
+    process.pid = spawnProcess(queued.request);
+
+  if (queued.request.outputFd >= 0)
+    // child has its own copy, end of output is seen when child closes it
+    close(queued.request.outputFd);
+
+  if ((process.fd >= 0) && ((process.pid == 0) || (m_epollFd < 0))) {
+    close(process.fd);
+    process.fd = -1;
+  }
+
+  if ((process.pid != 0) && (m_epollFd >= 0)) {
+    // pidfd becomes readable when process exits
+    if (process.fd < 0)
+      process.fd = static_cast<int>(syscall(SYS_pidfd_open, static_cast<pid_t>(process.pid), 0));
+    if (process.fd >= 0) {
+      struct epoll_event event;
+      memset(&event, 0, sizeof(event));
+      event.events = EPOLLIN;
+      event.data.u32 = process.requestNo;
+      if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, process.fd, &event) != 0) {
+        close(process.fd);
+        process.fd = -1;
+      }
+    }
+  }
+#endif
+
+  if (process.pid == 0) {
+    m_failedCount++;
+    if (m_observer != SC_NULL)
+      m_observer->processExited(queued.requestNo, 0, SC_PROC_EXIT_CODE_UNKNOWN);
+    return false;
+  }
+
+  m_startedCount++;
+  m_running.insert(std::make_pair(process.requestNo, process));
+  return true;
+}
+
+void scProcessLauncher::finishProcess(RunningMap::iterator it, int exitCode)
+{
+  RunningProcess process = it->second;
+  m_running.erase(it);
+
+#ifdef WIN32
+  CloseHandle(process.handle);
+#else
+  // closing pidfd removes it from epoll set
+  if (process.fd >= 0)
+    close(process.fd);
+#endif
+
+  if (m_observer != SC_NULL)
+    m_observer->processExited(process.requestNo, process.pid, exitCode);
+}
+
+#ifdef WIN32
+uint scProcessLauncher::waitForExits(uint timeoutMs)
+{
+  std::vector<HANDLE> handles;
+  std::vector<uint> requests;
+  std::vector<uint> finished;
+
+  handles.reserve(m_running.size());
+  requests.reserve(m_running.size());
+  for(RunningMap::iterator it = m_running.begin(), epos = m_running.end(); it != epos; ++it) {
+    handles.push_back(it->second.handle);
+    requests.push_back(it->first);
+  }
+
+  // one wait call handles up to MAXIMUM_WAIT_OBJECTS processes, so the full
+  // timeout is used only when all of them fit in one group
+  bool oneGroup = (handles.size() <= MAXIMUM_WAIT_OBJECTS);
+  for(size_t groupStart = 0; groupStart < handles.size(); groupStart += MAXIMUM_WAIT_OBJECTS) {
+    DWORD groupSize = static_cast<DWORD>(SC_MIN(handles.size() - groupStart, static_cast<size_t>(MAXIMUM_WAIT_OBJECTS)));
+    DWORD waitMs = (oneGroup && finished.empty())?timeoutMs:0;
+
+    for(;;) {
+      DWORD res = WaitForMultipleObjects(groupSize, &handles[groupStart], FALSE, waitMs);
+      if ((res < WAIT_OBJECT_0) || (res >= WAIT_OBJECT_0 + groupSize))
+        break;
+      size_t idx = groupStart + (res - WAIT_OBJECT_0);
+      finished.push_back(requests[idx]);
+      // exclude signaled handle from next wait of this group
+      groupSize--;
+      std::swap(handles[idx], handles[groupStart + groupSize]);
+      std::swap(requests[idx], requests[groupStart + groupSize]);
+      if (groupSize == 0)
+        break;
+      waitMs = 0;
+    }
+  }
+
+  if (finished.empty() && !oneGroup && (timeoutMs > 0))
+    Sleep(SC_MIN(timeoutMs, SC_PROC_LAUNCHER_WAIT_STEP_MS));
+
+  for(std::vector<uint>::iterator it = finished.begin(), epos = finished.end(); it != epos; ++it) {
+    RunningMap::iterator runIt = m_running.find(*it);
+    if (runIt == m_running.end())
+      continue;
+
+    DWORD exitCode = 0;
+    int code = SC_PROC_EXIT_CODE_UNKNOWN;
+    if (GetExitCodeProcess(runIt->second.handle, &exitCode))
+      code = static_cast<int>(exitCode);
+    finishProcess(runIt, code);
+  }
+
+  return finished.size();
+}
+#else
+uint scProcessLauncher::waitForExits(uint timeoutMs)
+{
+  uint res = 0;
+  bool anyPolled = false;
+  bool anyFd = false;
+
+  for(RunningMap::iterator it = m_running.begin(), epos = m_running.end(); it != epos; ++it) {
+    if (it->second.fd >= 0)
+      anyFd = true;
+    else
+      anyPolled = true;
+  }
+
+  uint waitMs = timeoutMs;
+  if (anyPolled) {
+    // process can finish before its pidfd is opened, check without waiting first
+    res = checkPolledExits();
+    waitMs = (res > 0)?0:SC_MIN(timeoutMs, SC_PROC_LAUNCHER_WAIT_STEP_MS);
+  }
+
+  if (anyFd) {
+    struct epoll_event events[SC_PROC_LAUNCHER_EVENT_BATCH];
+    int cnt = epoll_wait(m_epollFd, events, SC_PROC_LAUNCHER_EVENT_BATCH, static_cast<int>(waitMs));
+    for(int i = 0; i < cnt; i++) {
+      RunningMap::iterator it = m_running.find(events[i].data.u32);
+      if (it == m_running.end())
+        continue;
+
+      bool exited;
+      int exitCode = reapProcess(static_cast<pid_t>(it->second.pid), exited);
+      finishProcess(it, exitCode);
+      res++;
+    }
+  } else if (waitMs > 0) {
+    sleepMs(waitMs);
+  }
+
+  if (anyPolled && (waitMs > 0))
+    res += checkPolledExits();
+
+  return res;
+}
+
+uint scProcessLauncher::checkPolledExits()
+{
+  uint res = 0;
+  RunningMap::iterator it = m_running.begin();
+  while(it != m_running.end()) {
+    RunningMap::iterator curr = it++;
+    if (curr->second.fd >= 0)
+      continue;
+
+    bool exited;
+    int exitCode = reapProcess(static_cast<pid_t>(curr->second.pid), exited);
+    if (exited) {
+      finishProcess(curr, exitCode);
+      res++;
+    }
+  }
+  return res;
+}
+#endif
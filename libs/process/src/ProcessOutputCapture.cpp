@@ -0,0 +1,206 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        ProcessOutputCapture.cpp
+// Project:     scLib
+// Purpose:     Captures child process output into shared memory block
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+
+#include "sc/proc/ProcessOutputCapture.h"
+#include "sc/utils.h"
+
+// ----------------------------------------------------------------------------
+// Private declarations
+// ----------------------------------------------------------------------------
+/// larger pipe means fewer wakeups of reader, limited by fs.pipe-max-size
+const int SC_PROC_CAPTURE_PIPE_SIZE = 1024 * 1024;
+
+#ifndef F_SETPIPE_SZ
+#define F_SETPIPE_SZ 1031
+#endif
+
+// ----------------------------------------------------------------------------
+// Private functions
+// ----------------------------------------------------------------------------
+static scString capture_error(const scString &action)
+{
+  return action + " failed: " + scString(strerror(errno));
+}
+
+// ----------------------------------------------------------------------------
+// scProcessOutputCapture
+// ----------------------------------------------------------------------------
+scProcessOutputCapture::scProcessOutputCapture(const scString &name, size_t capacity, scOutputCaptureMode mode):
+  m_mode(mode),
+  m_memory(new scAnonSharedMemory(name, capacity)),
+  m_capacity(capacity),
+  m_size(0),
+  m_truncated(false),
+  m_readFd(-1),
+  m_childFd(-1),
+  m_nullFd(-1)
+{
+  if (m_mode == ocmDirect) {
+    // writes beyond capacity fail in child instead of growing block
+    m_memory->seal(scsmSealGrow | scsmSealShrink);
+    // duplicate shares file offset, so size written by child is visible here
+    m_childFd = fcntl(m_memory->getHandle(), F_DUPFD_CLOEXEC, 0);
+    if (m_childFd < 0)
+      throw scError(capture_error("fcntl"));
+    return;
+  }
+
+  int fds[2];
+  if (pipe2(fds, O_CLOEXEC) != 0)
+    throw scError(capture_error("pipe2"));
+
+  m_readFd = fds[0];
+  m_childFd = fds[1];
+  fcntl(m_readFd, F_SETFL, fcntl(m_readFd, F_GETFL) | O_NONBLOCK);
+  fcntl(m_readFd, F_SETPIPE_SZ, SC_PROC_CAPTURE_PIPE_SIZE);
+}
+
+scProcessOutputCapture::~scProcessOutputCapture()
+{
+  closeReadFd();
+  if (m_childFd >= 0)
+    close(m_childFd);
+  if (m_nullFd >= 0)
+    close(m_nullFd);
+}
+
+scOutputCaptureMode scProcessOutputCapture::getMode() const
+{
+  return m_mode;
+}
+
+int scProcessOutputCapture::releaseChildFd()
+{
+  int res = m_childFd;
+  m_childFd = -1;
+  return res;
+}
+
+bool scProcessOutputCapture::poll(uint timeoutMs, scShmWinConsumerIntf *consumer)
+{
+  size_t lastSize = m_size;
+  bool res = true;
+
+  if (m_mode == ocmDirect) {
+    updateDirectSize();
+  } else if (m_readFd < 0) {
+    res = false;
+  } else {
+    struct pollfd pfd;
+    pfd.fd = m_readFd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    if (::poll(&pfd, 1, static_cast<int>(timeoutMs)) > 0) {
+      res = transfer();
+      if (!res)
+        closeReadFd();
+    }
+  }
+
+  if ((consumer != SC_NULL) && (m_size > lastSize))
+    consumer->process(getData() + lastSize, m_size - lastSize);
+
+  return res;
+}
+
+void scProcessOutputCapture::readAll(scShmWinConsumerIntf *consumer)
+{
+  if (m_mode == ocmDirect) {
+    poll(0, consumer);
+    return;
+  }
+
+  while(poll(static_cast<uint>(-1), consumer))
+    ;
+}
+
+const char *scProcessOutputCapture::getData()
+{
+  return static_cast<const char *>(m_memory->getAddress());
+}
+
+size_t scProcessOutputCapture::getSize() const
+{
+  return m_size;
+}
+
+size_t scProcessOutputCapture::getCapacity() const
+{
+  return m_capacity;
+}
+
+bool scProcessOutputCapture::isTruncated() const
+{
+  return m_truncated;
+}
+
+scAnonSharedMemory *scProcessOutputCapture::getMemory()
+{
+  return m_memory.get();
+}
+
+bool scProcessOutputCapture::transfer()
+{
+  int blockFd = m_memory->getHandle();
+
+  for(;;) {
+    ssize_t moved;
+    if (m_size < m_capacity) {
+      // pipe pages are copied to block pages by kernel, no user-space buffer
+      loff_t offset = static_cast<loff_t>(m_size);
+      moved = splice(m_readFd, SC_NULL, blockFd, &offset, m_capacity - m_size, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+      if (moved > 0)
+        m_size += static_cast<size_t>(moved);
+    } else {
+      // block is full, remaining output is discarded so child does not block
+      if (m_nullFd < 0)
+        m_nullFd = open("/dev/null", O_WRONLY | O_CLOEXEC);
+      if (m_nullFd < 0)
+        return false;
+      moved = splice(m_readFd, SC_NULL, m_nullFd, SC_NULL, SC_PROC_CAPTURE_PIPE_SIZE, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+      if (moved > 0)
+        m_truncated = true;
+    }
+
+    if (moved > 0)
+      continue;
+    if (moved == 0)
+      // all writers closed
+      return false;
+    if (errno == EINTR)
+      continue;
+    return (errno == EAGAIN);
+  }
+}
+
+void scProcessOutputCapture::updateDirectSize()
+{
+  off_t offset = lseek(m_memory->getHandle(), 0, SEEK_CUR);
+  if (offset < 0)
+    return;
+
+  m_size = SC_MIN(static_cast<size_t>(offset), m_capacity);
+  m_truncated = (m_size == m_capacity);
+}
+
+void scProcessOutputCapture::closeReadFd()
+{
+  if (m_readFd >= 0) {
+    close(m_readFd);
+    m_readFd = -1;
+  }
+}
@@ -0,0 +1,523 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        ProcessSampler.cpp
+// Project:     scLib
+// Purpose:     Periodic sampling of process resource usage
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <linux/netlink.h>
+#include <linux/genetlink.h>
+#include <linux/taskstats.h>
+
+#include "sc/proc/ProcessSampler.h"
+
+// ----------------------------------------------------------------------------
+// Private declarations
+// ----------------------------------------------------------------------------
+/// largest file read, /proc/<pid>/status is about 1.5 KB
+const size_t SC_PROC_SAMPLER_BUFFER_SIZE = 8 * 1024;
+/// max wait for taskstats replies of one batch
+const uint SC_PROC_SAMPLER_TASKSTATS_TIMEOUT_MS = 100;
+const size_t SC_PROC_SAMPLER_REQUEST_SIZE = 256;
+/// taskstats requests sent before reading replies
+const size_t SC_PROC_SAMPLER_TASKSTATS_WINDOW = 64;
+
+// ----------------------------------------------------------------------------
+// Private functions
+// ----------------------------------------------------------------------------
+static boost::uint64_t getTimeNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<boost::uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+static int openProcFile(scProcessId pid, const char *name)
+{
+  char fname[64];
+  snprintf(fname, sizeof(fname), "/proc/%lu/%s", pid, name);
+  return open(fname, O_RDONLY | O_CLOEXEC);
+}
+
+static const char *parseUInt(const char *cptr, boost::uint64_t &value)
+{
+  while((*cptr == ' ') || (*cptr == '\t'))
+    ++cptr;
+
+  boost::uint64_t res = 0;
+  for(; (*cptr >= '0') && (*cptr <= '9'); ++cptr)
+    res = res * 10 + (*cptr - '0');
+  value = res;
+  return cptr;
+}
+
+static const char *skipFields(const char *cptr, uint count)
+{
+  for(uint i = 0; (i < count) && (*cptr != '\0'); i++) {
+    while(*cptr == ' ')
+      ++cptr;
+    while((*cptr != ' ') && (*cptr != '\0'))
+      ++cptr;
+  }
+  return cptr;
+}
+
+/// Finds "key value" line, key has to include line start and separator
+static bool findValue(const char *buffer, const char *key, boost::uint64_t &value)
+{
+  const char *cptr = strstr(buffer, key);
+  if (cptr == SC_NULL)
+    return false;
+  parseUInt(cptr + strlen(key), value);
+  return true;
+}
+
+static void addAttr(struct nlmsghdr *msg, boost::uint16_t type, const void *data, size_t dataLen)
+{
+  struct nlattr *attr = reinterpret_cast<struct nlattr *>(reinterpret_cast<char *>(msg) + NLMSG_ALIGN(msg->nlmsg_len));
+  attr->nla_type = type;
+  attr->nla_len = static_cast<boost::uint16_t>(NLA_HDRLEN + dataLen);
+  memcpy(reinterpret_cast<char *>(attr) + NLA_HDRLEN, data, dataLen);
+  msg->nlmsg_len = NLMSG_ALIGN(msg->nlmsg_len) + NLA_ALIGN(attr->nla_len);
+}
+
+/// Builds generic netlink request in buffer
+static struct nlmsghdr *initRequest(char *buffer, boost::uint16_t family, boost::uint8_t cmd, boost::uint32_t seq)
+{
+  memset(buffer, 0, SC_PROC_SAMPLER_REQUEST_SIZE);
+  struct nlmsghdr *msg = reinterpret_cast<struct nlmsghdr *>(buffer);
+  msg->nlmsg_len = NLMSG_LENGTH(GENL_HDRLEN);
+  msg->nlmsg_type = family;
+  msg->nlmsg_flags = NLM_F_REQUEST;
+  msg->nlmsg_seq = seq;
+  msg->nlmsg_pid = 0;
+
+  struct genlmsghdr *genl = reinterpret_cast<struct genlmsghdr *>(NLMSG_DATA(msg));
+  genl->cmd = cmd;
+  genl->version = 1;
+  return msg;
+}
+
+static bool sendRequest(int sock, struct nlmsghdr *msg)
+{
+  struct sockaddr_nl addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.nl_family = AF_NETLINK;
+
+  ssize_t res;
+  do {
+    res = sendto(sock, msg, msg->nlmsg_len, 0, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr));
+  } while((res < 0) && (errno == EINTR));
+  return (res == static_cast<ssize_t>(msg->nlmsg_len));
+}
+
+/// Finds attribute in attribute stream
+static const struct nlattr *findAttr(const char *data, size_t len, boost::uint16_t type)
+{
+  size_t pos = 0;
+  while(pos + NLA_HDRLEN <= len) {
+    const struct nlattr *attr = reinterpret_cast<const struct nlattr *>(data + pos);
+    if ((attr->nla_len < NLA_HDRLEN) || (pos + attr->nla_len > len))
+      break;
+    if ((attr->nla_type & NLA_TYPE_MASK) == type)
+      return attr;
+    pos += NLA_ALIGN(attr->nla_len);
+  }
+  return SC_NULL;
+}
+
+// ----------------------------------------------------------------------------
+// scProcessSampler
+// ----------------------------------------------------------------------------
+scProcessSampler::scProcessSampler(uint capacity, uint fields):
+  m_fields(fields),
+  m_ring(SC_MAX(capacity, 1U)),
+  m_ringStart(0),
+  m_ringCount(0),
+  m_buffer(SC_PROC_SAMPLER_BUFFER_SIZE),
+  m_taskstatsSocket(-1),
+  m_taskstatsFamily(0),
+  m_taskstatsSeq(0)
+{
+  long value = sysconf(_SC_CLK_TCK);
+  m_ticksPerSecond = (value > 0)?value:100;
+  value = sysconf(_SC_PAGESIZE);
+  m_pageSize = (value > 0)?value:4096;
+}
+
+scProcessSampler::~scProcessSampler()
+{
+  for(EntryList::iterator it = m_entries.begin(), epos = m_entries.end(); it != epos; ++it)
+    closeEntry(*it);
+  closeTaskstats();
+}
+
+bool scProcessSampler::addProcess(scProcessId pid)
+{
+  for(EntryList::const_iterator it = m_entries.begin(), epos = m_entries.end(); it != epos; ++it)
+    if (it->pid == pid)
+      return true;
+
+  Entry entry;
+  memset(&entry, 0, sizeof(entry));
+  entry.pid = pid;
+  entry.statFd = ((m_fields & psfCpu) != 0)?openProcFile(pid, "stat"):-1;
+  entry.statmFd = ((m_fields & psfMemory) != 0)?openProcFile(pid, "statm"):-1;
+  entry.ioFd = ((m_fields & psfIo) != 0)?openProcFile(pid, "io"):-1;
+  entry.statusFd = ((m_fields & psfContextSwitches) != 0)?openProcFile(pid, "status"):-1;
+
+  if ((entry.statFd < 0) && (entry.statmFd < 0) && (entry.ioFd < 0) && (entry.statusFd < 0))
+    return false;
+
+  m_entries.push_back(entry);
+  return true;
+}
+
+void scProcessSampler::removeProcess(scProcessId pid)
+{
+  for(EntryList::iterator it = m_entries.begin(), epos = m_entries.end(); it != epos; ++it)
+    if (it->pid == pid) {
+      closeEntry(*it);
+      m_entries.erase(it);
+      return;
+    }
+}
+
+uint scProcessSampler::getProcessCount() const
+{
+  return m_entries.size();
+}
+
+bool scProcessSampler::useTaskstats(bool value)
+{
+  if (!value) {
+    closeTaskstats();
+    return true;
+  }
+  return openTaskstats();
+}
+
+bool scProcessSampler::isUsingTaskstats() const
+{
+  return (m_taskstatsSocket >= 0);
+}
+
+uint scProcessSampler::sample()
+{
+  boost::uint64_t now = getTimeNs();
+  for(EntryList::iterator it = m_entries.begin(), epos = m_entries.end(); it != epos; ++it) {
+    memset(&it->current, 0, sizeof(it->current));
+    it->current.time = now;
+    it->current.pid = static_cast<boost::uint32_t>(it->pid);
+  }
+
+  if ((m_taskstatsSocket >= 0) && ((m_fields & (psfCpu | psfContextSwitches)) != 0))
+    readTaskstats();
+
+  uint res = 0;
+  size_t idx = 0;
+  while(idx < m_entries.size()) {
+    Entry &entry = m_entries[idx];
+    if (!readEntry(entry)) {
+      // finished, replaced by last entry
+      closeEntry(entry);
+      entry = m_entries.back();
+      m_entries.pop_back();
+      continue;
+    }
+
+    entry.last = entry.current;
+    pushSample(entry.current);
+    ++res;
+    ++idx;
+  }
+
+  return res;
+}
+
+uint scProcessSampler::enumSamples(scProcessSampleEnumerator *enumProc, scProcessId pid) const
+{
+  uint res = 0;
+  for(uint i = 0; i < m_ringCount; i++) {
+    const scProcessSample &sample = m_ring[(m_ringStart + i) % m_ring.size()];
+    if ((pid != 0) && (sample.pid != pid))
+      continue;
+    (*enumProc)(sample);
+    ++res;
+  }
+  return res;
+}
+
+bool scProcessSampler::getLastSample(scProcessId pid, scProcessSample &output) const
+{
+  for(EntryList::const_iterator it = m_entries.begin(), epos = m_entries.end(); it != epos; ++it)
+    if ((it->pid == pid) && (it->last.time != 0)) {
+      output = it->last;
+      return true;
+    }
+  return false;
+}
+
+uint scProcessSampler::getSampleCount() const
+{
+  return m_ringCount;
+}
+
+void scProcessSampler::clearSamples()
+{
+  m_ringStart = 0;
+  m_ringCount = 0;
+}
+
+bool scProcessSampler::readEntry(Entry &entry)
+{
+  scProcessSample &sample = entry.current;
+  const char *buffer = &m_buffer[0];
+  boost::uint64_t value;
+
+  if ((entry.statFd >= 0) && ((sample.fields & psfCpu) == 0)) {
+    // read fails with ESRCH after process finished
+    if (!readFile(entry.statFd))
+      return false;
+
+    // command name can contain spaces and ')', fields start after last ')'
+    const char *cptr = strrchr(buffer, ')');
+    if (cptr != SC_NULL) {
+      // fields 3 (state) ... 13 (cmajflt), then 14 (utime), 15 (stime)
+      cptr = skipFields(cptr + 1, 11);
+      cptr = parseUInt(cptr, value);
+      sample.cpuUserUs = value * 1000000ULL / m_ticksPerSecond;
+      parseUInt(cptr, value);
+      sample.cpuSystemUs = value * 1000000ULL / m_ticksPerSecond;
+      sample.fields |= psfCpu;
+    }
+  }
+
+  if (entry.statmFd >= 0) {
+    if (!readFile(entry.statmFd))
+      return false;
+
+    // size resident shared ...
+    const char *cptr = parseUInt(buffer, value);
+    parseUInt(cptr, value);
+    sample.rssBytes = value * m_pageSize;
+    sample.fields |= psfMemory;
+  }
+
+  if (entry.ioFd >= 0) {
+    if (!readFile(entry.ioFd))
+      return false;
+
+    if (findValue(buffer, "\nread_bytes:", value)) {
+      sample.readBytes = value;
+      if (findValue(buffer, "\nwrite_bytes:", value)) {
+        sample.writeBytes = value;
+        sample.fields |= psfIo;
+      }
+    }
+  }
+
+  if ((entry.statusFd >= 0) && ((sample.fields & psfContextSwitches) == 0)) {
+    if (!readFile(entry.statusFd))
+      return false;
+
+    if (findValue(buffer, "\nvoluntary_ctxt_switches:", value)) {
+      sample.voluntarySwitches = static_cast<boost::uint32_t>(value);
+      if (findValue(buffer, "\nnonvoluntary_ctxt_switches:", value)) {
+        sample.involuntarySwitches = static_cast<boost::uint32_t>(value);
+        sample.fields |= psfContextSwitches;
+      }
+    }
+  }
+
+  return true;
+}
+
+void scProcessSampler::closeEntry(Entry &entry)
+{
+  if (entry.statFd >= 0)
+    close(entry.statFd);
+  if (entry.statmFd >= 0)
+    close(entry.statmFd);
+  if (entry.ioFd >= 0)
+    close(entry.ioFd);
+  if (entry.statusFd >= 0)
+    close(entry.statusFd);
+  entry.statFd = entry.statmFd = entry.ioFd = entry.statusFd = -1;
+}
+
+bool scProcessSampler::readFile(int fd)
+{
+  ssize_t len;
+  do {
+    len = pread(fd, &m_buffer[0], m_buffer.size() - 1, 0);
+  } while((len < 0) && (errno == EINTR));
+
+  if (len < 0)
+    return false;
+  m_buffer[len] = '\0';
+  return true;
+}
+
+void scProcessSampler::pushSample(const scProcessSample &sample)
+{
+  if (m_ringCount < m_ring.size()) {
+    m_ring[(m_ringStart + m_ringCount) % m_ring.size()] = sample;
+    ++m_ringCount;
+  } else {
+    // overwrite the oldest one
+    m_ring[m_ringStart] = sample;
+    m_ringStart = (m_ringStart + 1) % m_ring.size();
+  }
+}
+
+bool scProcessSampler::openTaskstats()
+{
+  if (m_taskstatsSocket >= 0)
+    return true;
+
+  int sock = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_GENERIC);
+  if (sock < 0)
+    return false;
+
+  struct timeval tv;
+  tv.tv_sec = 0;
+  tv.tv_usec = SC_PROC_SAMPLER_TASKSTATS_TIMEOUT_MS * 1000;
+  setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+  // resolve family id of taskstats
+  char request[SC_PROC_SAMPLER_REQUEST_SIZE];
+  struct nlmsghdr *msg = initRequest(request, GENL_ID_CTRL, CTRL_CMD_GETFAMILY, 0);
+  addAttr(msg, CTRL_ATTR_FAMILY_NAME, TASKSTATS_GENL_NAME, strlen(TASKSTATS_GENL_NAME) + 1);
+
+  boost::uint16_t family = 0;
+  if (sendRequest(sock, msg)) {
+    ssize_t len = recv(sock, &m_buffer[0], m_buffer.size(), 0);
+    const struct nlmsghdr *reply = reinterpret_cast<const struct nlmsghdr *>(&m_buffer[0]);
+    if ((len > 0) && NLMSG_OK(reply, static_cast<size_t>(len)) && (reply->nlmsg_type != NLMSG_ERROR)) {
+      const char *data = reinterpret_cast<const char *>(NLMSG_DATA(reply)) + GENL_HDRLEN;
+      const struct nlattr *attr = findAttr(data, reply->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN), CTRL_ATTR_FAMILY_ID);
+      if (attr != SC_NULL)
+        memcpy(&family, reinterpret_cast<const char *>(attr) + NLA_HDRLEN, sizeof(family));
+    }
+  }
+
+  if (family == 0) {
+    close(sock);
+    return false;
+  }
+
+  m_taskstatsSocket = sock;
+  m_taskstatsFamily = family;
+
+  // one test request, fails without CAP_NET_ADMIN
+  Entry probe;
+  memset(&probe, 0, sizeof(probe));
+  probe.pid = getpid();
+  m_entries.push_back(probe);
+  readTaskstats();
+  bool res = ((m_entries.back().current.fields & (psfCpu | psfContextSwitches)) != 0);
+  m_entries.pop_back();
+
+  if (!res)
+    closeTaskstats();
+  return res;
+}
+
+void scProcessSampler::closeTaskstats()
+{
+  if (m_taskstatsSocket >= 0) {
+    close(m_taskstatsSocket);
+    m_taskstatsSocket = -1;
+  }
+}
+
+void scProcessSampler::readTaskstats()
+{
+  // sequence numbers of this batch, replies to older batches are skipped
+  boost::uint32_t firstSeq = m_taskstatsSeq + 1;
+  m_taskstatsSeq += m_entries.size();
+
+  char request[SC_PROC_SAMPLER_REQUEST_SIZE];
+  size_t nextIdx = 0;
+  size_t pending = 0;
+  for(;;) {
+    // limited number of requests in flight, so replies fit in socket buffer
+    for(; (nextIdx < m_entries.size()) && (pending < SC_PROC_SAMPLER_TASKSTATS_WINDOW); nextIdx++) {
+      boost::uint32_t tgid = static_cast<boost::uint32_t>(m_entries[nextIdx].pid);
+      struct nlmsghdr *msg = initRequest(request, m_taskstatsFamily, TASKSTATS_CMD_GET, firstSeq + nextIdx);
+      addAttr(msg, TASKSTATS_CMD_ATTR_TGID, &tgid, sizeof(tgid));
+      if (sendRequest(m_taskstatsSocket, msg))
+        ++pending;
+    }
+
+    if (pending == 0)
+      break;
+
+    ssize_t len = recv(m_taskstatsSocket, &m_buffer[0], m_buffer.size(), 0);
+    if (len < 0) {
+      if (errno == EINTR)
+        continue;
+      if (errno == ENOBUFS) {
+        // replies lost, values are read from /proc
+        pending = 0;
+        continue;
+      }
+      // timeout
+      break;
+    }
+
+    for(const struct nlmsghdr *reply = reinterpret_cast<const struct nlmsghdr *>(&m_buffer[0]);
+        NLMSG_OK(reply, static_cast<size_t>(len)); reply = NLMSG_NEXT(reply, len))
+    {
+      if ((reply->nlmsg_seq < firstSeq) || (reply->nlmsg_seq >= firstSeq + m_entries.size()))
+        continue;
+      if (pending > 0)
+        --pending;
+      if (reply->nlmsg_type == NLMSG_ERROR)
+        continue;
+
+      const char *data = reinterpret_cast<const char *>(NLMSG_DATA(reply)) + GENL_HDRLEN;
+      const struct nlattr *aggr = findAttr(data, reply->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN), TASKSTATS_TYPE_AGGR_TGID);
+      if (aggr == SC_NULL)
+        continue;
+
+      const struct nlattr *statsAttr = findAttr(reinterpret_cast<const char *>(aggr) + NLA_HDRLEN,
+        aggr->nla_len - NLA_HDRLEN, TASKSTATS_TYPE_STATS);
+      if (statsAttr == SC_NULL)
+        continue;
+
+      // older kernels send shorter structure, attribute data is not 8-byte aligned
+      struct taskstats stats;
+      memset(&stats, 0, sizeof(stats));
+      memcpy(&stats, reinterpret_cast<const char *>(statsAttr) + NLA_HDRLEN,
+        SC_MIN(static_cast<size_t>(statsAttr->nla_len - NLA_HDRLEN), sizeof(stats)));
+
+      Entry &entry = m_entries[reply->nlmsg_seq - firstSeq];
+      if (entry.startTime == 0)
+        entry.startTime = stats.ac_btime;
+      else if (entry.startTime != stats.ac_btime)
+        // pid reused, values are read from descriptors of finished process
+        continue;
+
+      scProcessSample &sample = entry.current;
+      sample.cpuUserUs = stats.ac_utime;
+      sample.cpuSystemUs = stats.ac_stime;
+      sample.voluntarySwitches = static_cast<boost::uint32_t>(stats.nvcsw);
+      sample.involuntarySwitches = static_cast<boost::uint32_t>(stats.nivcsw);
+      sample.fields |= (m_fields & (psfCpu | psfContextSwitches));
+    }
+  }
+}
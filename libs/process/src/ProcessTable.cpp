@@ -0,0 +1,457 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        ProcessTable.cpp
+// Project:     scLib
+// Purpose:     Live table of system processes updated from kernel events
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#include "sc/proc/ProcessTable.h"
+
+#include <cstring>
+
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
+
+#include <boost/functional/hash.hpp>
+
+using namespace Linux_proc;
+
+const size_t SC_PROC_TABLE_RECV_BUFFER_SIZE = 4096;
+
+// compares /proc entries with table
+class scProcessTableScanner: public ProcessDirEnumerator {
+public:
+  scProcessTableScanner(scProcessTable &table, bool checkExec):
+    ProcessDirEnumerator(), m_table(table), m_checkExec(checkExec) {}
+
+  virtual void operator()(unsigned long pid, unsigned long long dirInode, int procFd)
+  {
+    scProcessTable::EntryMap::iterator it = m_table.m_entries.find(pid);
+    if (it != m_table.m_entries.end())
+    {
+      scProcessTable::Entry &entry = it->second;
+      if (entry.dirInode != dirInode) {
+        // new directory inode - pid was probably reused, start time decides
+        unsigned long ppid;
+        unsigned long long startTime;
+        if (ReadProcessStat(pid, ppid, startTime) && (startTime != entry.info.startTime)) {
+          m_table.removeEntry(pid);
+          m_table.addEntry(pid, dirInode, procFd);
+          return;
+        }
+        entry.dirInode = dirInode;
+      }
+
+      entry.scanNo = m_table.m_scanNo;
+      if (m_checkExec) {
+        // exec is not reported without events
+        ExecId exec;
+        bool valid = GetProcessExecIdAt(procFd, pid, exec);
+        if ((valid != entry.info.execValid) ||
+            (valid && ((exec.dev != entry.info.exec.dev) || (exec.inode != entry.info.exec.inode))))
+          m_table.setExec(entry, valid, exec);
+      }
+    } else {
+      m_table.addEntry(pid, dirInode, procFd);
+    }
+  }
+private:
+  scProcessTable &m_table;
+  bool m_checkExec;
+};
+
+// ----------------------------------------------------------------------------
+// scProcessTable
+// ----------------------------------------------------------------------------
+size_t scProcessTable::ExecKeyHash::operator()(const ExecKey &key) const
+{
+  size_t seed = 0;
+  boost::hash_combine(seed, static_cast<unsigned long long>(key.dev));
+  boost::hash_combine(seed, static_cast<unsigned long long>(key.inode));
+  return seed;
+}
+
+scProcessTable::scProcessTable(uint refreshMs):
+  m_refreshMs(refreshMs), m_socket(-1), m_started(false), m_resyncNeeded(false), m_scanNo(0), m_lastScanTime(0)
+{
+}
+
+scProcessTable::~scProcessTable()
+{
+  stop();
+}
+
+void scProcessTable::start()
+{
+  stop();
+  m_started = true;
+  // subscribe first, so changes made during scan are not lost
+  subscribe();
+  resync();
+}
+
+void scProcessTable::stop()
+{
+  unsubscribe();
+  m_entries.clear();
+  m_execIndex.clear();
+  m_started = false;
+}
+
+bool scProcessTable::isEventDriven() const
+{
+  return (m_socket >= 0);
+}
+
+bool scProcessTable::subscribe()
+{
+  int sock = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+  if (sock < 0)
+    return false;
+
+  struct sockaddr_nl addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.nl_family = AF_NETLINK;
+  addr.nl_groups = CN_IDX_PROC;
+  addr.nl_pid = 0;
+
+  if (bind(sock, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0) {
+    close(sock);
+    return false;
+  }
+
+  // nlmsghdr, cn_msg and listen operation, cn_msg ends with flexible array
+  char request[NLMSG_SPACE(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op))];
+  std::memset(request, 0, sizeof(request));
+
+  struct nlmsghdr *header = reinterpret_cast<struct nlmsghdr *>(request);
+  header->nlmsg_len = NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op));
+  header->nlmsg_type = NLMSG_DONE;
+  header->nlmsg_pid = getpid();
+
+  struct cn_msg *message = static_cast<struct cn_msg *>(NLMSG_DATA(header));
+  message->id.idx = CN_IDX_PROC;
+  message->id.val = CN_VAL_PROC;
+  message->len = sizeof(enum proc_cn_mcast_op);
+  enum proc_cn_mcast_op op = PROC_CN_MCAST_LISTEN;
+  std::memcpy(message->data, &op, sizeof(op));
+
+  // fails without CAP_NET_ADMIN
+  if (send(sock, request, header->nlmsg_len, 0) != static_cast<ssize_t>(header->nlmsg_len)) {
+    close(sock);
+    return false;
+  }
+
+  m_socket = sock;
+  return true;
+}
+
+void scProcessTable::unsubscribe()
+{
+  if (m_socket < 0)
+    return;
+  close(m_socket);
+  m_socket = -1;
+}
+
+void scProcessTable::update()
+{
+  if (!m_started)
+    start();
+
+  if (m_socket >= 0)
+    readEvents();
+  else if (getTimeMs() - m_lastScanTime >= m_refreshMs)
+    scanDiff();
+
+  if (m_resyncNeeded)
+    resync();
+}
+
+void scProcessTable::resync()
+{
+  m_resyncNeeded = false;
+  scanDiff();
+}
+
+void scProcessTable::scanDiff()
+{
+  ++m_scanNo;
+  scProcessTableScanner scanner(*this, true);
+  ScanProcessDir(&scanner);
+
+  for(EntryMap::iterator it = m_entries.begin(); it != m_entries.end(); )
+  {
+    if (it->second.scanNo != m_scanNo) {
+      scProcessId pid = it->first;
+      ++it;
+      removeEntry(pid);
+    } else {
+      ++it;
+    }
+  }
+
+  m_lastScanTime = getTimeMs();
+}
+
+void scProcessTable::readEvents()
+{
+  char buffer[SC_PROC_TABLE_RECV_BUFFER_SIZE];
+
+  for(;;) {
+    struct sockaddr_nl addr;
+    socklen_t addrLen = sizeof(addr);
+    ssize_t len = recvfrom(m_socket, buffer, sizeof(buffer), MSG_DONTWAIT,
+      reinterpret_cast<struct sockaddr *>(&addr), &addrLen);
+
+    if (len < 0) {
+      if (errno == EINTR)
+        continue;
+      // events were dropped by kernel
+      if (errno == ENOBUFS)
+        m_resyncNeeded = true;
+      break;
+    }
+
+    // only kernel is trusted
+    if ((len == 0) || (addr.nl_pid != 0))
+      continue;
+
+    for(struct nlmsghdr *header = reinterpret_cast<struct nlmsghdr *>(buffer);
+        NLMSG_OK(header, static_cast<unsigned int>(len)); header = NLMSG_NEXT(header, len))
+    {
+      if ((header->nlmsg_type == NLMSG_ERROR) || (header->nlmsg_type == NLMSG_NOOP))
+        continue;
+
+      struct cn_msg *message = static_cast<struct cn_msg *>(NLMSG_DATA(header));
+      if ((message->id.idx != CN_IDX_PROC) || (message->id.val != CN_VAL_PROC))
+        continue;
+
+      struct proc_event *event = reinterpret_cast<struct proc_event *>(message->data);
+      switch (event->what) {
+        case proc_event::PROC_EVENT_FORK:
+          // threads are not tracked
+          if (event->event_data.fork.child_pid == event->event_data.fork.child_tgid)
+            onFork(event->event_data.fork.parent_tgid, event->event_data.fork.child_tgid);
+          break;
+        case proc_event::PROC_EVENT_EXEC:
+          onExec(event->event_data.exec.process_tgid);
+          break;
+        case proc_event::PROC_EVENT_EXIT:
+          if (event->event_data.exit.process_pid == event->event_data.exit.process_tgid)
+            onExit(event->event_data.exit.process_tgid);
+          break;
+        default:
+          break;
+      }
+    }
+  }
+}
+
+void scProcessTable::onFork(scProcessId parentPid, scProcessId childPid)
+{
+  removeEntry(childPid);
+
+  Entry entry;
+  entry.info.pid = childPid;
+  entry.info.ppid = parentPid;
+  entry.info.execValid = false;
+  entry.info.startTime = 0;
+  entry.dirInode = 0;
+  entry.scanNo = m_scanNo;
+
+  unsigned long ppid;
+  unsigned long long startTime;
+  if (ReadProcessStat(childPid, ppid, startTime))
+    entry.info.startTime = startTime;
+
+  Entry &added = m_entries.insert(std::make_pair(childPid, entry)).first->second;
+
+  // child runs the same executable until exec
+  EntryMap::const_iterator parent = m_entries.find(parentPid);
+  if ((parent != m_entries.end()) && parent->second.info.execValid)
+    setExec(added, true, parent->second.info.exec);
+}
+
+void scProcessTable::onExec(scProcessId pid)
+{
+  EntryMap::iterator it = m_entries.find(pid);
+  if (it == m_entries.end())
+  {
+    // fork was not seen
+    Entry entry;
+    entry.info.pid = pid;
+    entry.info.ppid = GetParentProcessId(pid);
+    entry.info.execValid = false;
+    entry.info.startTime = 0;
+    entry.dirInode = 0;
+    entry.scanNo = m_scanNo;
+    it = m_entries.insert(std::make_pair(pid, entry)).first;
+  }
+
+  ExecId exec;
+  bool valid = GetProcessExecId(pid, exec);
+  setExec(it->second, valid, exec);
+}
+
+void scProcessTable::onExit(scProcessId pid)
+{
+  removeEntry(pid);
+}
+
+void scProcessTable::addEntry(scProcessId pid, unsigned long long dirInode, int procFd)
+{
+  Entry entry;
+  entry.info.pid = pid;
+  entry.info.ppid = 0;
+  entry.info.startTime = 0;
+  entry.info.execValid = false;
+  entry.dirInode = dirInode;
+  entry.scanNo = m_scanNo;
+
+  unsigned long ppid;
+  unsigned long long startTime;
+  if (ReadProcessStat(pid, ppid, startTime)) {
+    entry.info.ppid = ppid;
+    entry.info.startTime = startTime;
+  }
+
+  Entry &added = m_entries.insert(std::make_pair(pid, entry)).first->second;
+
+  ExecId exec;
+  if (GetProcessExecIdAt(procFd, pid, exec))
+    setExec(added, true, exec);
+}
+
+void scProcessTable::removeEntry(scProcessId pid)
+{
+  EntryMap::iterator it = m_entries.find(pid);
+  if (it == m_entries.end())
+    return;
+
+  ExecId noExec;
+  std::memset(&noExec, 0, sizeof(noExec));
+  setExec(it->second, false, noExec);
+  m_entries.erase(it);
+}
+
+void scProcessTable::setExec(Entry &entry, bool valid, const ExecId &exec)
+{
+  if (entry.info.execValid) {
+    ExecKey oldKey;
+    oldKey.dev = entry.info.exec.dev;
+    oldKey.inode = entry.info.exec.inode;
+    ExecIndex::iterator it = m_execIndex.find(oldKey);
+    if (it != m_execIndex.end()) {
+      it->second.erase(entry.info.pid);
+      if (it->second.empty())
+        m_execIndex.erase(it);
+    }
+  }
+
+  entry.info.execValid = valid;
+  if (!valid)
+    return;
+
+  entry.info.exec = exec;
+  ExecKey key;
+  key.dev = exec.dev;
+  key.inode = exec.inode;
+  m_execIndex[key].insert(entry.info.pid);
+}
+
+bool scProcessTable::findExec(const scString &execPath, ExecKey &output)
+{
+  ExecId exec;
+  if (!GetExecId(execPath.c_str(), exec))
+    return false;
+  output.dev = exec.dev;
+  output.inode = exec.inode;
+  return true;
+}
+
+bool scProcessTable::exists(scProcessId pid)
+{
+  update();
+  return (m_entries.find(pid) != m_entries.end());
+}
+
+scProcessId scProcessTable::getParent(scProcessId pid)
+{
+  update();
+  EntryMap::iterator it = m_entries.find(pid);
+  if (it == m_entries.end())
+    return 0;
+
+  // orphans are adopted without events
+  scProcessId ppid = it->second.info.ppid;
+  if ((ppid != 0) && (m_entries.find(ppid) == m_entries.end())) {
+    ppid = GetParentProcessId(pid);
+    it->second.info.ppid = ppid;
+  }
+  return ppid;
+}
+
+bool scProcessTable::getInfo(scProcessId pid, scProcessInfo &output)
+{
+  // refreshes parent of orphans
+  getParent(pid);
+  EntryMap::const_iterator it = m_entries.find(pid);
+  if (it == m_entries.end())
+    return false;
+  output = it->second.info;
+  return true;
+}
+
+uint scProcessTable::countByExec(const scString &execPath, bool excludeCurrent)
+{
+  return enumByExec(execPath, excludeCurrent, SC_NULL);
+}
+
+uint scProcessTable::enumByExec(const scString &execPath, bool excludeCurrent, scProcessEnumerator *enumProc)
+{
+  update();
+
+  ExecKey key;
+  if (!findExec(execPath, key))
+    return 0;
+
+  ExecIndex::const_iterator it = m_execIndex.find(key);
+  if (it == m_execIndex.end())
+    return 0;
+
+  const PidSet &pids = it->second;
+  scProcessId currPid = excludeCurrent?static_cast<scProcessId>(getpid()):0;
+  if (enumProc == SC_NULL)
+    return static_cast<uint>(pids.size() - pids.count(currPid));
+
+  uint res = 0;
+  for(PidSet::const_iterator pit = pids.begin(), epos = pids.end(); pit != epos; ++pit)
+  {
+    if (*pit == currPid)
+      continue;
+    (*enumProc)(*pit);
+    ++res;
+  }
+  return res;
+}
+
+uint scProcessTable::getProcessCount()
+{
+  update();
+  return static_cast<uint>(m_entries.size());
+}
+
+boost::uint64_t scProcessTable::getTimeMs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<boost::uint64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
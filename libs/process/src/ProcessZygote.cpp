@@ -0,0 +1,536 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        ProcessZygote.cpp
+// Project:     scLib
+// Purpose:     Pre-forked template process for fast repeated launches
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <spawn.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+
+#include "sc/proc/ProcessZygote.h"
+#include "sc/proc/ProcessBootstrap.h"
+
+extern char **environ;
+
+// ----------------------------------------------------------------------------
+// Private declarations
+// ----------------------------------------------------------------------------
+/// descriptor of request socket in template process
+const int SC_PROC_ZYGOTE_FD = 3;
+/// lowest descriptor used for socket end passed to template
+const int SC_PROC_ZYGOTE_MIN_FD = 10;
+const size_t SC_PROC_ZYGOTE_MAX_MSG = 128 * 1024;
+const uint SC_PROC_ZYGOTE_STD_FD_COUNT = 3;
+const uint SC_PROC_ZYGOTE_STOP_TIMEOUT_MS = 1000;
+const uint SC_PROC_ZYGOTE_WAIT_STEP_MS = 10;
+
+#define UNIX_PROC_PRIORITY_BACKGROUD 5
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+
+enum scZygoteRequestFlags {
+  zrfLowPriority = 1,
+  zrfMinimized = 2
+};
+
+/// request message: header, then argCount + envCount zero-terminated strings,
+/// standard stream descriptors are attached as SCM_RIGHTS
+struct scZygoteRequestHeader {
+  unsigned int argCount;
+  unsigned int envCount;
+  unsigned int flags;
+};
+
+/// response message, pidfd of child is attached as SCM_RIGHTS if it could be opened
+struct scZygoteResponse {
+  int pid;
+  int error;
+};
+
+// ----------------------------------------------------------------------------
+// Private functions
+// ----------------------------------------------------------------------------
+static void sleepMs(uint value)
+{
+  struct timespec ts;
+  ts.tv_sec = value / 1000;
+  ts.tv_nsec = (value % 1000) * 1000000L;
+  nanosleep(&ts, SC_NULL);
+}
+
+/// Copies current environment without entries of given name
+static void copyEnvironment(const char *name, std::vector<char *> &output)
+{
+  size_t nameLen = strlen(name);
+  for(char **item = environ; (item != SC_NULL) && (*item != SC_NULL); ++item)
+    if ((strncmp(*item, name, nameLen) != 0) || ((*item)[nameLen] != '='))
+      output.push_back(*item);
+}
+
+static void appendString(const char *value, std::vector<char> &output)
+{
+  output.insert(output.end(), value, value + strlen(value) + 1);
+}
+
+static void closeReceived(int *fds, uint count)
+{
+  for(uint i = 0; i < count; i++)
+    close(fds[i]);
+}
+
+/// SIGCHLD handler of template
+static void reapChildren(int)
+{
+  int savedErrno = errno;
+  while(waitpid(-1, SC_NULL, WNOHANG) > 0)
+    ;
+  errno = savedErrno;
+}
+
+/// Applies request in forked child of template
+static void applyRequest(const char *strings, const scZygoteRequestHeader &header, int *fds,
+  const sigset_t &savedMask, std::vector<scString> &args)
+{
+  signal(SIGCHLD, SIG_DFL);
+  sigprocmask(SIG_SETMASK, &savedMask, SC_NULL);
+
+  if ((header.flags & zrfMinimized) != 0)
+    setsid();
+
+  for(uint i = 0; i < SC_PROC_ZYGOTE_STD_FD_COUNT; i++)
+    dup2(fds[i], static_cast<int>(i));
+  for(uint i = 0; i < SC_PROC_ZYGOTE_STD_FD_COUNT; i++)
+    if (fds[i] >= static_cast<int>(SC_PROC_ZYGOTE_STD_FD_COUNT))
+      close(fds[i]);
+
+  if ((header.flags & zrfLowPriority) != 0) {
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    sched_setscheduler(0, SCHED_BATCH, &param);
+    setpriority(PRIO_PROCESS, 0, UNIX_PROC_PRIORITY_BACKGROUD);
+  }
+
+  args.clear();
+  const char *pos = strings;
+  for(uint i = 0; i < header.argCount; i++) {
+    args.push_back(scString(pos));
+    pos += strlen(pos) + 1;
+  }
+
+  clearenv();
+  for(uint i = 0; i < header.envCount; i++) {
+    // putenv keeps pointer, copy lives until exit of child
+    putenv(strdup(pos));
+    pos += strlen(pos) + 1;
+  }
+}
+
+// ----------------------------------------------------------------------------
+// scProcessZygote
+// ----------------------------------------------------------------------------
+scProcessZygote::scProcessZygote(const scString &command, const scString &params):
+  m_command(command),
+  m_params(params),
+  m_socket(-1),
+  m_pid(0)
+{
+}
+
+scProcessZygote::~scProcessZygote()
+{
+  stop();
+}
+
+bool scProcessZygote::start()
+{
+  if (m_socket >= 0)
+    return true;
+
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, fds) != 0)
+    return false;
+
+  // keep template end away from SC_PROC_ZYGOTE_FD, dup2 in child clears close-on-exec
+  int childFd = fcntl(fds[1], F_DUPFD_CLOEXEC, SC_PROC_ZYGOTE_MIN_FD);
+  close(fds[1]);
+  if (childFd < 0) {
+    close(fds[0]);
+    return false;
+  }
+
+  std::vector<scString> args;
+  args.push_back(m_command);
+  scProcessLauncher::splitParams(m_params, args);
+
+  std::vector<char *> argv;
+  for(std::vector<scString>::iterator it = args.begin(), epos = args.end(); it != epos; ++it)
+    argv.push_back(const_cast<char *>(it->c_str()));
+  argv.push_back(SC_NULL);
+
+  char envEntry[64];
+  snprintf(envEntry, sizeof(envEntry), "%s=%d", SC_PROC_ZYGOTE_ENV, SC_PROC_ZYGOTE_FD);
+
+  std::vector<char *> envp;
+  copyEnvironment(SC_PROC_ZYGOTE_ENV, envp);
+  envp.push_back(envEntry);
+  envp.push_back(SC_NULL);
+
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_adddup2(&actions, childFd, SC_PROC_ZYGOTE_FD);
+
+  pid_t pid = 0;
+  int err = posix_spawnp(&pid, m_command.c_str(), &actions, SC_NULL, &argv[0], &envp[0]);
+
+  posix_spawn_file_actions_destroy(&actions);
+  close(childFd);
+
+  if (err != 0) {
+    close(fds[0]);
+    return false;
+  }
+
+  m_socket = fds[0];
+  m_pid = pid;
+  return true;
+}
+
+void scProcessZygote::stop()
+{
+  if (m_socket < 0)
+    return;
+
+  // template exits when socket is closed
+  close(m_socket);
+  m_socket = -1;
+
+  pid_t pid = static_cast<pid_t>(m_pid);
+  m_pid = 0;
+
+  for(uint waited = 0; ; waited += SC_PROC_ZYGOTE_WAIT_STEP_MS) {
+    pid_t res = waitpid(pid, SC_NULL, WNOHANG);
+    if ((res == pid) || ((res < 0) && (errno != EINTR)))
+      return;
+    if (waited >= SC_PROC_ZYGOTE_STOP_TIMEOUT_MS)
+      break;
+    sleepMs(SC_PROC_ZYGOTE_WAIT_STEP_MS);
+  }
+
+  kill(pid, SIGKILL);
+  waitpid(pid, SC_NULL, 0);
+}
+
+bool scProcessZygote::isRunning() const
+{
+  return (m_socket >= 0);
+}
+
+scProcessId scProcessZygote::getTemplatePid() const
+{
+  return m_pid;
+}
+
+scProcessId scProcessZygote::spawn(const scSpawnRequest &request)
+{
+  int pidFd;
+  scProcessId res = spawnWithPidFd(request, pidFd);
+  if (pidFd >= 0)
+    close(pidFd);
+  return res;
+}
+
+scProcessId scProcessZygote::spawnWithPidFd(const scSpawnRequest &request, int &pidFd)
+{
+  pidFd = -1;
+
+  // forked children cannot be placed before they start running
+  if ((request.command != m_command) || !request.scheduling.isDefault())
+    return scProcessLauncher::spawn(request);
+
+  scProcessId pid = 0;
+  if (start() && requestFork(request, pid, pidFd))
+    return pid;
+
+  // template died, restart it once
+  stop();
+  if (start() && requestFork(request, pid, pidFd))
+    return pid;
+
+  stop();
+  return scProcessLauncher::spawn(request);
+}
+
+bool scProcessZygote::requestFork(const scSpawnRequest &request, scProcessId &pid, int &pidFd)
+{
+  pidFd = -1;
+
+  std::vector<scString> args;
+  args.push_back(request.command);
+  scProcessLauncher::splitParams(request.params, args);
+
+  scString envEntry;
+  std::vector<char *> envp;
+  copyEnvironment(SC_PROC_BOOTSTRAP_ENV, envp);
+  if (!request.bootstrapName.empty()) {
+    envEntry = scString(SC_PROC_BOOTSTRAP_ENV) + "=" + request.bootstrapName;
+    envp.push_back(const_cast<char *>(envEntry.c_str()));
+  }
+
+  scZygoteRequestHeader header;
+  header.argCount = args.size();
+  header.envCount = envp.size();
+  header.flags = (request.lowPriority?zrfLowPriority:0) | (request.minimized?zrfMinimized:0);
+
+  std::vector<char> message(reinterpret_cast<char *>(&header), reinterpret_cast<char *>(&header) + sizeof(header));
+  for(std::vector<scString>::iterator it = args.begin(), epos = args.end(); it != epos; ++it)
+    appendString(it->c_str(), message);
+  for(std::vector<char *>::iterator it = envp.begin(), epos = envp.end(); it != epos; ++it)
+    appendString(*it, message);
+
+  if (message.size() > SC_PROC_ZYGOTE_MAX_MSG) {
+    // too large for template, not a transport failure
+    pid = scProcessLauncher::spawn(request);
+    return true;
+  }
+
+  int nullFd = -1;
+  int stdFds[SC_PROC_ZYGOTE_STD_FD_COUNT];
+  if (request.minimized) {
+    nullFd = open("/dev/null", O_RDWR | O_CLOEXEC);
+    if (nullFd < 0) {
+      pid = 0;
+      return true;
+    }
+    for(uint i = 0; i < SC_PROC_ZYGOTE_STD_FD_COUNT; i++)
+      stdFds[i] = nullFd;
+  } else {
+    for(uint i = 0; i < SC_PROC_ZYGOTE_STD_FD_COUNT; i++)
+      stdFds[i] = static_cast<int>(i);
+  }
+
+  if (request.outputFd >= 0)
+    stdFds[STDOUT_FILENO] = request.outputFd;
+
+  struct iovec iov;
+  iov.iov_base = &message[0];
+  iov.iov_len = message.size();
+
+  char control[CMSG_SPACE(sizeof(stdFds))];
+  memset(control, 0, sizeof(control));
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(stdFds));
+  memcpy(CMSG_DATA(cmsg), stdFds, sizeof(stdFds));
+
+  ssize_t sent;
+  do {
+    sent = sendmsg(m_socket, &msg, MSG_NOSIGNAL);
+  } while((sent < 0) && (errno == EINTR));
+
+  if (nullFd >= 0)
+    close(nullFd);
+
+  if (sent != static_cast<ssize_t>(message.size()))
+    return false;
+
+  scZygoteResponse response;
+  iov.iov_base = &response;
+  iov.iov_len = sizeof(response);
+
+  char responseControl[CMSG_SPACE(sizeof(int))];
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = responseControl;
+  msg.msg_controllen = sizeof(responseControl);
+
+  ssize_t received;
+  do {
+    received = recvmsg(m_socket, &msg, MSG_CMSG_CLOEXEC);
+  } while((received < 0) && (errno == EINTR));
+
+  if (received < 0)
+    return false;
+
+  cmsg = CMSG_FIRSTHDR(&msg);
+  if ((cmsg != SC_NULL) && (cmsg->cmsg_level == SOL_SOCKET) && (cmsg->cmsg_type == SCM_RIGHTS) &&
+    (cmsg->cmsg_len >= CMSG_LEN(sizeof(int))))
+    memcpy(&pidFd, CMSG_DATA(cmsg), sizeof(int));
+
+  if (received != static_cast<ssize_t>(sizeof(response))) {
+    if (pidFd >= 0)
+      close(pidFd);
+    pidFd = -1;
+    return false;
+  }
+
+  pid = (response.pid > 0)?static_cast<scProcessId>(response.pid):0;
+  if ((pid == 0) && (pidFd >= 0)) {
+    close(pidFd);
+    pidFd = -1;
+  }
+  return true;
+}
+
+bool scProcessZygote::serve(std::vector<scString> &args)
+{
+  const char *envValue = getenv(SC_PROC_ZYGOTE_ENV);
+  if (envValue == SC_NULL)
+    return false;
+
+  int sock = atoi(envValue);
+  unsetenv(SC_PROC_ZYGOTE_ENV);
+  fcntl(sock, F_SETFD, FD_CLOEXEC);
+
+  // children are reaped by handler, but not before their pidfd is opened:
+  // SIGCHLD is blocked from fork until pidfd is sent (SIG_IGN would reap
+  // them at once and pid could be reused before it is opened)
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = reapChildren;
+  action.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGCHLD, &action, SC_NULL);
+
+  sigset_t childMask, savedMask;
+  sigemptyset(&childMask);
+  sigaddset(&childMask, SIGCHLD);
+  sigprocmask(SIG_UNBLOCK, &childMask, &savedMask);
+
+  std::vector<char> buffer(SC_PROC_ZYGOTE_MAX_MSG);
+  int fds[SC_PROC_ZYGOTE_STD_FD_COUNT];
+  char control[CMSG_SPACE(sizeof(fds))];
+
+  for(;;) {
+    struct iovec iov;
+    iov.iov_base = &buffer[0];
+    iov.iov_len = buffer.size();
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t received = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+    if (received < 0) {
+      if (errno == EINTR)
+        continue;
+      exit(1);
+    }
+    if (received == 0)
+      // launching process closed socket
+      exit(0);
+
+    uint fdCount = 0;
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    if ((cmsg != SC_NULL) && (cmsg->cmsg_level == SOL_SOCKET) && (cmsg->cmsg_type == SCM_RIGHTS)) {
+      fdCount = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+      fdCount = SC_MIN(fdCount, SC_PROC_ZYGOTE_STD_FD_COUNT);
+      memcpy(fds, CMSG_DATA(cmsg), fdCount * sizeof(int));
+    }
+
+    scZygoteResponse response;
+    response.pid = 0;
+    response.error = 0;
+
+    scZygoteRequestHeader header;
+    bool valid = (fdCount == SC_PROC_ZYGOTE_STD_FD_COUNT) && ((msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) == 0) &&
+      (static_cast<size_t>(received) > sizeof(header)) && (buffer[received - 1] == '\0');
+
+    if (valid) {
+      memcpy(&header, &buffer[0], sizeof(header));
+      size_t stringCount = std::count(buffer.begin() + sizeof(header), buffer.begin() + received, '\0');
+      valid = (header.argCount > 0) && (stringCount == static_cast<size_t>(header.argCount) + header.envCount);
+    }
+
+    int pidFd = -1;
+    sigprocmask(SIG_BLOCK, &childMask, SC_NULL);
+
+    if (valid) {
+      pid_t pid = fork();
+      if (pid == 0) {
+        close(sock);
+        applyRequest(&buffer[sizeof(header)], header, fds, savedMask, args);
+        return true;
+      }
+      if (pid < 0) {
+        response.error = errno;
+      } else {
+        response.pid = pid;
+        // child cannot be reaped yet, so pid still refers to it
+        pidFd = static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+      }
+    } else {
+      response.error = EINVAL;
+    }
+
+    closeReceived(fds, fdCount);
+
+    struct iovec responseIov;
+    responseIov.iov_base = &response;
+    responseIov.iov_len = sizeof(response);
+
+    char responseControl[CMSG_SPACE(sizeof(int))];
+    memset(responseControl, 0, sizeof(responseControl));
+
+    struct msghdr responseMsg;
+    memset(&responseMsg, 0, sizeof(responseMsg));
+    responseMsg.msg_iov = &responseIov;
+    responseMsg.msg_iovlen = 1;
+
+    if (pidFd >= 0) {
+      responseMsg.msg_control = responseControl;
+      responseMsg.msg_controllen = sizeof(responseControl);
+      struct cmsghdr *responseCmsg = CMSG_FIRSTHDR(&responseMsg);
+      responseCmsg->cmsg_level = SOL_SOCKET;
+      responseCmsg->cmsg_type = SCM_RIGHTS;
+      responseCmsg->cmsg_len = CMSG_LEN(sizeof(int));
+      memcpy(CMSG_DATA(responseCmsg), &pidFd, sizeof(int));
+    }
+
+    ssize_t sent;
+    do {
+      sent = sendmsg(sock, &responseMsg, MSG_NOSIGNAL);
+    } while((sent < 0) && (errno == EINTR));
+
+    if (pidFd >= 0)
+      close(pidFd);
+    sigprocmask(SIG_UNBLOCK, &childMask, SC_NULL);
+
+    if (sent < 0)
+      exit(1);
+  }
+}
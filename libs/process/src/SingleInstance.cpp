@@ -0,0 +1,349 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        SingleInstance.cpp
+// Project:     scLib
+// Purpose:     Single instance lock with forwarding of invocations
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+#include <climits>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+
+#include "sc/proc/SingleInstance.h"
+
+extern char **environ;
+
+// ----------------------------------------------------------------------------
+// Private declarations
+// ----------------------------------------------------------------------------
+const size_t SC_SINGLE_INSTANCE_MAX_MSG = 128 * 1024;
+const uint SC_SINGLE_INSTANCE_STD_FD_COUNT = 3;
+/// bind / connect attempts when primary instance exits meanwhile
+const uint SC_SINGLE_INSTANCE_ATTEMPTS = 3;
+/// max wait for request after connection is accepted
+const uint SC_SINGLE_INSTANCE_RECV_TIMEOUT_MS = 1000;
+const unsigned int SC_SINGLE_INSTANCE_MAGIC = 0x5343494e;
+
+/// request message: header, then working directory, argCount arguments and
+/// envCount environment entries as zero-terminated strings, standard stream
+/// descriptors are attached as SCM_RIGHTS
+struct scInstanceRequestHeader {
+  unsigned int magic;
+  unsigned int argCount;
+  unsigned int envCount;
+};
+
+struct scInstanceResponse {
+  int exitCode;
+};
+
+// ----------------------------------------------------------------------------
+// Private functions
+// ----------------------------------------------------------------------------
+/// Builds abstract socket address (leading zero byte), unique per user
+static socklen_t makeAddress(const scString &name, struct sockaddr_un &addr)
+{
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+
+  int len = snprintf(addr.sun_path + 1, sizeof(addr.sun_path) - 1, "sc_instance/%lu/%s",
+    static_cast<unsigned long>(geteuid()), name.c_str());
+  len = SC_MIN(len, static_cast<int>(sizeof(addr.sun_path)) - 2);
+
+  return static_cast<socklen_t>(offsetof(struct sockaddr_un, sun_path) + 1 + len);
+}
+
+/// Checks that peer runs as the same user
+static bool checkPeer(int sock, scProcessId *pid)
+{
+  struct ucred cred;
+  socklen_t credLen = sizeof(cred);
+  if (getsockopt(sock, SOL_SOCKET, SO_PEERCRED, &cred, &credLen) != 0)
+    return false;
+
+  if (pid != SC_NULL)
+    *pid = static_cast<scProcessId>(cred.pid);
+  return (cred.uid == geteuid());
+}
+
+static void appendString(const char *value, std::vector<char> &output)
+{
+  output.insert(output.end(), value, value + strlen(value) + 1);
+}
+
+// ----------------------------------------------------------------------------
+// scSingleInstance
+// ----------------------------------------------------------------------------
+scSingleInstance::scSingleInstance(const scString &name): m_socket(-1), m_primary(false), m_anotherRunning(false)
+{
+  struct sockaddr_un addr;
+  socklen_t addrLen = makeAddress(name, addr);
+
+  for(uint attempt = 0; attempt < SC_SINGLE_INSTANCE_ATTEMPTS; attempt++) {
+    // not inherited - child holding the name would block next primary
+    int sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (sock < 0)
+      return;
+
+    if (bind(sock, reinterpret_cast<struct sockaddr *>(&addr), addrLen) == 0) {
+      if (listen(sock, SOMAXCONN) != 0) {
+        close(sock);
+        return;
+      }
+      fcntl(sock, F_SETFL, fcntl(sock, F_GETFL) | O_NONBLOCK);
+      m_socket = sock;
+      m_primary = true;
+      m_anotherRunning = false;
+      return;
+    }
+
+    if (errno != EADDRINUSE) {
+      close(sock);
+      return;
+    }
+
+    m_anotherRunning = true;
+    if (connect(sock, reinterpret_cast<struct sockaddr *>(&addr), addrLen) == 0) {
+      // name can be taken by other user, do not pass descriptors there
+      if (checkPeer(sock, SC_NULL))
+        m_socket = sock;
+      else
+        close(sock);
+      return;
+    }
+
+    close(sock);
+    // primary exited between bind and connect, try to take its place
+    m_anotherRunning = false;
+  }
+}
+
+scSingleInstance::~scSingleInstance()
+{
+  if (m_socket >= 0)
+    close(m_socket);
+}
+
+bool scSingleInstance::isPrimary() const
+{
+  return m_primary;
+}
+
+bool scSingleInstance::isAnotherInstanceRunning() const
+{
+  return m_anotherRunning;
+}
+
+int scSingleInstance::getHandle() const
+{
+  return m_primary?m_socket:-1;
+}
+
+bool scSingleInstance::forward(const std::vector<scString> &args, int &exitCode)
+{
+  if (m_primary || (m_socket < 0) || args.empty())
+    return false;
+
+  std::vector<char> workDir(PATH_MAX + 1, '\0');
+  if (getcwd(&workDir[0], workDir.size()) == SC_NULL)
+    workDir[0] = '\0';
+
+  scInstanceRequestHeader header;
+  header.magic = SC_SINGLE_INSTANCE_MAGIC;
+  header.argCount = args.size();
+  header.envCount = 0;
+
+  std::vector<char> message(reinterpret_cast<char *>(&header), reinterpret_cast<char *>(&header) + sizeof(header));
+  appendString(&workDir[0], message);
+  for(std::vector<scString>::const_iterator it = args.begin(), epos = args.end(); it != epos; ++it)
+    appendString(it->c_str(), message);
+  for(char **item = environ; (item != SC_NULL) && (*item != SC_NULL); ++item) {
+    appendString(*item, message);
+    header.envCount++;
+  }
+  memcpy(&message[0], &header, sizeof(header));
+
+  if (message.size() > SC_SINGLE_INSTANCE_MAX_MSG)
+    return false;
+
+  int stdFds[SC_SINGLE_INSTANCE_STD_FD_COUNT];
+  for(uint i = 0; i < SC_SINGLE_INSTANCE_STD_FD_COUNT; i++)
+    stdFds[i] = static_cast<int>(i);
+
+  struct iovec iov;
+  iov.iov_base = &message[0];
+  iov.iov_len = message.size();
+
+  char control[CMSG_SPACE(sizeof(stdFds))];
+  memset(control, 0, sizeof(control));
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(stdFds));
+  memcpy(CMSG_DATA(cmsg), stdFds, sizeof(stdFds));
+
+  ssize_t sent;
+  do {
+    sent = sendmsg(m_socket, &msg, MSG_NOSIGNAL);
+  } while((sent < 0) && (errno == EINTR));
+
+  if (sent != static_cast<ssize_t>(message.size()))
+    return false;
+
+  // invocation can run for any time, wait until primary responds or exits
+  scInstanceResponse response;
+  ssize_t received;
+  do {
+    received = recv(m_socket, &response, sizeof(response), 0);
+  } while((received < 0) && (errno == EINTR));
+
+  if (received != static_cast<ssize_t>(sizeof(response)))
+    return false;
+
+  exitCode = response.exitCode;
+  return true;
+}
+
+uint scSingleInstance::serve(scInstanceRequestHandlerIntf *handler, uint timeoutMs)
+{
+  if (!m_primary)
+    return 0;
+
+  struct pollfd pfd;
+  pfd.fd = m_socket;
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+
+  if (::poll(&pfd, 1, static_cast<int>(timeoutMs)) <= 0)
+    return 0;
+
+  uint res = 0;
+  for(;;) {
+    int connFd = accept4(m_socket, SC_NULL, SC_NULL, SOCK_CLOEXEC);
+    if (connFd < 0) {
+      if (errno == EINTR)
+        continue;
+      break;
+    }
+
+    handleConnection(connFd, handler);
+    close(connFd);
+    res++;
+  }
+
+  return res;
+}
+
+void scSingleInstance::handleConnection(int connFd, scInstanceRequestHandlerIntf *handler)
+{
+  scInstanceRequest request;
+  if (!checkPeer(connFd, &request.pid))
+    return;
+
+  // client which connected and does not send must not block primary
+  struct timeval tv;
+  tv.tv_sec = SC_SINGLE_INSTANCE_RECV_TIMEOUT_MS / 1000;
+  tv.tv_usec = (SC_SINGLE_INSTANCE_RECV_TIMEOUT_MS % 1000) * 1000;
+  setsockopt(connFd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+  std::vector<char> buffer(SC_SINGLE_INSTANCE_MAX_MSG);
+  int fds[SC_SINGLE_INSTANCE_STD_FD_COUNT];
+  char control[CMSG_SPACE(sizeof(fds))];
+
+  struct iovec iov;
+  iov.iov_base = &buffer[0];
+  iov.iov_len = buffer.size();
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  ssize_t received;
+  do {
+    received = recvmsg(connFd, &msg, MSG_CMSG_CLOEXEC);
+  } while((received < 0) && (errno == EINTR));
+
+  if (received <= 0)
+    return;
+
+  uint fdCount = 0;
+  struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+  if ((cmsg != SC_NULL) && (cmsg->cmsg_level == SOL_SOCKET) && (cmsg->cmsg_type == SCM_RIGHTS)) {
+    fdCount = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+    fdCount = SC_MIN(fdCount, SC_SINGLE_INSTANCE_STD_FD_COUNT);
+    memcpy(fds, CMSG_DATA(cmsg), fdCount * sizeof(int));
+  }
+
+  scInstanceRequestHeader header;
+  bool valid = (fdCount == SC_SINGLE_INSTANCE_STD_FD_COUNT) && ((msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) == 0) &&
+    (static_cast<size_t>(received) > sizeof(header)) && (buffer[received - 1] == '\0');
+
+  if (valid) {
+    memcpy(&header, &buffer[0], sizeof(header));
+    size_t stringCount = std::count(buffer.begin() + sizeof(header), buffer.begin() + received, '\0');
+    valid = (header.magic == SC_SINGLE_INSTANCE_MAGIC) && (header.argCount > 0) &&
+      (stringCount == 1 + static_cast<size_t>(header.argCount) + header.envCount);
+  }
+
+  if (valid) {
+    const char *cptr = &buffer[sizeof(header)];
+    request.workDir = cptr;
+    cptr += strlen(cptr) + 1;
+
+    request.args.reserve(header.argCount);
+    for(uint i = 0; i < header.argCount; i++) {
+      request.args.push_back(scString(cptr));
+      cptr += strlen(cptr) + 1;
+    }
+
+    request.env.reserve(header.envCount);
+    for(uint i = 0; i < header.envCount; i++) {
+      request.env.push_back(scString(cptr));
+      cptr += strlen(cptr) + 1;
+    }
+
+    request.stdinFd = fds[0];
+    request.stdoutFd = fds[1];
+    request.stderrFd = fds[2];
+
+    scInstanceResponse response;
+    response.exitCode = handler->handleRequest(request);
+
+    // forwarding process sees end of output before it gets exit code
+    for(uint i = 0; i < fdCount; i++)
+      close(fds[i]);
+    fdCount = 0;
+
+    // forwarding process could exit meanwhile
+    send(connFd, &response, sizeof(response), MSG_NOSIGNAL);
+  }
+
+  for(uint i = 0; i < fdCount; i++)
+    close(fds[i]);
+}
@@ -10,16 +10,19 @@
 #include <windows.h>
 
 #include "sc/proc/StartProcessThread.h"
+#include "sc/proc/process.h"
 
 static size_t gs_counter = (size_t)-1;
 static wxCriticalSection gs_critsect;
 static wxSemaphore gs_cond;
 
-scStartProcessThread::scStartProcessThread(const scString& command, const scString &params, bool a_minimized, bool a_lowPriority):
+scStartProcessThread::scStartProcessThread(const scString& command, const scString &params, bool a_minimized, bool a_lowPriority,
+  const scString &bootstrapName):
     m_command(command), 
     m_params(params), 
     m_minimized(a_minimized),
-    m_lowPriority(a_lowPriority)
+    m_lowPriority(a_lowPriority),
+    m_bootstrapName(bootstrapName)
 {
     Create();
 }
@@ -27,12 +30,6 @@ scStartProcessThread::scStartProcessThread(const scString& command, const scStri
 
 wxThread::ExitCode scStartProcessThread::Entry()
 {
-	STARTUPINFO si;
-	PROCESS_INFORMATION pi;
-	std::string cmd = m_command.c_str();
-	std::string params = m_params.c_str();
-	DWORD createParams;
-
   {
       wxCriticalSectionLocker lock(gs_critsect);
       if ( gs_counter == (size_t)-1 )
@@ -40,36 +37,8 @@ wxThread::ExitCode scStartProcessThread::Entry()
       else
           gs_counter++;
   }
-    	
-	memset(& si, 0, sizeof(si));
-	memset(& pi, 0, sizeof(pi));
 
-  if (m_minimized)
-  {
-    si.dwFlags = STARTF_USESHOWWINDOW | STARTF_USESTDHANDLES;
-    si.wShowWindow = SW_HIDE;
-    createParams = 0;
-  } else {
-    si.dwFlags = STARTF_USESHOWWINDOW;// | STARTF_USESTDHANDLES;
-    si.wShowWindow = SW_SHOW;
-    createParams = CREATE_NEW_CONSOLE;
-  }
-
-  si.cb = sizeof(si);
-  
-  scString cmdLine = cmd + " " + params;
-	BOOL started = CreateProcess(const_cast<char *>(cmd.c_str()), const_cast<char *>(cmdLine.c_str()), 
-	  NULL, NULL, FALSE, createParams, 0, NULL, 
-	  &si, &pi);
-	
-  if (m_lowPriority && started)
-  {
-    SetPriorityClass (
-      pi.hProcess,
-      BELOW_NORMAL_PRIORITY_CLASS
-    );
-  }  
-	
+  proc::startProcess(m_command, m_params, m_minimized, m_lowPriority, m_bootstrapName);
   return 0;  
 }
 
@@ -9,6 +9,8 @@
 
 #include <windows.h>
 #include <tlhelp32.h>
+#include <vector>
+#include <map>
 
 #include "sc/proc/W32Process.h"
 
@@ -290,6 +292,71 @@ unsigned long GetParentProcessId(unsigned long processId)
   return res;
 }
 
+static bool GetProcessCreationTime(DWORD pid, ULONGLONG &output)
+{
+  HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION, FALSE, pid);
+  if (hProcess == NULL)
+    return false;
+
+  FILETIME creationTime, exitTime, kernelTime, userTime;
+  BOOL res = GetProcessTimes(hProcess, &creationTime, &exitTime, &kernelTime, &userTime);
+  CloseHandle(hProcess);
+  if (!res)
+    return false;
+
+  output = (static_cast<ULONGLONG>(creationTime.dwHighDateTime) << 32) | creationTime.dwLowDateTime;
+  return true;
+}
+
+unsigned int GetProcessTree(unsigned long rootPid, std::vector<unsigned long> &output)
+{
+  typedef std::multimap<DWORD, DWORD> ChildMap;
+  ChildMap children;
+  bool rootFound = false;
+  DWORD currentPid = GetCurrentProcessId();
+
+  PROCESSENTRY32 Pc = { sizeof(PROCESSENTRY32) };
+  HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+  if (hSnapshot == INVALID_HANDLE_VALUE)
+    return 0;
+
+  if(Process32First(hSnapshot, &Pc)){
+    do{
+        if (Pc.th32ProcessID == rootPid)
+          rootFound = true;
+        else if (Pc.th32ProcessID != 0)
+          children.insert(std::make_pair(Pc.th32ParentProcessID, Pc.th32ProcessID));
+    }while(Process32Next(hSnapshot, &Pc));
+  }
+  CloseHandle(hSnapshot);
+
+  if (!rootFound || (rootPid == currentPid))
+    return 0;
+
+  size_t startSize = output.size();
+  output.push_back(rootPid);
+  for(size_t i = startSize; i < output.size(); i++) {
+    std::pair<ChildMap::const_iterator, ChildMap::const_iterator> range = children.equal_range(output[i]);
+    if (range.first == range.second)
+      continue;
+
+    // parent ID is not cleared when parent exits, so after pid reuse it can
+    // point to unrelated process - real children are created after parent
+    ULONGLONG parentTime, childTime;
+    bool parentTimeValid = GetProcessCreationTime(output[i], parentTime);
+
+    for(ChildMap::const_iterator it = range.first; it != range.second; ++it) {
+      if (it->second == currentPid)
+        continue;
+      if (parentTimeValid && GetProcessCreationTime(it->second, childTime) && (childTime < parentTime))
+        continue;
+      output.push_back(it->second);
+    }
+  }
+
+  return output.size() - startSize;
+}
+
 bool ProcessExists(unsigned long pid)
 {
   class scW32CheckEnumerator: public scProcessEnumerator {
@@ -308,4 +375,204 @@ bool ProcessExists(unsigned long pid)
   return enumer.isProcessFound();
 }
 
+/// Returns affinity mask with bits of requested CPUs set
+static DWORD_PTR GetAffinityMask(const scSchedulingParams &params)
+{
+  DWORD_PTR mask = 0;
+  for(std::vector<uint>::const_iterator it = params.cpus.begin(), epos = params.cpus.end(); it != epos; ++it)
+    if (*it < sizeof(DWORD_PTR) * 8)
+      mask |= (static_cast<DWORD_PTR>(1) << *it);
+  return mask;
+}
+
+// policies are mapped to nearest priority class
+static bool ApplyProcessScheduling(HANDLE hProcess, const scSchedulingParams &params, bool currentProcess)
+{
+  bool res = true;
+
+  if (!params.cpus.empty())
+    res = (SetProcessAffinityMask(hProcess, GetAffinityMask(params)) != FALSE) && res;
+
+  if (params.policy != spDefault) {
+    DWORD priorityClass;
+    switch (params.policy) {
+      case spBatch:
+        priorityClass = BELOW_NORMAL_PRIORITY_CLASS;
+        break;
+      case spIdle:
+        priorityClass = IDLE_PRIORITY_CLASS;
+        break;
+      case spFifo:
+      case spRoundRobin:
+        priorityClass = HIGH_PRIORITY_CLASS;
+        break;
+      default:
+        priorityClass = NORMAL_PRIORITY_CLASS;
+        break;
+    }
+    res = (SetPriorityClass(hProcess, priorityClass) != FALSE) && res;
+  }
+
+  // background mode lowers I/O and memory priority, only for current process
+  if (params.ioClass != icDefault) {
+    if (currentProcess)
+      res = (SetPriorityClass(hProcess,
+        (params.ioClass == icIdle)?PROCESS_MODE_BACKGROUND_BEGIN:PROCESS_MODE_BACKGROUND_END) != FALSE) && res;
+    else
+      res = false;
+  }
+
+  if (params.numaPolicy != npDefault)
+    res = false;
+
+  return res;
+}
+
+bool SetProcessScheduling(unsigned long pid, const scSchedulingParams &params)
+{
+  if ((pid == 0) || (pid == GetCurrentProcessId()))
+    return ApplyProcessScheduling(GetCurrentProcess(), params, true);
+
+  HANDLE hProcess = OpenProcess(PROCESS_SET_INFORMATION | PROCESS_QUERY_INFORMATION, FALSE, pid);
+  if (hProcess == NULL)
+    return false;
+
+  bool res = ApplyProcessScheduling(hProcess, params, false);
+  CloseHandle(hProcess);
+  return res;
+}
+
+bool SetThreadScheduling(unsigned long tid, const scSchedulingParams &params)
+{
+  bool currentThread = (tid == 0) || (tid == GetCurrentThreadId());
+  HANDLE hThread = currentThread?GetCurrentThread():OpenThread(THREAD_SET_INFORMATION | THREAD_QUERY_INFORMATION, FALSE, tid);
+  if (hThread == NULL)
+    return false;
+
+  bool res = true;
+
+  if (!params.cpus.empty())
+    res = (SetThreadAffinityMask(hThread, GetAffinityMask(params)) != 0) && res;
+
+  if (params.policy != spDefault) {
+    int priority;
+    switch (params.policy) {
+      case spBatch:
+        priority = THREAD_PRIORITY_BELOW_NORMAL;
+        break;
+      case spIdle:
+        priority = THREAD_PRIORITY_IDLE;
+        break;
+      case spFifo:
+      case spRoundRobin:
+        priority = THREAD_PRIORITY_TIME_CRITICAL;
+        break;
+      default:
+        priority = THREAD_PRIORITY_NORMAL;
+        break;
+    }
+    res = (SetThreadPriority(hThread, priority) != FALSE) && res;
+  }
+
+  if (params.ioClass != icDefault) {
+    if (currentThread)
+      res = (SetThreadPriority(hThread,
+        (params.ioClass == icIdle)?THREAD_MODE_BACKGROUND_BEGIN:THREAD_MODE_BACKGROUND_END) != FALSE) && res;
+    else
+      res = false;
+  }
+
+  if (params.numaPolicy != npDefault)
+    res = false;
+
+  if (!currentThread)
+    CloseHandle(hThread);
+  return res;
+}
+
+/// Returns copy of current environment block with envEntry added
+static void BuildEnvironment(LPCSTR envEntry, std::vector<char> &output)
+{
+  const char *eqPos = strchr(envEntry, '=');
+  size_t nameLen = (eqPos != NULL)?(eqPos - envEntry + 1):strlen(envEntry);
+
+  LPCH env = GetEnvironmentStrings();
+  if (env != NULL)
+  {
+    for(LPCH item = env; *item != '\0'; item += strlen(item) + 1)
+    {
+      // entry with the same name is replaced
+      if (_strnicmp(item, envEntry, nameLen) == 0)
+        continue;
+      output.insert(output.end(), item, item + strlen(item) + 1);
+    }
+    FreeEnvironmentStrings(env);
+  }
+
+  output.insert(output.end(), envEntry, envEntry + strlen(envEntry) + 1);
+  output.push_back('\0');
+}
+
+DWORD StartApp(LPCSTR szCommand, LPCSTR szParams, bool minimized, bool lowPriority, LPCSTR envEntry,
+  HANDLE *processHandle, const scSchedulingParams *scheduling)
+{
+  STARTUPINFO si;
+  PROCESS_INFORMATION pi;
+  DWORD createParams;
+  std::vector<char> envBlock;
+
+  memset(& si, 0, sizeof(si));
+  memset(& pi, 0, sizeof(pi));
+
+  if (minimized)
+  {
+    si.dwFlags = STARTF_USESHOWWINDOW | STARTF_USESTDHANDLES;
+    si.wShowWindow = SW_HIDE;
+    createParams = 0;
+  } else {
+    si.dwFlags = STARTF_USESHOWWINDOW;// | STARTF_USESTDHANDLES;
+    si.wShowWindow = SW_SHOW;
+    createParams = CREATE_NEW_CONSOLE;
+  }
+
+  si.cb = sizeof(si);
+
+  if ((envEntry != NULL) && (*envEntry != '\0'))
+    BuildEnvironment(envEntry, envBlock);
+
+  // scheduling is applied before first instruction of process
+  bool applyScheduling = (scheduling != NULL) && !scheduling->isDefault();
+  if (applyScheduling)
+    createParams |= CREATE_SUSPENDED;
+
+  std::string cmdLine = std::string(szCommand) + " " + szParams;
+  BOOL started = CreateProcess(szCommand, const_cast<char *>(cmdLine.c_str()),
+    NULL, NULL, FALSE, createParams, envBlock.empty()?NULL:&envBlock[0], NULL,
+    &si, &pi);
+
+  if (!started)
+    return 0;
+
+  if (lowPriority)
+  {
+    SetPriorityClass (
+      pi.hProcess,
+      BELOW_NORMAL_PRIORITY_CLASS
+    );
+  }
+
+  if (applyScheduling)
+  {
+    ApplyProcessScheduling(pi.hProcess, *scheduling, false);
+    ResumeThread(pi.hThread);
+  }
+
+  CloseHandle(pi.hThread);
+  if (processHandle != NULL)
+    *processHandle = pi.hProcess;
+  else
+    CloseHandle(pi.hProcess);
+  return pi.dwProcessId;
+}
+
 }; // namespace W32_proc
@@ -8,6 +8,7 @@
 /////////////////////////////////////////////////////////////////////////////
 
 #include "sc/proc/process.h"
+#include "sc/proc/ProcessBootstrap.h"
 
 #define SLOW_PROCESSING
 
@@ -15,11 +16,20 @@
 #include <windows.h>
 #include "sc/proc/W32Process.h"
 #else
+#include <vector>
+#include <cstring>
 #include <sys/time.h>
 #include <sys/resource.h>
 #include <errno.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/syscall.h>
 #define UNIX_PROC_PRIORITY_BACKGROUD 5
 #include "sc/dtypes.h"
+#include "sc/proc/LinuxProcess.h"
+#include "sc/proc/ProcessLauncher.h"
 #endif
 
 //wx
@@ -29,6 +39,10 @@
 #include "sc/DebugMem.h"
 #endif
 
+#ifndef WIN32
+extern char **environ;
+#endif
+
 namespace proc { 
 
 void setProcessPriorityAsBackgroud()
@@ -68,49 +82,209 @@ scProcessId getCurrentProcessId()
   return wxGetProcessId(); // wx
 }  
 
+unsigned long getCurrentThreadId()
+{
+#ifdef WIN32
+  return GetCurrentThreadId();
+#else
+  return static_cast<unsigned long>(syscall(SYS_gettid));
+#endif
+}
+
 scProcessId getParentProcessId(scProcessId processId)
 {
+#ifdef WIN32
   return W32_proc::GetParentProcessId(processId);
+#else
+  return Linux_proc::GetParentProcessId(processId);
+#endif
 }
 
 scProcessId getParentProcessId()
 {
+#ifdef WIN32
   return W32_proc::GetParentProcessId(GetCurrentProcessId());
+#else
+  return getppid();
+#endif
+}
+
+bool setProcessScheduling(scProcessId processId, const scSchedulingParams &params)
+{
+#ifdef WIN32
+  return W32_proc::SetProcessScheduling(processId, params);
+#else
+  return Linux_proc::SetProcessScheduling(processId, params);
+#endif
+}
+
+bool setThreadScheduling(unsigned long threadId, const scSchedulingParams &params)
+{
+#ifdef WIN32
+  return W32_proc::SetThreadScheduling(threadId, params);
+#else
+  return Linux_proc::SetThreadScheduling(threadId, params);
+#endif
 }
 
 bool processExists(scProcessId processId)
 {
+#ifdef WIN32
   return W32_proc::ProcessExists(processId);
+#else
+  return Linux_proc::ProcessExists(processId);
+#endif
 }
 
 void closeProcess(scProcessId processId)
 {
+#ifdef WIN32
   W32_proc::PostCloseApp(processId);
+#else
+  Linux_proc::PostCloseApp(processId);
+#endif
 }
 
 bool terminateProcess(scProcessId processId, unsigned long a_timeout)
 {
+#ifdef WIN32
   return ((W32_proc::TerminateAppShort(processId, a_timeout) & TA_SUCCESS_ANY) != 0);
+#else
+  return ((Linux_proc::TerminateAppShort(processId, a_timeout) & TA_SUCCESS_ANY) != 0);
+#endif
+}
+
+uint terminateProcesses(const std::vector<scProcessId> &pids, unsigned long a_timeout)
+{
+#ifdef WIN32
+  // processes are waited in turn, but for the time left to common deadline
+  uint res = 0;
+  DWORD startTime = GetTickCount();
+  for(std::vector<scProcessId>::const_iterator it = pids.begin(), epos = pids.end(); it != epos; ++it)
+  {
+    DWORD elapsed = GetTickCount() - startTime;
+    DWORD timeLeft = (elapsed < a_timeout)?(a_timeout - elapsed):0;
+    if ((W32_proc::TerminateAppShort(*it, timeLeft) & TA_SUCCESS_ANY) != 0)
+      ++res;
+  }
+  return res;
+#else
+  return Linux_proc::TerminateProcesses(pids, std::vector<unsigned long>(1, a_timeout), SC_NULL);
+#endif
+}
+
+uint terminateProcessTree(scProcessId processId, unsigned long a_timeout, scProcessTreeStats *stats)
+{
+#ifdef WIN32
+  DWORD startTime = GetTickCount();
+  std::vector<scProcessId> pids;
+  W32_proc::GetProcessTree(processId, pids);
+  uint res = terminateProcesses(pids, a_timeout);
+
+  if (stats != SC_NULL) {
+    stats->processCount = pids.size();
+    stats->terminatedCount = res;
+    stats->durationMs = GetTickCount() - startTime;
+    stats->cgroupUsed = false;
+  }
+  return res;
+#else
+  return Linux_proc::TerminateProcessTree(processId, a_timeout, stats);
+#endif
 }
 
 void closeProcessByExec(const scString &execPath, bool excludeCurrent)
 {
+#ifdef WIN32
   W32_proc::CloseProcessByExec(const_cast<char *>(execPath.c_str()), excludeCurrent);
+#else
+  Linux_proc::CloseProcessByExec(execPath.c_str(), excludeCurrent);
+#endif
 }
 
 bool terminateProcessByExec(const scString &execPath, bool excludeCurrent, unsigned long a_timeout)
 {
+#ifdef WIN32
   return W32_proc::TerminateAppByExec(const_cast<char *>(execPath.c_str()), excludeCurrent, a_timeout);
+#else
+  return Linux_proc::TerminateAppByExec(execPath.c_str(), excludeCurrent, a_timeout);
+#endif
 }
 
 unsigned int countProcessByExec(const scString &execPath, bool excludeCurrent)
 {
+#ifdef WIN32
   return W32_proc::CountProcessByExec(const_cast<char *>(execPath.c_str()), excludeCurrent);
+#else
+  return Linux_proc::CountProcessByExec(execPath.c_str(), excludeCurrent);
+#endif
 }
 
 unsigned int enumProcessByExec(const scString &execPath, bool excludeCurrent, scProcessEnumerator *enumProc)
 {
+#ifdef WIN32
   return W32_proc::EnumProcessByExec(const_cast<char *>(execPath.c_str()), excludeCurrent, enumProc);
+#else
+  return Linux_proc::EnumProcessByExec(execPath.c_str(), excludeCurrent, enumProc);
+#endif
+}
+
+scProcessId startProcess(const scString &command, const scString &params, bool minimized, bool lowPriority,
+  const scString &bootstrapName)
+{
+  scString envEntry;
+  if (!bootstrapName.empty())
+    envEntry = scString(SC_PROC_BOOTSTRAP_ENV) + "=" + bootstrapName;
+
+#ifdef WIN32
+  return W32_proc::StartApp(command.c_str(), params.c_str(), minimized, lowPriority,
+    envEntry.empty()?NULL:envEntry.c_str());
+#else
+  // no shell - parameters are passed as they are split, without expansion
+  std::vector<scString> args;
+  args.push_back(command);
+  scProcessLauncher::splitParams(params, args);
+
+  std::vector<char *> argv;
+  for(std::vector<scString>::iterator it = args.begin(), epos = args.end(); it != epos; ++it)
+    argv.push_back(const_cast<char *>(it->c_str()));
+  argv.push_back(SC_NULL);
+
+  // environment is prepared here - child of multithreaded process can call only async-signal-safe functions
+  std::vector<char *> envp;
+  char **envPtr = environ;
+  if (!envEntry.empty()) {
+    size_t nameLen = strlen(SC_PROC_BOOTSTRAP_ENV) + 1;
+    for(char **item = environ; (item != SC_NULL) && (*item != SC_NULL); ++item)
+      if (strncmp(*item, envEntry.c_str(), nameLen) != 0)
+        envp.push_back(*item);
+    envp.push_back(const_cast<char *>(envEntry.c_str()));
+    envp.push_back(SC_NULL);
+    envPtr = &envp[0];
+  }
+
+  posix_spawnattr_t attr;
+  posix_spawnattr_init(&attr);
+  sigset_t sigs;
+  sigemptyset(&sigs);
+  posix_spawnattr_setsigmask(&attr, &sigs);
+  sigaddset(&sigs, SIGPIPE);
+  sigaddset(&sigs, SIGCHLD);
+  posix_spawnattr_setsigdefault(&attr, &sigs);
+  posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+
+  pid_t pid = 0;
+  int err = posix_spawnp(&pid, command.c_str(), SC_NULL, &attr, &argv[0], envPtr);
+  posix_spawnattr_destroy(&attr);
+  if (err != 0)
+    return 0;
+
+  if (lowPriority)
+    setpriority(PRIO_PROCESS, pid, UNIX_PROC_PRIORITY_BACKGROUD);
+
+  // exit status is collected by processExists()
+  return pid;
+#endif
 }
 
 }; // namespace proc
@@ -0,0 +1,73 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        BenchTimer.h
+// Project:     scLib
+// Purpose:     Timing helpers for shared memory benchmarks
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SCSHMBENCHTIMER_H__
+#define _SCSHMBENCHTIMER_H__
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file BenchTimer.h
+/// \brief Timing helpers for shared memory benchmarks
+///
+/// Benchmarks in this directory are standalone programs, each one is built
+/// from its source file and the library sources it lists in its header.
+
+// ----------------------------------------------------------------------------
+// Headers
+// ----------------------------------------------------------------------------
+#include <vector>
+#include <algorithm>
+#include <boost/cstdint.hpp>
+
+#include "sc/dtypes.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+// ----------------------------------------------------------------------------
+// Functions
+// ----------------------------------------------------------------------------
+/// Returns monotonic time in ns
+inline boost::uint64_t benchNowNs()
+{
+#ifdef WIN32
+  LARGE_INTEGER freq, counter;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&counter);
+  return static_cast<boost::uint64_t>(counter.QuadPart * 1000000000.0 / freq.QuadPart);
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<boost::uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+/// Returns percentile (0 - 100) of samples, sorts samples
+inline double benchPercentile(std::vector<double> &samples, double percent)
+{
+  if (samples.empty())
+    return 0.0;
+  std::sort(samples.begin(), samples.end());
+  size_t pos = static_cast<size_t>(percent / 100.0 * (samples.size() - 1) + 0.5);
+  return samples[SC_MIN(pos, samples.size() - 1)];
+}
+
+inline double benchMean(const std::vector<double> &samples)
+{
+  double sum = 0.0;
+  for(std::vector<double>::const_iterator it = samples.begin(), epos = samples.end(); it != epos; ++it)
+    sum += *it;
+  return samples.empty()?0.0:sum / samples.size();
+}
+
+#endif // _SCSHMBENCHTIMER_H__
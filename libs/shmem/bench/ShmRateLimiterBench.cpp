@@ -0,0 +1,160 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        ShmRateLimiterBench.cpp
+// Project:     scLib
+// Purpose:     Cost of acquire on shared rate limiter
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file ShmRateLimiterBench.cpp
+/// \brief Cost of acquire on shared rate limiter (POSIX)
+///
+/// Measures time of scShmRateLimiter::acquire with 1 process and with up to
+/// 32 processes hammering one bucket at the same time, for a plain bucket
+/// and for bucket with a parent. Target is below 100 ns per acquire.
+/// Each process times batches of acquires, reported are mean and p99 of
+/// per-acquire time over all batches and fraction of granted acquires.
+///
+/// Build together with library sources: SharedRateLimiter.cpp,
+/// SharedMemory.cpp and SharedMemoryWarmer.cpp.
+///
+/// Usage: ShmRateLimiterBench [processCount=32] [acquiresPerProcess=1000000]
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "sc/proc/SharedRateLimiter.h"
+#include "BenchTimer.h"
+
+// ----------------------------------------------------------------------------
+// Private declarations
+// ----------------------------------------------------------------------------
+const uint BENCH_BATCH_SIZE = 1000;
+const char *BENCH_LIMITER_PATH = "sc_rate_bench";
+/// processes start together this long after they were forked
+const boost::uint64_t BENCH_START_DELAY_NS = 200000000ULL;
+
+struct BenchWorkerResult {
+  boost::uint64_t granted;
+  boost::uint64_t batchCount;
+};
+
+// ----------------------------------------------------------------------------
+// Private functions
+// ----------------------------------------------------------------------------
+static void runWorker(const char *bucketName, uint acquireCount, boost::uint64_t startTime, int resultFd)
+{
+  scShmRateLimiter limiter(BENCH_LIMITER_PATH);
+  scShmBucketId bucket = limiter.findBucket(bucketName);
+  uint batchCount = acquireCount / BENCH_BATCH_SIZE;
+  std::vector<double> batchNs(batchCount);
+  BenchWorkerResult result;
+  result.granted = 0;
+  result.batchCount = batchCount;
+
+  while(benchNowNs() < startTime)
+    ;
+
+  for(uint b = 0; b < batchCount; b++)
+  {
+    boost::uint64_t start = benchNowNs();
+    for(uint i = 0; i < BENCH_BATCH_SIZE; i++)
+      if (limiter.acquire(bucket, 1))
+        result.granted++;
+    batchNs[b] = static_cast<double>(benchNowNs() - start) / BENCH_BATCH_SIZE;
+  }
+
+  bool ok = (write(resultFd, &result, sizeof(result)) == static_cast<ssize_t>(sizeof(result)));
+  if (ok && (batchCount > 0))
+    ok = (write(resultFd, &batchNs[0], batchCount * sizeof(double)) == static_cast<ssize_t>(batchCount * sizeof(double)));
+  _exit(ok?0:1);
+}
+
+static bool readAll(int fd, void *output, size_t size)
+{
+  char *cptr = static_cast<char *>(output);
+  while(size > 0) {
+    ssize_t res = read(fd, cptr, size);
+    if (res <= 0)
+      return false;
+    cptr += res;
+    size -= static_cast<size_t>(res);
+  }
+  return true;
+}
+
+static void runScenario(const char *title, const char *bucketName, uint processCount, uint acquireCount)
+{
+  std::vector<pid_t> pids(processCount);
+  std::vector<int> resultFds(processCount);
+  boost::uint64_t startTime = benchNowNs() + BENCH_START_DELAY_NS;
+
+  for(uint p = 0; p < processCount; p++)
+  {
+    int fds[2];
+    if (pipe(fds) != 0) {
+      perror("pipe");
+      exit(1);
+    }
+    pids[p] = fork();
+    if (pids[p] == 0) {
+      close(fds[0]);
+      runWorker(bucketName, acquireCount, startTime, fds[1]);
+    }
+    close(fds[1]);
+    resultFds[p] = fds[0];
+  }
+
+  std::vector<double> batchNs;
+  boost::uint64_t granted = 0, total = 0;
+  for(uint p = 0; p < processCount; p++)
+  {
+    BenchWorkerResult result;
+    if (readAll(resultFds[p], &result, sizeof(result))) {
+      std::vector<double> workerNs(static_cast<size_t>(result.batchCount));
+      if (!workerNs.empty() && readAll(resultFds[p], &workerNs[0], workerNs.size() * sizeof(double)))
+        batchNs.insert(batchNs.end(), workerNs.begin(), workerNs.end());
+      granted += result.granted;
+      total += result.batchCount * BENCH_BATCH_SIZE;
+    }
+    close(resultFds[p]);
+    waitpid(pids[p], SC_NULL, 0);
+  }
+
+  double meanNs = benchMean(batchNs);
+  double p99Ns = benchPercentile(batchNs, 99);
+  printf("%-24s %9u %10.1fns %10.1fns %9.1f%%\n", title, processCount, meanNs, p99Ns,
+    (total > 0)?100.0 * granted / total:0.0);
+}
+
+// ----------------------------------------------------------------------------
+// Main
+// ----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  uint processCount = (argc > 1)?static_cast<uint>(atoi(argv[1])):32;
+  uint acquireCount = (argc > 2)?static_cast<uint>(atoi(argv[2])):1000000;
+
+  scShmRateLimiter limiter(BENCH_LIMITER_PATH, scsmOwner | scsmCreate, 8);
+  // rates high enough that most of acquires are granted and CAS path is measured
+  limiter.addBucket("global", 1.0e9, 1000000);
+  limiter.addBucket("plain", 1.0e9, 1000000);
+  limiter.addBucket("child", 1.0e9, 1000000, "global");
+
+  printf("%-24s %9s %12s %12s %10s\n", "scenario", "processes", "mean", "p99", "granted");
+  runScenario("plain bucket", "plain", 1, acquireCount);
+  runScenario("plain bucket", "plain", processCount, acquireCount);
+  runScenario("bucket with parent", "child", 1, acquireCount);
+  runScenario("bucket with parent", "child", processCount, acquireCount);
+
+  return 0;
+}
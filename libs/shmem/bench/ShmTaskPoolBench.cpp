@@ -0,0 +1,181 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        ShmTaskPoolBench.cpp
+// Project:     scLib
+// Purpose:     Throughput and load balance of shared task pool
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file ShmTaskPoolBench.cpp
+/// \brief Throughput and load balance of shared task pool (POSIX)
+///
+/// Starts 2 - 64 worker processes, submits jobs with skewed duration (most
+/// of them short, every tenth one long) in bursts to a single inbox, so
+/// workers have to steal to stay busy. Reports jobs per second, busy time
+/// of least and most loaded worker and imbalance (max / mean busy time).
+///
+/// Build together with library sources: SharedTaskPool.cpp,
+/// SharedMemory.cpp and SharedMemoryWarmer.cpp.
+///
+/// Usage: ShmTaskPoolBench [jobCount=20000] [maxWorkers=64]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "sc/proc/SharedTaskPool.h"
+#include "BenchTimer.h"
+
+// ----------------------------------------------------------------------------
+// Private declarations
+// ----------------------------------------------------------------------------
+const uint BENCH_SHORT_JOB_US = 5;
+const uint BENCH_LONG_JOB_US = 200;
+/// every n-th job is a long one
+const uint BENCH_LONG_JOB_EVERY = 10;
+const uint BENCH_QUEUE_CAPACITY = 1024;
+const uint BENCH_PAYLOAD_COUNT = 4096;
+const char *BENCH_POOL_PATH = "sc_pool_bench";
+
+struct BenchJob {
+  boost::uint32_t costUs;
+  boost::uint32_t stop;
+};
+
+class BenchJobRunner: public scShmWinConsumerIntf {
+public:
+  BenchJobRunner(): scShmWinConsumerIntf(), m_busyNs(0), m_stopped(false) {}
+
+  virtual void process(const char *data, size_t size)
+  {
+    BenchJob job;
+    if (size < sizeof(job))
+      return;
+    std::memcpy(&job, data, sizeof(job));
+    if (job.stop != 0) {
+      m_stopped = true;
+      return;
+    }
+
+    boost::uint64_t start = benchNowNs();
+    boost::uint64_t end = start + job.costUs * 1000ULL;
+    boost::uint64_t now;
+    do {
+      now = benchNowNs();
+    } while(now < end);
+    m_busyNs += now - start;
+  }
+
+  boost::uint64_t getBusyNs() const { return m_busyNs; }
+  bool isStopped() const { return m_stopped; }
+private:
+  boost::uint64_t m_busyNs;
+  bool m_stopped;
+};
+
+// ----------------------------------------------------------------------------
+// Private functions
+// ----------------------------------------------------------------------------
+static void runWorker(uint workerNo, int resultFd)
+{
+  scShmTaskPool pool(BENCH_POOL_PATH);
+  BenchJobRunner runner;
+  while(!runner.isStopped())
+    pool.runNext(workerNo, &runner, 100);
+
+  boost::uint64_t busyNs = runner.getBusyNs();
+  ssize_t res = write(resultFd, &busyNs, sizeof(busyNs));
+  _exit((res == static_cast<ssize_t>(sizeof(busyNs)))?0:1);
+}
+
+static void submitJob(scShmTaskPool &pool, const BenchJob &job, uint workerNo)
+{
+  while(!pool.submit(&job, sizeof(job), workerNo))
+    usleep(10);
+}
+
+static void runConfig(uint workerCount, uint jobCount)
+{
+  scShmTaskPool pool(BENCH_POOL_PATH, scsmOwner | scsmCreate, workerCount, BENCH_QUEUE_CAPACITY,
+    sizeof(BenchJob), BENCH_PAYLOAD_COUNT);
+
+  std::vector<pid_t> pids(workerCount);
+  std::vector<int> resultFds(workerCount);
+  for(uint w = 0; w < workerCount; w++)
+  {
+    int fds[2];
+    if (pipe(fds) != 0) {
+      perror("pipe");
+      exit(1);
+    }
+    pids[w] = fork();
+    if (pids[w] == 0) {
+      close(fds[0]);
+      runWorker(w, fds[1]);
+    }
+    close(fds[1]);
+    resultFds[w] = fds[0];
+  }
+
+  BenchJob job;
+  job.stop = 0;
+  boost::uint64_t start = benchNowNs();
+  for(uint i = 0; i < jobCount; i++)
+  {
+    job.costUs = ((i % BENCH_LONG_JOB_EVERY) == 0)?BENCH_LONG_JOB_US:BENCH_SHORT_JOB_US;
+    // bursts of jobs land in one inbox, the rest of workers has to steal
+    submitJob(pool, job, (i / BENCH_QUEUE_CAPACITY) % workerCount);
+  }
+
+  job.stop = 1;
+  for(uint w = 0; w < workerCount; w++)
+    submitJob(pool, job, w);
+
+  std::vector<double> busyMs;
+  for(uint w = 0; w < workerCount; w++)
+  {
+    boost::uint64_t busyNs = 0;
+    if (read(resultFds[w], &busyNs, sizeof(busyNs)) != static_cast<ssize_t>(sizeof(busyNs)))
+      busyNs = 0;
+    close(resultFds[w]);
+    waitpid(pids[w], SC_NULL, 0);
+    busyMs.push_back(busyNs / 1000000.0);
+  }
+  double elapsedSec = (benchNowNs() - start) / 1000000000.0;
+
+  uint stolen = 0;
+  for(uint w = 0; w < workerCount; w++)
+    stolen += pool.getStolenCount(w);
+
+  double meanMs = benchMean(busyMs);
+  double minMs = benchPercentile(busyMs, 0);
+  double maxMs = benchPercentile(busyMs, 100);
+  printf("%8u %12.0f %10.1fms %10.1fms %10.2f %10u\n", workerCount, jobCount / elapsedSec, minMs, maxMs,
+    (meanMs > 0.0)?maxMs / meanMs:0.0, stolen);
+}
+
+// ----------------------------------------------------------------------------
+// Main
+// ----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  uint jobCount = (argc > 1)?static_cast<uint>(atoi(argv[1])):20000;
+  uint maxWorkers = (argc > 2)?static_cast<uint>(atoi(argv[2])):64;
+
+  printf("jobs: %u, %uus / %uus every %u\n", jobCount, BENCH_SHORT_JOB_US, BENCH_LONG_JOB_US, BENCH_LONG_JOB_EVERY);
+  printf("%8s %12s %12s %12s %10s %10s\n", "workers", "jobs/s", "min busy", "max busy", "imbalance", "stolen");
+
+  for(uint workerCount = 2; workerCount <= maxWorkers; workerCount *= 2)
+    runConfig(workerCount, jobCount);
+
+  return 0;
+}
@@ -0,0 +1,86 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        ShmTraceReplay.cpp
+// Project:     scLib
+// Purpose:     Replays recorded shared memory traces, prints latency report
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file ShmTraceReplay.cpp
+/// \brief Replays recorded shared memory traces, prints latency report
+///
+/// Driver for scShmTraceReplayer: loads trace files written by
+/// scShmTraceRecorder (one per recorded process), replays them on blocks
+/// with given prefix and prints replay and original latency percentiles.
+///
+/// Build together with library sources: SharedMemoryTrace.cpp,
+/// SharedMemoryBlock.cpp, SharedMemory.cpp, SharedMemoryWindow.cpp,
+/// SharedMemoryWarmer.cpp, SharedMemorySnapshot.cpp and SharedResource.cpp.
+///
+/// Usage: ShmTraceReplay [-s speed] [-p blockPrefix] trace...
+///   speed: 1 - original timing (default), 10 - ten times faster,
+///          0 - as fast as possible
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+
+#include "sc/proc/SharedResource.h"
+#include "sc/proc/SharedMemoryTrace.h"
+
+// ----------------------------------------------------------------------------
+// Private functions
+// ----------------------------------------------------------------------------
+static int usage(const char *programName)
+{
+  fprintf(stderr, "Usage: %s [-s speed] [-p blockPrefix] trace...\n", programName);
+  return 2;
+}
+
+// ----------------------------------------------------------------------------
+// Main
+// ----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  double speed = 1.0;
+  scString prefix("replay_");
+  int argNo = 1;
+
+  for(; argNo < argc; argNo++)
+  {
+    if ((std::strcmp(argv[argNo], "-s") == 0) && (argNo + 1 < argc))
+      speed = atof(argv[++argNo]);
+    else if ((std::strcmp(argv[argNo], "-p") == 0) && (argNo + 1 < argc))
+      prefix = argv[++argNo];
+    else if (argv[argNo][0] == '-')
+      return usage(argv[0]);
+    else
+      break;
+  }
+
+  if (argNo >= argc)
+    return usage(argv[0]);
+
+  try {
+    scSharedResourceManager manager;
+    scShmTraceReplayer replayer(prefix);
+    for(; argNo < argc; argNo++)
+      replayer.addTrace(argv[argNo]);
+    replayer.setSpeed(speed);
+
+    printf("processes: %u, speed: %g\n", replayer.getProcessCount(), speed);
+    replayer.run();
+    printf("%s", replayer.getReport().c_str());
+  }
+  catch(std::exception &e) {
+    fprintf(stderr, "Replay failed: %s\n", e.what());
+    return 1;
+  }
+
+  return 0;
+}
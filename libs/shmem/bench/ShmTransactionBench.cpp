@@ -0,0 +1,114 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        ShmTransactionBench.cpp
+// Project:     scLib
+// Purpose:     Commit latency of multi-block transactions
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file ShmTransactionBench.cpp
+/// \brief Commit latency of multi-block transactions
+///
+/// For 1 - 64 blocks touched per transaction measures latency of
+/// scShmTransaction::commit() (staged data is applied and commit record is
+/// bumped) and compares it with the same data written by independent
+/// scSharedMemoryBlock::write calls.
+///
+/// Build together with library sources: SharedMemoryTransaction.cpp,
+/// SharedMemoryBlock.cpp, SharedMemory.cpp, SharedMemoryWindow.cpp,
+/// SharedMemoryWarmer.cpp, SharedMemoryTrace.cpp, SharedMemorySnapshot.cpp
+/// and SharedResource.cpp.
+///
+/// Usage: ShmTransactionBench [iterations=2000] [blockSize=4096]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "sc/proc/SharedResource.h"
+#include "sc/proc/SharedMemoryBlock.h"
+#include "sc/proc/SharedMemoryTransaction.h"
+#include "BenchTimer.h"
+
+// ----------------------------------------------------------------------------
+// Private declarations
+// ----------------------------------------------------------------------------
+const uint BENCH_MAX_BLOCKS = 64;
+
+class BenchFillWriter: public scShmWinWriterIntf {
+public:
+  BenchFillWriter(): scShmWinWriterIntf(), m_value(0) {}
+  void setValue(char value) { m_value = value; }
+
+  virtual size_t write(char *output, size_t outputSize)
+  {
+    std::memset(output, m_value, outputSize);
+    return outputSize;
+  }
+private:
+  char m_value;
+};
+
+// ----------------------------------------------------------------------------
+// Main
+// ----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  uint iterations = (argc > 1)?static_cast<uint>(atoi(argv[1])):2000;
+  size_t blockSize = (argc > 2)?static_cast<size_t>(atoi(argv[2])):4096;
+
+  scSharedResourceManager manager;
+  std::vector<scShmBlockHandle> handles;
+  char path[64];
+  for(uint i = 0; i < BENCH_MAX_BLOCKS; i++)
+  {
+    snprintf(path, sizeof(path), "sc_trans_bench_%u", i);
+    scSharedMemoryBlock block(path, blockSize);
+    block.create();
+    handles.push_back(scSharedMemoryBlock::intern(path, blockSize));
+  }
+
+  scShmCommitRecord record("sc_trans_bench_commit", scsmOwner | scsmCreate);
+  BenchFillWriter writer;
+  std::vector<double> commitUs, plainUs;
+
+  printf("iterations: %u, block size: %lu\n", iterations, static_cast<unsigned long>(blockSize));
+  printf("%8s %12s %12s %12s %12s\n", "blocks", "commit p50", "commit p99", "commit mean", "plain mean");
+
+  for(uint blockCount = 1; blockCount <= BENCH_MAX_BLOCKS; blockCount *= 2)
+  {
+    commitUs.clear();
+    plainUs.clear();
+
+    for(uint iter = 0; iter < iterations; iter++)
+    {
+      writer.setValue(static_cast<char>(iter));
+
+      scShmTransaction trans(record);
+      for(uint i = 0; i < blockCount; i++)
+        trans.write(handles[i], &writer, 0, blockSize);
+
+      boost::uint64_t start = benchNowNs();
+      trans.commit();
+      commitUs.push_back((benchNowNs() - start) / 1000.0);
+
+      start = benchNowNs();
+      for(uint i = 0; i < blockCount; i++)
+        scSharedMemoryBlock::write(handles[i], &writer, 0, blockSize);
+      plainUs.push_back((benchNowNs() - start) / 1000.0);
+    }
+
+    double commitMean = benchMean(commitUs);
+    double plainMean = benchMean(plainUs);
+    double commitP50 = benchPercentile(commitUs, 50);
+    double commitP99 = benchPercentile(commitUs, 99);
+    printf("%8u %10.2fus %10.2fus %10.2fus %10.2fus\n", blockCount, commitP50, commitP99, commitMean, plainMean);
+  }
+
+  return 0;
+}
@@ -0,0 +1,107 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        AnonSharedMemory.h
+// Project:     scLib
+// Purpose:     Anonymous shared memory passed by descriptor
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SCANONSHMEM_H__
+#define _SCANONSHMEM_H__
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file AnonSharedMemory.h
+///
+/// \brief Anonymous shared memory passed by descriptor
+///
+/// Memory block without global name (Linux memfd). Other processes get
+/// access by receiving the descriptor over Unix socket (SCM_RIGHTS) or by
+/// inheriting it. Block can be sealed, sealed size guarantees that readers
+/// can access the whole mapping without bounds checking.
+///
+/// Can be registered as scSharedMemoryBlock under any process-local path.
+///
+/// Usage:
+/// \code
+///     // Server
+///     //-----------------------------------------------
+///     std::auto_ptr<scAnonSharedMemory> mem(new scAnonSharedMemory("table", tableSize));
+///     fillTable(mem->getAddress());
+///     mem->seal(scsmSealShrink | scsmSealGrow | scsmSealWrite);
+///     mem->sendTo(clientSocket);
+///
+///     // Client
+///     //-----------------------------------------------
+///     std::auto_ptr<scAnonSharedMemory> mem(scAnonSharedMemory::receiveFrom(serverSocket, scsmReadOnly));
+///     scSharedMemoryBlock block("table", mem->getSize());
+///     block.registerBlock(scSharedMemoryBlock::shbat_read_only, mem.release(), true);
+/// \endcode
+
+// ----------------------------------------------------------------------------
+// Headers
+// ----------------------------------------------------------------------------
+#include "sc/proc/SharedMemory.h"
+
+// ----------------------------------------------------------------------------
+// Simple type definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Forward class definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Constants
+// ----------------------------------------------------------------------------
+enum scsmSealFlag {
+  scsmSealShrink = 1,
+  scsmSealGrow = 2,
+  scsmSealWrite = 4,
+  scsmSealSeal = 8   // no more seals can be added
+};
+
+// ----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+class scAnonSharedMemory: public scSharedMemory {
+public:
+  /// Creates new read-write block
+  /// \param[in] a_name name used for diagnostics only
+  scAnonSharedMemory(const scString &a_name, size_t a_size);
+  /// Attaches to block using received or inherited descriptor, takes ownership of descriptor
+  scAnonSharedMemory(int a_fd, scsmAccessMode accessMode);
+  virtual ~scAnonSharedMemory();
+  virtual scString getKeyName();
+  virtual void *getAddress();
+
+  /// Returns descriptor of block
+  int getHandle();
+  /// Adds seals (scsmSealFlag), sealing for write remaps block as read-only
+  /// at the same address
+  void seal(uint sealFlags);
+  uint getSeals();
+  bool isSealed(uint sealFlags);
+  /// Specifies if descriptor should be inherited by child processes
+  void setInheritable(bool value);
+
+  /// Sends descriptor to peer over connected Unix socket
+  void sendTo(int socketFd);
+  /// Receives block sent by sendTo, caller takes ownership of result
+  static scAnonSharedMemory *receiveFrom(int socketFd, scsmAccessMode accessMode);
+protected:
+  virtual void freeResource();
+  void mapMemory();
+  void unmapMemory();
+  /// Replaces mapping with one of given access at the same address
+  void remapInPlace(bool writable);
+  void closeHandle();
+private:
+  int m_fd;
+  void *m_address;
+};
+
+#endif // _SCANONSHMEM_H__
@@ -0,0 +1,146 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        SharedBlockParallelReader.h
+// Project:     scLib
+// Purpose:     Parallel chunked processing of shared block payload
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SCSHPARREAD_H__
+#define _SCSHPARREAD_H__
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file SharedBlockParallelReader.h
+///
+/// \brief Parallel chunked processing of shared block payload
+///
+/// Payload is split into chunks aligned to page size (and optionally moved
+/// to record boundaries by scShmChunkBoundaryIntf). Chunks are taken by
+/// threads of a pool, each thread feeds them to its own consumer instance.
+/// When all chunks are processed, worker consumers are passed to reduce()
+/// in worker order on the calling thread.
+///
+/// Usage:
+/// \code
+///     class LineCounter: public scShmParallelConsumerIntf {
+///       scShmWinConsumerIntf *createWorkerConsumer(uint workerNo) { return new LineCountWorker(); }
+///       void reduce(uint workerNo, scShmWinConsumerIntf *worker) { m_total += ((LineCountWorker *)worker)->count(); }
+///     };
+///
+///     scShmParallelReader reader(8);
+///     reader.setBoundary(&lineBoundary);
+///     reader.read(block, &lineCounter);
+/// \endcode
+
+// ----------------------------------------------------------------------------
+// Headers
+// ----------------------------------------------------------------------------
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/interprocess/sync/interprocess_mutex.hpp>
+#include <boost/interprocess/sync/interprocess_condition.hpp>
+#include "boost/ptr_container/ptr_vector.hpp"
+
+#include "sc/dtypes.h"
+#include "sc/proc/SharedMemoryBlock.h"
+
+// ----------------------------------------------------------------------------
+// Simple type definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Forward class definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Constants
+// ----------------------------------------------------------------------------
+const size_t SC_SHM_PAR_DEF_CHUNK_SIZE = 4 * 1024 * 1024;
+
+// ----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+/// Creates consumer for each worker and combines their results
+class scShmParallelConsumerIntf {
+public:
+  scShmParallelConsumerIntf() {}
+  virtual ~scShmParallelConsumerIntf() {}
+  /// Called on calling thread before processing, reader takes ownership of result
+  virtual scShmWinConsumerIntf *createWorkerConsumer(uint workerNo) = 0;
+  /// Called on calling thread after all chunks are processed
+  virtual void reduce(uint workerNo, scShmWinConsumerIntf *workerConsumer) = 0;
+};
+
+/// Moves chunk end to record boundary
+class scShmChunkBoundaryIntf {
+public:
+  scShmChunkBoundaryIntf() {}
+  virtual ~scShmChunkBoundaryIntf() {}
+  /// Returns position of first record boundary at or after pos, size if there is none
+  virtual size_t findBoundary(const char *data, size_t size, size_t pos) = 0;
+};
+
+class scShmParallelReader {
+public:
+  /// \param[in] threadCount number of workers, including calling thread
+  scShmParallelReader(uint threadCount);
+  virtual ~scShmParallelReader();
+
+  void setChunkSize(size_t value);
+  void setBoundary(scShmChunkBoundaryIntf *boundary);
+  uint getThreadCount() const;
+
+  /// Processes block payload in parallel
+  bool read(scSharedMemoryBlock &block, scShmParallelConsumerIntf *consumer);
+  bool read(scSharedMemoryBlock &block, scShmParallelConsumerIntf *consumer, size_t aOffset, size_t aLimit);
+  bool read(scShmBlockHandle handle, scShmParallelConsumerIntf *consumer);
+  /// Processes any memory range in parallel
+  void process(const char *data, size_t size, scShmParallelConsumerIntf *consumer);
+protected:
+  struct Chunk {
+    size_t offset;
+    size_t size;
+  };
+  void splitChunks(const char *data, size_t size);
+  void runWorker(uint workerNo);
+  void workerLoop(uint workerNo);
+#ifdef WIN32
+  static unsigned long __stdcall workerEntry(void *arg);
+#else
+  static void *workerEntry(void *arg);
+#endif
+private:
+  scShmParallelReader(const scShmParallelReader &);
+  scShmParallelReader &operator=(const scShmParallelReader &);
+private:
+  struct WorkerArg {
+    scShmParallelReader *reader;
+    uint workerNo;
+  };
+  uint m_threadCount;
+  size_t m_chunkSize;
+  scShmChunkBoundaryIntf *m_boundary;
+  std::vector<void *> m_threads;
+  std::vector<WorkerArg> m_workerArgs;
+
+  // current job, guarded by m_mutex
+  boost::interprocess::interprocess_mutex m_mutex;
+  boost::interprocess::interprocess_condition m_jobReady;
+  boost::interprocess::interprocess_condition m_jobDone;
+  uint m_jobSeq;
+  uint m_jobWorkerCount;
+  uint m_runningCount;
+  bool m_stop;
+  const char *m_data;
+  std::vector<Chunk> m_chunks;
+  volatile boost::uint32_t m_nextChunk;
+  boost::ptr_vector<scShmWinConsumerIntf> m_consumers;
+  bool m_failed;
+  scString m_errorMsg;
+};
+
+#endif // _SCSHPARREAD_H__
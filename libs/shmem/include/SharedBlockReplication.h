@@ -0,0 +1,227 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        SharedBlockReplication.h
+// Project:     scLib
+// Purpose:     Replication of shared memory blocks to another host over TCP
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SCSHREPL_H__
+#define _SCSHREPL_H__
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file SharedBlockReplication.h
+///
+/// \brief Replication of shared memory blocks to another host over TCP
+///
+/// Sender watches a group of blocks updated through scShmCommitRecord.
+/// When commit count changes, it compares chunk checksums with the ones
+/// sent before and streams only changed chunks, in batches of limited size.
+/// Several versions can be in flight before receiver acknowledges them,
+/// memory use is limited by batch size and one checksum per chunk.
+/// Receiver stages chunks of a version in local memory and applies them to
+/// local blocks of the same names inside its own commit when commit frame
+/// arrives, so local readers see only complete versions and never wait for
+/// network. Staging memory is limited by maxStageSize: version with more
+/// changes (usually contents of all blocks right after connect) is written
+/// to local blocks as it arrives, inside a local commit left open until its
+/// commit frame, so readers wait for network during such version. If
+/// connection breaks in the middle of it, the commit is closed with partial
+/// data, next connection sends all blocks again.
+/// Frames are validated: block names are limited to SC_SHM_REPL_MAX_NAME_LEN,
+/// block sizes to maxBlockSize and chunks must lie inside their block.
+/// Existing local blocks are reused, never recreated.
+/// Both hosts must have the same byte order.
+///
+/// Usage:
+/// \code
+///     // target host
+///     scShmReplicationReceiver receiver("index_commit");
+///     receiver.listen("0.0.0.0", 7010);
+///     receiver.accept(0);
+///     while (receiver.receive(100))
+///       ;
+///
+///     // source host
+///     scShmReplicationSender sender("index_commit");
+///     sender.addBlock("index", indexSize);
+///     sender.addBlock("data", dataSize);
+///     sender.connect("10.0.0.2", 7010);
+///     while (running) {
+///       sender.replicate();
+///       reportLag(sender.getLagMs());
+///     }
+/// \endcode
+
+// ----------------------------------------------------------------------------
+// Headers
+// ----------------------------------------------------------------------------
+#include <memory>
+#include <vector>
+#include <deque>
+#include <map>
+#include <boost/cstdint.hpp>
+#include "boost/ptr_container/ptr_vector.hpp"
+
+#include "sc/dtypes.h"
+#include "sc/proc/SharedMemory.h"
+#include "sc/proc/SharedMemoryTransaction.h"
+
+// ----------------------------------------------------------------------------
+// Simple type definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Forward class definitions
+// ----------------------------------------------------------------------------
+struct scShmReplConnection;
+
+// ----------------------------------------------------------------------------
+// Constants
+// ----------------------------------------------------------------------------
+const size_t SC_SHM_REPL_DEF_CHUNK_SIZE = 64 * 1024;
+const size_t SC_SHM_REPL_DEF_BATCH_SIZE = 1024 * 1024;
+const uint SC_SHM_REPL_DEF_IN_FLIGHT = 8;
+const size_t SC_SHM_REPL_DEF_MAX_STAGE_SIZE = 64 * 1024 * 1024;
+const size_t SC_SHM_REPL_DEF_MAX_BLOCK_SIZE = 1024 * 1024 * 1024;
+const size_t SC_SHM_REPL_MAX_NAME_LEN = 1024;
+
+// ----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+/// Streams changes of blocks to receiver
+class scShmReplicationSender {
+public:
+  /// \param[in] commitPath commit record guarding replicated blocks
+  /// \param[in] maxInFlight number of versions sent but not acknowledged
+  scShmReplicationSender(const scString &commitPath, size_t chunkSize = SC_SHM_REPL_DEF_CHUNK_SIZE,
+    size_t batchSize = SC_SHM_REPL_DEF_BATCH_SIZE, uint maxInFlight = SC_SHM_REPL_DEF_IN_FLIGHT);
+  virtual ~scShmReplicationSender();
+
+  void addBlock(const scString &path, size_t size);
+  void connect(const scString &host, uint port);
+  void disconnect();
+  bool isConnected() const;
+
+  /// Sends current version if it was not sent yet, processes acknowledgements
+  /// \return Returns true if new version was sent
+  bool replicate();
+
+  /// Returns last version (commit count) seen on source
+  scShmCommitSeq getSourceVersion() const;
+  /// Returns last version applied by receiver
+  scShmCommitSeq getAckedVersion() const;
+  /// Returns number of versions not yet applied by receiver
+  scShmCommitSeq getVersionLag() const;
+  /// Returns age of oldest version not applied by receiver, 0 if there is none
+  uint getLagMs() const;
+  boost::uint64_t getSentBytes() const;
+protected:
+  struct ReplBlock {
+    scString path;
+    size_t size;
+    std::auto_ptr<scSharedMemory> memory;
+    std::vector<boost::uint64_t> checksums;
+  };
+  struct InFlightVersion {
+    scShmCommitSeq version;
+    boost::uint64_t observedTime;
+  };
+  typedef boost::ptr_vector<ReplBlock> ReplBlockColn;
+
+  void sendBlockList();
+  void sendVersion();
+  bool sendChanges(uint blockNo);
+  void readAcks(uint timeoutMs);
+  void appendFrame(boost::uint32_t type, boost::uint32_t blockNo, boost::uint64_t offset, boost::uint64_t value,
+    const void *data, size_t dataSize);
+  void flush();
+private:
+  scShmReplicationSender(const scShmReplicationSender &);
+  scShmReplicationSender &operator=(const scShmReplicationSender &);
+private:
+  scShmCommitRecord m_record;
+  size_t m_chunkSize;
+  size_t m_batchSize;
+  uint m_maxInFlight;
+  ReplBlockColn m_blocks;
+  std::auto_ptr<scShmReplConnection> m_connection;
+  std::vector<char> m_sendBuffer;
+  std::vector<char> m_recvBuffer;
+  std::deque<InFlightVersion> m_inFlight;
+  scShmCommitSeq m_sourceVersion;
+  scShmCommitSeq m_sentVersion;
+  scShmCommitSeq m_ackedVersion;
+  bool m_versionSent;
+  boost::uint64_t m_sentBytes;
+};
+
+/// Applies changes received from sender to local blocks
+class scShmReplicationReceiver {
+public:
+  /// \param[in] commitPath local commit record, created by receiver
+  /// \param[in] blockPrefix prefix added to names of local blocks (e.g. for testing on one host)
+  /// \param[in] maxStageSize limit of staged data of one version
+  /// \param[in] maxBlockSize blocks announced by sender cannot be larger
+  scShmReplicationReceiver(const scString &commitPath, const scString &blockPrefix = scString(""),
+    size_t maxStageSize = SC_SHM_REPL_DEF_MAX_STAGE_SIZE, size_t maxBlockSize = SC_SHM_REPL_DEF_MAX_BLOCK_SIZE);
+  virtual ~scShmReplicationReceiver();
+
+  /// Starts listening, port 0 selects free port
+  /// \return Returns port number
+  uint listen(const scString &host, uint port);
+  /// Waits for sender, timeout 0 means infinite
+  /// \return Returns false on timeout
+  bool accept(uint timeoutMs);
+  /// Receives and applies available data
+  /// \return Returns false if sender closed connection
+  bool receive(uint timeoutMs);
+  void close();
+
+  scShmCommitSeq getAppliedVersion() const;
+  boost::uint64_t getReceivedBytes() const;
+protected:
+  struct StagedChunk {
+    uint blockNo;
+    size_t offset;
+    size_t size;
+    size_t bufferPos;
+  };
+
+  bool processFrame();
+  void openBlock(uint blockNo, const scString &name, size_t size);
+  /// Receives chunk into staging buffer, or into block when version is too large
+  bool stageChunk(uint blockNo, boost::uint64_t offset, boost::uint64_t size);
+  /// Opens local commit for version larger than staging limit, applies staged chunks
+  void beginDirectVersion();
+  void applyStaged();
+  /// Applies staged chunks in a single local commit
+  void applyVersion(scShmCommitSeq version);
+  scSharedMemory *findBlock(uint blockNo);
+  void releaseMemory(scSharedMemory *memory);
+private:
+  scShmReplicationReceiver(const scShmReplicationReceiver &);
+  scShmReplicationReceiver &operator=(const scShmReplicationReceiver &);
+private:
+  typedef std::map<uint, scSharedMemory *> BlockMap;
+  scShmCommitRecord m_record;
+  scString m_blockPrefix;
+  std::auto_ptr<scShmReplConnection> m_listener;
+  std::auto_ptr<scShmReplConnection> m_connection;
+  BlockMap m_blocks;
+  boost::ptr_vector<scSharedMemory> m_memories;
+  std::vector<StagedChunk> m_stagedChunks;
+  std::vector<char> m_stageBuffer;
+  size_t m_maxStageSize;
+  size_t m_maxBlockSize;
+  /// local commit is open, chunks are written directly to blocks
+  bool m_directVersion;
+  scShmCommitSeq m_appliedVersion;
+  boost::uint64_t m_receivedBytes;
+};
+
+#endif // _SCSHREPL_H__
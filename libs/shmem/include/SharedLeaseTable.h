@@ -0,0 +1,140 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        SharedLeaseTable.h
+// Project:     scLib
+// Purpose:     Process-death-aware reader leases in shared memory
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SCSHLEASE_H__
+#define _SCSHLEASE_H__
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file SharedLeaseTable.h
+///
+/// \brief Process-death-aware reader leases in shared memory
+///
+/// Reader which pins something in shared memory (ring slot, buffer epoch)
+/// registers a lease holding a 64-bit value. Lease is keyed by pid and
+/// process start time, so a reused pid does not keep dead reader's lease.
+/// Writer calls reclaim() on its slow path - leases of dead processes
+/// (and optionally of processes which stopped renewing) are released and
+/// passed to handler. On Linux writer watches owners using pidfds kept
+/// open between calls, so reclaim is a single poll() over all leases.
+///
+/// Usage:
+/// \code
+///     // reader
+///     scShmLeaseTable leases("ring_leases");
+///     scShmLeaseId lease = leases.acquire(slotNo);
+///     ...
+///     if (!leases.renew(lease))
+///       restartRead();   // slot could be overwritten, lease was reclaimed
+///     ...
+///     leases.release(lease);
+///
+///     // writer, when ring is full
+///     leases.reclaim(&slotReleaser);
+///     boost::uint64_t oldestPinned;
+///     if (leases.getMinValue(oldestPinned))
+///       ...
+/// \endcode
+
+// ----------------------------------------------------------------------------
+// Headers
+// ----------------------------------------------------------------------------
+#include <memory>
+#include <vector>
+#include <boost/cstdint.hpp>
+
+#include "sc/dtypes.h"
+#include "sc/proc/SharedMemory.h"
+
+// ----------------------------------------------------------------------------
+// Simple type definitions
+// ----------------------------------------------------------------------------
+typedef uint scShmLeaseId;
+
+// ----------------------------------------------------------------------------
+// Forward class definitions
+// ----------------------------------------------------------------------------
+struct scShmLeaseHeader;
+struct scShmLeaseSlot;
+
+// ----------------------------------------------------------------------------
+// Constants
+// ----------------------------------------------------------------------------
+const scShmLeaseId SC_SHM_NULL_LEASE = (uint)-1;
+
+// ----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+/// Called for each reclaimed lease
+class scShmLeaseReclaimIntf {
+public:
+  scShmLeaseReclaimIntf() {}
+  virtual ~scShmLeaseReclaimIntf() {}
+  virtual void reclaimed(scShmLeaseId lease, uint pid, boost::uint64_t value) = 0;
+};
+
+class scShmLeaseTable {
+public:
+  /// Creates lease table
+  scShmLeaseTable(const scString &a_path, uint a_useFlags, uint capacity);
+  /// Attaches to existing table
+  scShmLeaseTable(const scString &a_path);
+  virtual ~scShmLeaseTable();
+
+  /// Registers lease of current process
+  /// \return Returns SC_SHM_NULL_LEASE if table is full
+  scShmLeaseId acquire(boost::uint64_t value);
+  /// Marks lease as alive
+  /// \return Returns false if lease was lost - reclaimed by writer (e.g. after
+  ///         renew timeout), caller has to acquire a new one
+  bool renew(scShmLeaseId lease);
+  /// Changes leased value, renews lease
+  /// \return Returns false if lease was lost, value is not stored then
+  bool setValue(scShmLeaseId lease, boost::uint64_t value);
+  void release(scShmLeaseId lease);
+
+  /// Releases leases of processes which are gone
+  /// \param[in] renewTimeoutMs if > 0, leases not renewed within this time are also released
+  /// \return Returns number of reclaimed leases
+  uint reclaim(scShmLeaseReclaimIntf *handler = SC_NULL, uint renewTimeoutMs = 0);
+  /// Returns minimal value of active leases, false if there are none
+  bool getMinValue(boost::uint64_t &output) const;
+  uint getActiveCount() const;
+  uint getCapacity() const;
+
+  /// Returns start time of process (platform-specific units), 0 if process does not exist
+  static boost::uint64_t getProcessStartTime(uint pid);
+protected:
+  void attach();
+  scShmLeaseSlot *getSlot(scShmLeaseId lease) const;
+  bool isOwnerAlive(scShmLeaseId lease, uint pid, boost::uint64_t startTime);
+  /// Frees slot if it still has owner and state seen when it was found dead
+  void freeSlot(scShmLeaseId lease, uint pid, uint state, scShmLeaseReclaimIntf *handler);
+  void closeWatch(scShmLeaseId lease);
+  static boost::uint64_t getClockMs();
+private:
+  scShmLeaseTable(const scShmLeaseTable &);
+  scShmLeaseTable &operator=(const scShmLeaseTable &);
+private:
+  struct OwnerWatch {
+    int handle;
+    uint pid;
+    boost::uint64_t startTime;
+  };
+  std::auto_ptr<scSharedMemory> m_memory;
+  scShmLeaseHeader *m_header;
+  scShmLeaseSlot *m_slots;
+  uint m_pid;
+  boost::uint64_t m_startTime;
+  std::vector<OwnerWatch> m_watches;  // owner handles cached by writer
+};
+
+#endif // _SCSHLEASE_H__
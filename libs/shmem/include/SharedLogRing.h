@@ -0,0 +1,206 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        SharedLogRing.h
+// Project:     scLib
+// Purpose:     Cross-process log sink in shared memory
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SCSHLOGRING_H__
+#define _SCSHLOGRING_H__
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file SharedLogRing.h
+///
+/// \brief Cross-process log sink in shared memory
+///
+/// Producers append binary records (timestamp, level, format id, arguments)
+/// to a lock-free ring, formatting is deferred to a collector process which
+/// drains the ring and writes formatted lines in batches.
+/// Producer never blocks - if ring is full, record is dropped and counted.
+///
+/// Producer killed between claiming a slot and publishing it would block the
+/// ring forever. Producers record their pid in the claimed slot, consumer
+/// which finds oldest slot claimed but unpublished skips it when claiming
+/// process does not exist anymore, or when the slot stays unpublished for
+/// stall timeout (producer died before recording its pid). Skipped slots are
+/// counted, see getSkipCount(). Producer which resumes after its slot was
+/// skipped drops its record, if it was stopped between the check and copy
+/// of the record, data of next record in the slot can be damaged.
+///
+/// Usage:
+/// \code
+///     // collector process
+///     scShmLogRing ring("applog", scsmOwner | scsmCreate, 65536, 256);
+///     scShmLogCollector collector(ring, "app.log");
+///     collector.registerFormat(FMT_CONN_FAILED, "Connection from {} failed, code: {}");
+///     while (running)
+///       collector.collect(100);
+///
+///     // producer process
+///     scShmLogRing ring("applog");
+///     ring.append(shllError, FMT_CONN_FAILED, scShmLogArgs().add(peerName).add(errorCode));
+/// \endcode
+
+// ----------------------------------------------------------------------------
+// Headers
+// ----------------------------------------------------------------------------
+#include <cstdio>
+#include <memory>
+#include <map>
+#include <vector>
+#include <boost/cstdint.hpp>
+
+#include "sc/dtypes.h"
+#include "sc/proc/SharedMemory.h"
+
+// ----------------------------------------------------------------------------
+// Simple type definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Forward class definitions
+// ----------------------------------------------------------------------------
+struct scShmLogRingHeader;
+struct scShmLogRecordHeader;
+
+// ----------------------------------------------------------------------------
+// Constants
+// ----------------------------------------------------------------------------
+enum scShmLogLevel {
+  shllError = 1,
+  shllWarning = 2,
+  shllInfo = 3,
+  shllDebug = 4
+};
+
+/// max size of serialized arguments in scShmLogArgs
+const size_t SC_SHM_LOG_ARGS_SIZE = 256;
+/// time after which consumer skips unpublished slot of a live or unknown producer
+const uint SC_SHM_LOG_DEF_STALL_TIMEOUT_MS = 2000;
+
+// ----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+/// Serialized log record arguments, does not allocate memory
+/// Arguments which do not fit are dropped, texts are cut to what fits,
+/// in both cases record is marked as truncated.
+class scShmLogArgs {
+public:
+  scShmLogArgs();
+  scShmLogArgs &add(int value);
+  scShmLogArgs &add(uint value);
+  scShmLogArgs &add(boost::int64_t value);
+  scShmLogArgs &add(boost::uint64_t value);
+  scShmLogArgs &add(double value);
+  scShmLogArgs &add(const char *value);
+  scShmLogArgs &add(const scString &value);
+  const char *getData() const;
+  size_t getSize() const;
+  /// Returns true if any argument was dropped or cut
+  bool isTruncated() const;
+protected:
+  void addValue(char typeCode, const void *value, size_t size);
+private:
+  char m_data[SC_SHM_LOG_ARGS_SIZE];
+  size_t m_size;
+  bool m_truncated;
+};
+
+/// Multi-producer ring of binary log records
+class scShmLogRing {
+public:
+  /// Creates ring segment
+  /// \param[in] recordCount number of records in ring, rounded up to power of 2
+  /// \param[in] argsSize max size of record arguments
+  scShmLogRing(const scString &a_path, uint a_useFlags, uint recordCount, size_t argsSize);
+  /// Attaches to existing ring
+  scShmLogRing(const scString &a_path);
+  virtual ~scShmLogRing();
+
+  /// Appends record, never blocks
+  /// \return Returns false if record was dropped
+  bool append(scShmLogLevel level, uint formatId, const scShmLogArgs &args);
+  /// \param[in] truncated marks record as having incomplete arguments, set also
+  ///            when argsSize is larger than ring's argument size
+  bool append(scShmLogLevel level, uint formatId, const void *args = SC_NULL, size_t argsSize = 0,
+    bool truncated = false);
+
+  /// Removes oldest record from ring, skips slot of dead or stalled producer
+  /// \param[out] args record arguments, size in argsSize
+  /// \param[out] truncated optional, set to true if arguments are incomplete
+  /// \return Returns false if ring is empty
+  bool take(boost::uint64_t &timestamp, scShmLogLevel &level, uint &formatId, uint &pid,
+    char *args, size_t &argsSize, bool *truncated = SC_NULL);
+
+  /// Returns number of records dropped since ring was created
+  uint getDropCount() const;
+  /// Returns number of slots skipped because their producer died or stalled
+  uint getSkipCount() const;
+  /// Sets time after which unpublished slot is skipped even if its producer
+  /// seems alive, used by take()
+  void setStallTimeout(uint timeoutMs);
+  size_t getArgsSize() const;
+  uint getCapacity() const;
+
+  /// Returns current time in microseconds since epoch
+  static boost::uint64_t getTimestamp();
+protected:
+  void attach();
+  scShmLogRecordHeader *getRecord(boost::uint32_t pos) const;
+  /// Releases claimed but unpublished slot at dequeue position if its producer is gone
+  /// \return Returns true if slot was skipped or published meanwhile
+  bool skipStalled(boost::uint32_t pos, scShmLogRecordHeader *record);
+private:
+  scShmLogRing(const scShmLogRing &);
+  scShmLogRing &operator=(const scShmLogRing &);
+private:
+  std::auto_ptr<scSharedMemory> m_memory;
+  scShmLogRingHeader *m_header;
+  char *m_base;
+  uint m_pid;
+  uint m_stallTimeoutMs;
+  boost::uint32_t m_stallPos;
+  boost::uint64_t m_stallSince;
+  bool m_stalled;
+};
+
+/// Drains ring, formats records and writes them to a file
+/// Format strings use "{}" as argument placeholder.
+class scShmLogCollector {
+public:
+  scShmLogCollector(scShmLogRing &ring, const scString &fileName);
+  virtual ~scShmLogCollector();
+  void registerFormat(uint formatId, const scString &format);
+  /// Drains available records (up to maxRecords, 0 = unlimited) and writes them in one batch
+  /// \return Returns number of records collected
+  uint collect(uint maxRecords = 0);
+  /// Collects records for durationMs, waits idleMs between polls when ring is empty
+  /// \return Returns number of records collected
+  uint collectFor(uint durationMs, uint idleMs);
+  uint getCollectedCount() const;
+protected:
+  /// Formats one line, truncated record is marked with " [truncated]" suffix
+  virtual void formatRecord(boost::uint64_t timestamp, scShmLogLevel level, uint formatId, uint pid,
+    const char *args, size_t argsSize, bool truncated, scString &output);
+  void formatArgs(const scString &format, const char *args, size_t argsSize, scString &output);
+  void flushBuffer();
+private:
+  scShmLogCollector(const scShmLogCollector &);
+  scShmLogCollector &operator=(const scShmLogCollector &);
+private:
+  typedef std::map<uint, scString> FormatMap;
+  scShmLogRing &m_ring;
+  std::FILE *m_file;
+  FormatMap m_formats;
+  scString m_buffer;
+  std::vector<char> m_args;
+  uint m_collectedCount;
+  uint m_reportedDrops;
+};
+
+#endif // _SCSHLOGRING_H__
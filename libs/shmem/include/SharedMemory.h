@@ -48,6 +48,10 @@
 ///    
 ///     //---> notify server that we have used the memory block
 /// \endcode
+///
+/// POSIX: each read-write mapping holds a shared flock() on the object.
+/// lockWriters() turns it into exclusive one, so that no other read-write
+/// mapping can exist until unlockWriters() - opening one throws scError.
 
 
 
@@ -55,6 +59,7 @@
 // Headers
 // ----------------------------------------------------------------------------
 #include "sc/proc/SharedResource.h"
+#include "sc/proc/SharedMemoryWarmer.h"
 
 // ----------------------------------------------------------------------------
 // Simple type definitions
@@ -76,6 +81,8 @@ enum scsmUseFlag {
   scsmOwner = 1,
   scsmCreate = 2,
   scsmNoAccess = 4,  // there will be no access to block
+  scsmPrefault = 8,  // populate page tables right after mapping
+  scsmExclusive = 16 // with scsmCreate: fail if block exists instead of replacing it
 };
 
 // ----------------------------------------------------------------------------
@@ -87,11 +94,27 @@ public:
   scSharedMemory(const scString &a_path, scsmAccessMode accessMode, uint a_useFlags, size_t a_size = 0);
   virtual ~scSharedMemory();
   virtual scString getKeyName();
-  void *getAddress();
-  size_t getSize();
+  virtual void *getAddress();
+  virtual size_t getSize();
+  /// Returns size of mapped region - existing object opened without scsmCreate
+  /// can be smaller than requested size
+  size_t getMappedSize();
+  /// Prefault mapped pages, see scShmWarmer
+  bool warmUp(scShmWarmMode mode = shwmPopulateRead);
+  /// Returns number of bytes of mapping resident in memory
+  size_t getResidentSize();
+  /// Blocks other read-write mappings of the object (POSIX), see scSharedMemorySnapshot
+  /// \return Returns false if object is mapped for writing elsewhere
+  bool lockWriters();
+  /// Allows other read-write mappings again
+  void unlockWriters();
 protected:
+  /// for subclasses which map memory on their own
+  scSharedMemory(scsmAccessMode accessMode, size_t a_size);
   virtual void freeResource();  
   void freeHandles();  
+  /// Returns descriptor used for writer lock, -1 if none
+  int getLockHandle();
 protected:
   void *m_objectHandle;  
   void *m_regionHandle;  
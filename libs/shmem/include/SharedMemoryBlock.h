@@ -30,14 +30,18 @@ Long description
 // ----------------------------------------------------------------------------
 // Simple type definitions
 // ----------------------------------------------------------------------------
+/// Interned block reference, see scSharedMemoryBlock::intern
+typedef uint scShmBlockHandle;
 
 // ----------------------------------------------------------------------------
 // Forward class definitions
 // ----------------------------------------------------------------------------
+class scSharedMemorySnapshot;
 
 // ----------------------------------------------------------------------------
 // Constants
 // ----------------------------------------------------------------------------
+const scShmBlockHandle SC_SHM_NULL_HANDLE = 0;
 
 // ----------------------------------------------------------------------------
 // Class definitions
@@ -76,16 +80,50 @@ public:
 
   void clear();
   void clear(size_t aOffset, size_t aLimit);
+
+  /// \brief Take point-in-time snapshot of block contents
+  /// \details Writes to block need to be performed by this process, 
+  /// other read-write attachments are refused while snapshot exists,
+  /// see scSharedMemorySnapshot. Caller takes ownership of result.
+  scSharedMemorySnapshot *snapshot();
+
+  /// \brief Prefault block pages, attaches to block if needed
+  bool warmUp(scShmWarmMode mode = shwmPopulateRead);
+  /// \brief Prefault block pages using background threads
+  /// \details Caller takes ownership of result, destroying it waits for completion.
+  scShmWarmer *warmUpAsync(scShmWarmMode mode, uint threadCount);
+  /// Returns number of bytes of block resident in memory, 0 if block is not attached
+  size_t getResidentSize();
   static void copy(const scString &blockPathSrc, const scString &blockPathDest, size_t blockSize, bool useReadOnly);
   static void copy(const scString &blockPathSrc, const scString &blockPathDest, size_t blockSize, size_t aOffset, size_t aLimit, bool useReadOnly);
+
+  /// \brief Resolve block path to handle which can be used for fast access
+  /// \details Handle is valid until end of process, registry keys are 
+  /// calculated once and block addresses are cached between calls.
+  /// Interning the same path twice returns the same handle.
+  static scShmBlockHandle intern(const scString &blockPath, size_t aSize);
+  static const scString &getPath(scShmBlockHandle handle);
+  static size_t getSize(scShmBlockHandle handle);
+
+  static bool read(scShmBlockHandle handle, scShmWinConsumerIntf *consumer);
+  static bool read(scShmBlockHandle handle, scShmWinConsumerIntf *consumer, size_t aOffset, size_t aLimit);
+  static void write(scShmBlockHandle handle, scShmWinWriterIntf *writer, size_t aOffset, size_t aLimit);
+  static void clear(scShmBlockHandle handle);
+  static void clear(scShmBlockHandle handle, size_t aOffset, size_t aLimit);
+  static void copy(scShmBlockHandle handleSrc, scShmBlockHandle handleDest, bool useReadOnly);
+  static void copy(scShmBlockHandle handleSrc, scShmBlockHandle handleDest, size_t aOffset, size_t aLimit, bool useReadOnly);
 protected:
   static size_t recalcLimit(size_t aBlockSize, size_t aOffset, size_t aLimit);
   size_t recalcLimit(size_t aOffset, size_t aLimit);
   void checkPos(size_t aOffset, size_t aLimit);
+  static void checkPos(const scString &path, size_t aBlockSize, size_t aOffset, size_t aLimit);
   void *get(ShBlockAccessType accessType);
+  void *attach(ShBlockAccessType accessType);
+  static ShBlockAccessType calcWarmAccessType(scShmWarmMode mode);
   static void *get(const scString &path, ShBlockAccessType accessType);
   scString calcRegPath(ShBlockAccessType accessType);
   static scString calcRegPath(const scString &path, ShBlockAccessType accessType);
+  static void *get(scShmBlockHandle handle, ShBlockAccessType accessType);
 private:
   scString m_path;
   size_t m_size;
@@ -0,0 +1,122 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        SharedMemorySnapshot.h
+// Project:     scLib
+// Purpose:     Point-in-time copy-on-write snapshot of shared memory
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SCSHMEMSNAP_H__
+#define _SCSHMEMSNAP_H__
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file SharedMemorySnapshot.h
+///
+/// \brief Point-in-time copy-on-write snapshot of shared memory
+///
+/// Taking a snapshot does not copy any data. The writer's mapping is write
+/// protected (Linux userfaultfd) and each page is copied to a sparse memfd
+/// only when writer modifies it for the first time after the snapshot.
+/// Snapshot readers see unmodified pages directly in the live block.
+///
+/// Writes need to be performed in the process which owns the snapshot and
+/// through the same mapping (for blocks - the read-write block registration).
+/// When scSharedMemory of the mapping is given, its writer lock is held
+/// exclusively for lifetime of snapshot (see scSharedMemory::lockWriters()):
+/// constructor throws scError if the object has other read-write mapping
+/// (in any process, including this one) and new ones cannot be opened until
+/// snapshot is destroyed. Without it caller has to guarantee there are no
+/// such mappings - writes through them would not be captured. The same
+/// applies to mappings not created by scSharedMemory.
+/// Writes done by kernel (e.g. read(2) into protected range) are also
+/// captured, they block until page is copied.
+/// On platforms without write-protect support the snapshot falls back to a
+/// full copy taken in constructor, see isCopyOnWrite().
+///
+/// Usage:
+/// \code
+///     scSharedMemoryBlock block("data", blockSize);
+///     std::auto_ptr<scSharedMemorySnapshot> snap(block.snapshot());
+///
+///     // writer can continue here, background job reads consistent state:
+///     snap->read(&checkpointWriter, 0, blockSize);
+/// \endcode
+
+// ----------------------------------------------------------------------------
+// Headers
+// ----------------------------------------------------------------------------
+#include <vector>
+
+#include "sc/dtypes.h"
+#include "sc/proc/SharedMemoryBlock.h"
+#include "sc/proc/SharedMemory.h"
+
+// ----------------------------------------------------------------------------
+// Simple type definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Forward class definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Constants
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+class scSharedMemorySnapshot {
+public:
+  /// \param[in] address start of writable mapping, must be page-aligned
+  /// \param[in] size size of range to be captured
+  /// \param[in] memory object which owns the mapping, used to lock out other writers
+  scSharedMemorySnapshot(void *address, size_t size, scSharedMemory *memory = SC_NULL);
+  virtual ~scSharedMemorySnapshot();
+
+  /// Copies consistent snapshot data to output buffer
+  size_t read(void *output, size_t aOffset, size_t aSize);
+  /// Passes consistent snapshot data to consumer, page by page
+  size_t read(scShmWinConsumerIntf *consumer, size_t aOffset, size_t aSize);
+
+  size_t getSize() const;
+  /// Returns number of pages duplicated since snapshot was taken
+  size_t getCopiedPageCount() const;
+  /// Returns false if snapshot had to be taken as a full copy
+  bool isCopyOnWrite() const;
+  /// Returns true if copy-on-write snapshots are supported by the platform
+  static bool isSupported();
+protected:
+  void initCopyOnWrite();
+  void initFullCopy();
+  void freeHandles();
+  void unlockWriters();
+  bool isPageCopied(size_t pageNo) const;
+  const char *readPage(size_t pageNo, size_t pageOffset, size_t len, char *buffer);
+#ifdef __linux__
+  static void *handlerEntry(void *arg);
+  void handleFaults();
+#endif
+private:
+  scSharedMemorySnapshot(const scSharedMemorySnapshot &);
+  scSharedMemorySnapshot &operator=(const scSharedMemorySnapshot &);
+private:
+  char *m_source;
+  size_t m_size;
+  size_t m_pageSize;
+  char *m_copy;
+  std::vector<unsigned char> m_copied;
+  size_t m_copiedCount;
+  bool m_copyOnWrite;
+  int m_memFd;
+  int m_faultFd;
+  int m_stopFd;
+  void *m_thread;
+  scSharedMemory *m_memory;
+};
+
+#endif // _SCSHMEMSNAP_H__
@@ -0,0 +1,207 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        SharedMemoryTrace.h
+// Project:     scLib
+// Purpose:     Recording and replay of shared memory block operations
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SCSHMTRACE_H__
+#define _SCSHMTRACE_H__
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file SharedMemoryTrace.h
+///
+/// \brief Recording and replay of shared memory block operations
+///
+/// When recorder is started, scSharedMemoryBlock and scSharedResourceManager
+/// append each operation (op, block, offset, size, timestamp, pid, duration)
+/// to a binary trace file. Only the outermost operation is recorded, e.g.
+/// registration done by block read is not.
+/// Each process writes its own trace, timestamps use system-wide monotonic
+/// clock, so traces of several processes can be replayed together.
+///
+/// Replayer executes traces on blocks named with a prefix (fresh set of
+/// blocks), at original speed, accelerated or as fast as possible, and
+/// reports latency percentiles per operation type. Operations of each
+/// recorded process are replayed by a separate process (POSIX), all aligned
+/// to the shared timeline, so contention between processes is reproduced.
+/// On Windows and for single-process traces operations are replayed by the
+/// calling process, merged in timestamp order.
+/// Replay needs active scSharedResourceManager.
+///
+/// Usage:
+/// \code
+///     // production process
+///     scShmTraceRecorder::start("shm_"+toString(getpid())+".trace");
+///     ...
+///     scShmTraceRecorder::stop();
+///
+///     // benchmark
+///     scShmTraceReplayer replayer("replay_");
+///     replayer.addTrace("shm_1201.trace");
+///     replayer.addTrace("shm_1202.trace");
+///     replayer.setSpeed(10.0);
+///     replayer.run();
+///     std::cout << replayer.getReport();
+/// \endcode
+
+// ----------------------------------------------------------------------------
+// Headers
+// ----------------------------------------------------------------------------
+#include <cstdio>
+#include <vector>
+#include <map>
+#include <boost/cstdint.hpp>
+
+#include "sc/dtypes.h"
+
+// ----------------------------------------------------------------------------
+// Simple type definitions
+// ----------------------------------------------------------------------------
+enum scShmTraceOp {
+  shtoName,       // defines block id, not an operation
+  shtoCreate,
+  shtoRead,
+  shtoWrite,
+  shtoCopy,
+  shtoRegister,
+  shtoRelease,
+  shtoCount
+};
+
+// ----------------------------------------------------------------------------
+// Forward class definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Constants
+// ----------------------------------------------------------------------------
+/// Operation failed with exception
+const boost::uint16_t SC_SHM_TRACE_FAILED = 1;
+/// Copy used read-only mapping of source
+const boost::uint16_t SC_SHM_TRACE_READ_ONLY = 2;
+
+// ----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+/// Trace file record, shtoName is followed by dataSize bytes of block name
+struct scShmTraceRecord {
+  boost::uint64_t timestamp;  // ns, monotonic
+  boost::uint64_t offset;
+  boost::uint64_t size;       // limit, block size for create & name
+  boost::uint64_t dataSize;   // bytes written, name length
+  boost::uint32_t pid;
+  boost::uint32_t duration;   // ns
+  boost::uint32_t blockId;
+  boost::uint32_t targetId;   // copy destination
+  boost::uint16_t op;
+  boost::uint16_t flags;
+  boost::uint32_t reserved;
+};
+
+/// Writes operations of this process to trace file, not thread-safe
+/// (same as block operations)
+class scShmTraceRecorder {
+public:
+  static void start(const scString &fileName);
+  static void stop();
+  static bool isActive();
+  static boost::uint64_t getRecordCount();
+  /// Returns monotonic time in ns
+  static boost::uint64_t getTime();
+protected:
+  friend class scShmTraceScope;
+  static bool enter();
+  static bool isOutermost();
+  static void leave();
+  static void record(scShmTraceRecord &record, const scString &path, size_t blockSize, const scString *targetPath);
+  static boost::uint32_t getBlockId(const scString &path, size_t blockSize);
+  static void append(const void *data, size_t size);
+  static void flush();
+};
+
+/// Records one operation, recording is skipped if recorder is not active or
+/// operation is nested in another one
+class scShmTraceScope {
+public:
+  scShmTraceScope(scShmTraceOp op, const scString &path, size_t blockSize, size_t aOffset, size_t aLimit);
+  ~scShmTraceScope();
+  void setDataSize(size_t value);
+  void setTarget(const scString &path, boost::uint16_t flags);
+private:
+  scShmTraceScope(const scShmTraceScope &);
+  scShmTraceScope &operator=(const scShmTraceScope &);
+private:
+  bool m_entered;
+  bool m_active;
+  const scString *m_path;
+  const scString *m_targetPath;
+  size_t m_blockSize;
+  scShmTraceRecord m_record;
+};
+
+/// Re-runs recorded traces and measures latency of operations
+class scShmTraceReplayer {
+public:
+  /// \param[in] blockPrefix prefix added to names of replayed blocks
+  scShmTraceReplayer(const scString &blockPrefix);
+  virtual ~scShmTraceReplayer();
+
+  /// Loads trace, several traces are merged by timestamp
+  void addTrace(const scString &fileName);
+  /// 1.0 keeps original timing, 10.0 is ten times faster, 0 disables waiting
+  void setSpeed(double speed);
+  void run();
+  /// Returns number of recorded processes in loaded traces
+  uint getProcessCount() const;
+
+  static const char *getOpName(scShmTraceOp op);
+  uint getCount(scShmTraceOp op) const;
+  uint getErrorCount(scShmTraceOp op) const;
+  /// Returns latency in ns at given percentile (0..100)
+  /// \param[in] original use durations from trace instead of replay
+  boost::uint64_t getPercentile(scShmTraceOp op, double percent, bool original = false) const;
+  /// Returns table with replay and original percentiles per operation type
+  scString getReport() const;
+protected:
+  struct TraceBlock {
+    scString name;
+    size_t size;
+    bool createdByTrace;
+    bool created;
+  };
+  struct TraceOp {
+    scShmTraceRecord record;
+    uint blockNo;
+    uint targetNo;
+  };
+  typedef std::vector<boost::uint64_t> LatencyColn;
+
+  uint addBlock(const scString &name, size_t size);
+  void createBlocks();
+  void releaseBlocks();
+  void execute(const TraceOp &op);
+  /// Replays operations of one recorded process, all of them if pid is 0
+  void replayOps(boost::uint32_t pid, boost::uint64_t traceStart, boost::uint64_t replayStart);
+  /// Replays each recorded process in its own process, collects latencies
+  void replayInProcesses(const std::vector<boost::uint32_t> &pids, boost::uint64_t traceStart);
+  void getPids(std::vector<boost::uint32_t> &output) const;
+  void waitUntil(boost::uint64_t time);
+  static boost::uint64_t calcPercentile(const LatencyColn &values, double percent);
+private:
+  scString m_blockPrefix;
+  double m_speed;
+  std::vector<TraceBlock> m_blocks;
+  std::map<scString, uint> m_blockNames;
+  std::vector<TraceOp> m_ops;
+  LatencyColn m_latency[shtoCount];
+  LatencyColn m_original[shtoCount];
+  uint m_errors[shtoCount];
+};
+
+#endif // _SCSHMTRACE_H__
@@ -0,0 +1,135 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        SharedMemoryTransaction.h
+// Project:     scLib
+// Purpose:     Atomic updates of multiple shared memory blocks
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SCSHMEMTRANS_H__
+#define _SCSHMEMTRANS_H__
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file SharedMemoryTransaction.h
+///
+/// \brief Atomic updates of multiple shared memory blocks
+///
+/// Group of related blocks shares one commit record - a sequence number
+/// in its own shared memory segment. Writer stages block updates in process
+/// memory and applies them all inside of a single commit (sequence is odd
+/// while commit is in progress). Reader validates that sequence did not
+/// change while it was reading - if it did, data must be read again.
+/// Record keeps pid of writer - if writer dies during commit, waiting reader
+/// or writer closes the commit, partially applied version becomes visible
+/// and is counted in getRecoveryCount().
+///
+/// Usage:
+/// \code
+///     // writer
+///     scShmCommitRecord record("index_commit", scsmOwner | scsmCreate);
+///     scShmTransaction trans(record);
+///     trans.write(indexBlock, &indexWriter, 0, indexSize);
+///     trans.write(dataBlock, &dataWriter, 0, dataSize);
+///     trans.commit();
+///
+///     // reader
+///     scShmCommitRecord record("index_commit", 0);
+///     scShmCommitSeq seq;
+///     do {
+///       seq = record.beginRead();
+///       scSharedMemoryBlock::read(indexBlock, &indexCopier);
+///       scSharedMemoryBlock::read(dataBlock, &dataCopier);
+///     } while (!record.validate(seq));
+/// \endcode
+
+// ----------------------------------------------------------------------------
+// Headers
+// ----------------------------------------------------------------------------
+#include <memory>
+#include <boost/cstdint.hpp>
+#include "boost/ptr_container/ptr_vector.hpp"
+
+#include "sc/dtypes.h"
+#include "sc/proc/SharedMemory.h"
+#include "sc/proc/SharedMemoryBlock.h"
+
+// ----------------------------------------------------------------------------
+// Simple type definitions
+// ----------------------------------------------------------------------------
+typedef boost::uint32_t scShmCommitSeq;
+
+// ----------------------------------------------------------------------------
+// Forward class definitions
+// ----------------------------------------------------------------------------
+struct scShmCommitLayout;
+
+// ----------------------------------------------------------------------------
+// Constants
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+/// Shared commit sequence of a group of blocks
+class scShmCommitRecord {
+public:
+  /// \param[in] a_useFlags scsmUseFlag values, use scsmCreate in process which creates blocks
+  scShmCommitRecord(const scString &a_path, uint a_useFlags);
+  virtual ~scShmCommitRecord();
+
+  /// Waits until no commit is in progress, returns sequence to be validated
+  scShmCommitSeq beginRead();
+  /// Returns true if no commit was performed since beginRead
+  bool validate(scShmCommitSeq seq);
+  /// Returns number of commits performed on record
+  scShmCommitSeq getCommitCount();
+  /// Returns number of commits closed after their writer died
+  uint getRecoveryCount();
+
+  /// Marks start of commit, waits for other writer if needed
+  void beginCommit();
+  void endCommit();
+protected:
+  /// Closes commit of writer which does not exist anymore
+  /// \return Returns true if record was recovered
+  bool recoverDeadWriter();
+private:
+  scShmCommitRecord(const scShmCommitRecord &);
+  scShmCommitRecord &operator=(const scShmCommitRecord &);
+private:
+  std::auto_ptr<scSharedMemory> m_memory;
+  scShmCommitLayout *m_layout;
+};
+
+/// Set of staged block writes, applied atomically on commit
+class scShmTransaction {
+public:
+  scShmTransaction(scShmCommitRecord &record);
+  virtual ~scShmTransaction();
+
+  /// Stages write - writer is called immediately, output is kept until commit
+  void write(scShmBlockHandle handle, scShmWinWriterIntf *writer, size_t aOffset, size_t aLimit);
+  void write(const scString &blockPath, size_t blockSize, scShmWinWriterIntf *writer, size_t aOffset, size_t aLimit);
+  /// Applies all staged writes as a single version change
+  void commit();
+  /// Drops staged writes
+  void rollback();
+  size_t getStagedCount() const;
+protected:
+  struct StagedWrite {
+    scShmBlockHandle handle;
+    size_t offset;
+    size_t limit;
+    std::vector<char> data;
+  };
+  typedef boost::ptr_vector<StagedWrite> StagedWriteColn;
+private:
+  scShmCommitRecord &m_record;
+  StagedWriteColn m_staged;
+};
+
+#endif // _SCSHMEMTRANS_H__
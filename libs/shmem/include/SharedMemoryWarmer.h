@@ -0,0 +1,93 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        SharedMemoryWarmer.h
+// Project:     scLib
+// Purpose:     Prefaulting and residency check of mapped memory
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SCSHMEMWARM_H__
+#define _SCSHMEMWARM_H__
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file SharedMemoryWarmer.h
+///
+/// \brief Prefaulting and residency check of mapped memory
+///
+/// Freshly attached block takes a page fault on first access to each page.
+/// Warmer populates page tables in advance - synchronously or using
+/// background threads, each one handling a part of the range.
+///
+/// Usage:
+/// \code
+///     scSharedMemoryBlock block("test", blockSize);
+///     std::auto_ptr<scShmWarmer> warmer(block.warmUpAsync(shwmPopulateRead, 4));
+///     ...
+///     if (block.getResidentSize() == blockSize)
+///       routeRequest(block);
+/// \endcode
+
+// ----------------------------------------------------------------------------
+// Headers
+// ----------------------------------------------------------------------------
+#include <vector>
+
+#include "sc/dtypes.h"
+
+// ----------------------------------------------------------------------------
+// Simple type definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Forward class definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Constants
+// ----------------------------------------------------------------------------
+enum scShmWarmMode {
+  shwmAdvise,         // hint only (WILLNEED), returns immediately
+  shwmPopulateRead,   // map pages readable (MADV_POPULATE_READ or touch)
+  shwmPopulateWrite,  // map pages writable, no data modification
+  shwmTouch           // read one byte from each page
+};
+
+// ----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+/// Warms range of memory in background, waits for completion on destroy
+class scShmWarmer {
+public:
+  scShmWarmer(void *address, size_t size, scShmWarmMode mode, uint threadCount);
+  virtual ~scShmWarmer();
+  void wait();
+
+  /// Warm range synchronously
+  /// \return Returns false if requested mode could not be fully applied
+  static bool warm(void *address, size_t size, scShmWarmMode mode);
+  /// Calculate number of bytes from range which are resident in memory
+  /// \return Returns false if residency cannot be checked on this platform
+  static bool getResidentSize(const void *address, size_t size, size_t &output);
+protected:
+  static void touch(const void *address, size_t size);
+#ifndef WIN32
+  static void *workerEntry(void *arg);
+#endif
+private:
+  scShmWarmer(const scShmWarmer &);
+  scShmWarmer &operator=(const scShmWarmer &);
+private:
+  struct WarmerTask {
+    char *address;
+    size_t size;
+    scShmWarmMode mode;
+  };
+  std::vector<WarmerTask> m_tasks;
+  std::vector<void *> m_threads;
+};
+
+#endif // _SCSHMEMWARM_H__
@@ -0,0 +1,120 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        SharedMemoryWindow.h
+// Project:     scLib
+// Purpose:     Windowed access to large shared memory segments
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SCSHMEMWIN_H__
+#define _SCSHMEMWIN_H__
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file SharedMemoryWindow.h
+///
+/// \brief Windowed access to large shared memory segments
+///
+/// Only a fixed-size window of the segment is mapped at any time, so
+/// segments larger than available address space can be processed.
+/// Window slides automatically when sequential reader / writer advances.
+///
+/// Usage:
+/// \code
+///     // scan segment using 64MB mapping
+///     scSharedMemoryWindow window("big_segment", scsmReadOnly, 0, segmentSize, 64*1024*1024);
+///     window.setSequential(true);
+///
+///     while (!window.eof())
+///       window.read(&consumer, chunkSize);
+/// \endcode
+
+// ----------------------------------------------------------------------------
+// Headers
+// ----------------------------------------------------------------------------
+#include <boost/cstdint.hpp>
+
+#include "sc/dtypes.h"
+#include "sc/proc/SharedMemory.h"
+#include "sc/proc/SharedMemoryBlock.h"
+
+// ----------------------------------------------------------------------------
+// Simple type definitions
+// ----------------------------------------------------------------------------
+/// Position inside of segment, 64-bit also on 32-bit platforms
+typedef boost::uint64_t scShmOffset;
+
+// ----------------------------------------------------------------------------
+// Forward class definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Constants
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+class scSharedMemoryWindow {
+public:
+  /// \param[in] a_path name of shared memory segment
+  /// \param[in] a_useFlags scsmUseFlag values, scsmNoAccess is ignored
+  /// \param[in] a_segmentSize total size of segment
+  /// \param[in] a_windowSize maximum size of mapping, rounded up to page size
+  scSharedMemoryWindow(const scString &a_path, scsmAccessMode accessMode, uint a_useFlags,
+    scShmOffset a_segmentSize, size_t a_windowSize);
+  virtual ~scSharedMemoryWindow();
+
+  /// \brief Returns address of range [offset, offset+length), remaps window if needed
+  /// \details Pointer is valid until next call which moves the window.
+  void *map(scShmOffset offset, size_t length);
+
+  // -- streaming I/O, starts at current position and advances it
+  void seek(scShmOffset pos);
+  scShmOffset tell() const;
+  bool eof() const;
+  size_t read(void *output, size_t size);
+  size_t write(const void *input, size_t size);
+  /// Passes data to consumer window by window, without copying
+  size_t read(scShmWinConsumerIntf *consumer, size_t size);
+  /// Lets writer fill data window by window, stops when writer returns less than requested
+  size_t write(scShmWinWriterIntf *writer, size_t size);
+
+  /// \brief Optimize mapping for sequential access
+  /// \details Each new window is advised as sequential & prefetched.
+  void setSequential(bool value);
+
+  scShmOffset getSegmentSize() const;
+  size_t getWindowSize() const;
+  scShmOffset getWindowOffset() const;
+  size_t getWindowLength() const;
+  /// Number of times window was (re)mapped
+  uint getMapCount() const;
+protected:
+  void mapWindow(scShmOffset pos);
+  void unmapWindow();
+  void freeHandles();
+  size_t calcAvailable();
+private:
+  scSharedMemoryWindow(const scSharedMemoryWindow &);
+  scSharedMemoryWindow &operator=(const scSharedMemoryWindow &);
+private:
+  void *m_objectHandle;
+  void *m_regionHandle;
+  scString m_path;
+  scsmAccessMode m_accessMode;
+  bool m_ownsResource;
+  bool m_sequential;
+  scShmOffset m_segmentSize;
+  size_t m_windowSize;
+  scShmOffset m_windowOffset;
+  size_t m_windowLength;
+  char *m_windowAddress;
+  scShmOffset m_pos;
+  uint m_mapCount;
+};
+
+#endif // _SCSHMEMWIN_H__
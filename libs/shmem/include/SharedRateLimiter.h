@@ -0,0 +1,116 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        SharedRateLimiter.h
+// Project:     scLib
+// Purpose:     Token bucket rate limiter shared by processes
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SCSHRATELIMIT_H__
+#define _SCSHRATELIMIT_H__
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file SharedRateLimiter.h
+///
+/// \brief Token bucket rate limiter shared by processes
+///
+/// Named buckets live in one shared memory segment, so processes draw from
+/// a common quota instead of static per-process slices.
+/// Bucket state is a single 64-bit "theoretical arrival time" on the
+/// system-wide monotonic clock (GCRA form of token bucket): acquire is
+/// one clock read and one CAS, refill is implicit.
+/// Bucket can have a parent - acquire succeeds only if tokens are available
+/// in bucket and in all its parents (e.g. per-tenant and global limit).
+///
+/// Usage:
+/// \code
+///     scShmRateLimiter limiter("quotas", scsmOwner | scsmCreate, 64);
+///     scShmBucketId global = limiter.addBucket("global", 10000, 20000);
+///     limiter.addBucket("tenant_a", 2000, 4000, "global");
+///
+///     // any process
+///     scShmRateLimiter limiter("quotas");
+///     scShmBucketId bucket = limiter.findBucket("tenant_a");
+///     if (limiter.acquire(bucket, batchSize))
+///       sendBatch();
+/// \endcode
+
+// ----------------------------------------------------------------------------
+// Headers
+// ----------------------------------------------------------------------------
+#include <memory>
+#include <boost/cstdint.hpp>
+
+#include "sc/dtypes.h"
+#include "sc/proc/SharedMemory.h"
+
+// ----------------------------------------------------------------------------
+// Simple type definitions
+// ----------------------------------------------------------------------------
+typedef uint scShmBucketId;
+
+// ----------------------------------------------------------------------------
+// Forward class definitions
+// ----------------------------------------------------------------------------
+struct scShmRateHeader;
+struct scShmRateBucket;
+
+// ----------------------------------------------------------------------------
+// Constants
+// ----------------------------------------------------------------------------
+const scShmBucketId SC_SHM_NULL_BUCKET = (uint)-1;
+const size_t SC_SHM_BUCKET_NAME_LEN = 32;
+
+// ----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+class scShmRateLimiter {
+public:
+  /// Creates limiter segment
+  /// \param[in] maxBuckets max number of buckets
+  scShmRateLimiter(const scString &a_path, uint a_useFlags, uint maxBuckets);
+  /// Attaches to existing limiter
+  scShmRateLimiter(const scString &a_path);
+  virtual ~scShmRateLimiter();
+
+  /// Adds bucket, returns existing one if name is already used
+  /// \param[in] rate tokens per second
+  /// \param[in] burst max number of tokens which can be acquired at once
+  /// \param[in] parentName name of parent bucket, empty if none
+  scShmBucketId addBucket(const scString &name, double rate, uint burst, const scString &parentName = scString(""));
+  /// Returns SC_SHM_NULL_BUCKET if not found
+  scShmBucketId findBucket(const scString &name) const;
+
+  /// Takes n tokens from bucket and its parents, never blocks
+  /// \return Returns false if tokens are not available now (nothing is taken)
+  bool acquire(scShmBucketId bucket, uint n = 1);
+  bool acquire(const scString &name, uint n = 1);
+  /// Returns tokens taken by acquire which were not used
+  void release(scShmBucketId bucket, uint n = 1);
+  /// Returns number of tokens available in bucket (parents not included)
+  uint getAvailable(scShmBucketId bucket) const;
+  /// Returns time in microseconds after which n tokens will be available in bucket and parents
+  boost::uint64_t getWaitTime(scShmBucketId bucket, uint n = 1) const;
+
+  uint getBucketCount() const;
+  /// Returns current value of monotonic clock in nanoseconds
+  static boost::uint64_t getClock();
+protected:
+  void attach();
+  scShmRateBucket *getBucket(scShmBucketId bucket) const;
+  bool acquireOne(scShmRateBucket *bucket, boost::uint64_t cost, boost::uint64_t now);
+  void releaseOne(scShmRateBucket *bucket, boost::uint64_t cost);
+private:
+  scShmRateLimiter(const scShmRateLimiter &);
+  scShmRateLimiter &operator=(const scShmRateLimiter &);
+private:
+  std::auto_ptr<scSharedMemory> m_memory;
+  scShmRateHeader *m_header;
+  scShmRateBucket *m_buckets;
+};
+
+#endif // _SCSHRATELIMIT_H__
@@ -85,6 +85,9 @@ public:
   static bool ready();
   static scSharedResource *get(const scString &keyName);
   static scSharedResource *find(const scString &keyName);
+  /// Returns number which changes each time any resource is destroyed.
+  /// Can be used to validate cached resource pointers without key lookup.
+  static uint getGeneration();
 protected:
   static scSharedResourceManager *checkManager();
   void intAdd(scSharedResource *a_resource, const scString &keyName = scString(""));
@@ -94,6 +97,7 @@ protected:
   scSharedResource *intFind(const scString &keyName);
 private:
   static scSharedResourceManager *m_activeManager;    
+  static uint m_generation;
   scResourceMapColn m_resourceList;
   scResourceMMapColn m_handleList;
 };
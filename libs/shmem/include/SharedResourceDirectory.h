@@ -0,0 +1,138 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        SharedResourceDirectory.h
+// Project:     scLib
+// Purpose:     System-wide directory of shared memory segments
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SCSHAREDRESDIR_H__
+#define _SCSHAREDRESDIR_H__
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file SharedResourceDirectory.h
+///
+/// \brief System-wide directory of shared memory segments
+///
+/// scSharedResourceManager counts references inside of one process only.
+/// Directory keeps global reference count of each segment in a dedicated
+/// shared memory segment (hash table: name -> size, owner, refcount,
+/// attached processes, version), so segment is destroyed when the last
+/// process using it detaches - regardless which one it is.
+///
+/// References of processes which finished without detaching are released
+/// by pruneDeadProcesses() (also when directory is full or when process
+/// died holding directory lock - POSIX robust mutex). Only the first
+/// SC_SHM_DIR_MAX_ATTACH attached processes of entry are tracked.
+///
+/// Usage:
+/// \code
+///     scSharedResourceDirectory dir;
+///
+///     // owner
+///     dir.add("test", blockSize);     // owner is attached
+///     ...
+///     dir.detach("test");             // destroys segment if not used
+///
+///     // client
+///     if (dir.attach("test")) {
+///       // use segment
+///       dir.detach("test");           // destroys segment if last one
+///     }
+/// \endcode
+
+// ----------------------------------------------------------------------------
+// Headers
+// ----------------------------------------------------------------------------
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+#include "sc/dtypes.h"
+
+// ----------------------------------------------------------------------------
+// Simple type definitions
+// ----------------------------------------------------------------------------
+typedef std::vector<unsigned long> scShmDirPidList;
+
+struct scShmDirEntryInfo {
+  scString name;
+  boost::uint64_t size;
+  unsigned long ownerPid;
+  uint refCount;
+  uint version;
+  scShmDirPidList attached;
+};
+
+// ----------------------------------------------------------------------------
+// Forward class definitions
+// ----------------------------------------------------------------------------
+struct scShmDirHeader;
+struct scShmDirEntry;
+
+// ----------------------------------------------------------------------------
+// Constants
+// ----------------------------------------------------------------------------
+const uint SC_SHM_DIR_NAME_LEN = 64;
+const uint SC_SHM_DIR_MAX_ATTACH = 16;
+const uint SC_SHM_DIR_DEF_CAPACITY = 1024;
+
+// ----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+class scSharedResourceDirectory {
+public:
+  /// Opens or creates directory segment
+  /// \param[in] dirName name of directory segment
+  /// \param[in] capacity max number of entries, used only on creation
+  scSharedResourceDirectory(const scString &dirName = scString("scshm_dir"), uint capacity = SC_SHM_DIR_DEF_CAPACITY);
+  virtual ~scSharedResourceDirectory();
+
+  /// Registers segment, current process becomes owner & first attached process
+  /// \return Returns false if segment is already registered
+  bool add(const scString &name, boost::uint64_t size);
+  /// Increments global reference count
+  /// \return Returns false if segment is not registered
+  bool attach(const scString &name);
+  /// Decrements global reference count, destroys segment on last reference
+  /// \return Returns true if segment has been destroyed
+  bool detach(const scString &name);
+  bool find(const scString &name, scShmDirEntryInfo &output);
+  bool exists(const scString &name);
+  uint getRefCount(const scString &name);
+  /// Returns number of changes performed on directory
+  uint getVersion();
+  /// Releases references of finished processes, destroys segments without references
+  /// \return Returns number of released references
+  uint pruneDeadProcesses();
+
+  /// Removes directory segment (not registered segments)
+  static void remove(const scString &dirName = scString("scshm_dir"));
+protected:
+  static uint calcHash(const char *name);
+  scShmDirEntry *intFind(const char *name);
+  scShmDirEntry *intInsert(const char *name);
+  void intRemove(scShmDirEntry *entry);
+  /// Rebuilds hash table without deleted slots
+  void intRehash();
+  uint intPrune();
+  /// Repairs table after lock owner died during update
+  void intRecover();
+  friend class scShmDirLock;
+  void checkName(const scString &name);
+  virtual void destroySegment(const scString &name);
+private:
+  scSharedResourceDirectory(const scSharedResourceDirectory &);
+  scSharedResourceDirectory &operator=(const scSharedResourceDirectory &);
+private:
+  void *m_segmentHandle;
+  scShmDirHeader *m_header;
+  scShmDirEntry *m_entries;
+  scString m_dirName;
+};
+
+#endif // _SCSHAREDRESDIR_H__
@@ -0,0 +1,131 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        SharedTaskPool.h
+// Project:     scLib
+// Purpose:     Work-stealing task pool shared by worker processes
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SCSHTASKPOOL_H__
+#define _SCSHTASKPOOL_H__
+
+// ----------------------------------------------------------------------------
+// Description
+// ----------------------------------------------------------------------------
+/// \file SharedTaskPool.h
+///
+/// \brief Work-stealing task pool shared by worker processes
+///
+/// Whole pool lives in one shared memory segment:
+/// - each worker has an inbox (bounded MPMC queue) for tasks submitted by
+///   any process and a Chase-Lev deque for tasks spawned by worker itself
+/// - idle worker takes work from own deque, own inbox, then steals from
+///   deques and inboxes of other workers, so one long task does not
+///   block tasks queued behind it
+/// - task payloads are fixed-size slots carved from the segment
+/// - idle workers park on a futex (Linux), other platforms poll
+///
+/// Usage:
+/// \code
+///     // dispatcher
+///     scShmTaskPool pool("jobs", scsmOwner | scsmCreate, workerCount, 1024, 4096, 8192);
+///     pool.submit(jobData, jobSize);
+///
+///     // worker process no. N
+///     scShmTaskPool pool("jobs");
+///     while (running)
+///       pool.runNext(N, &jobRunner, 100);
+/// \endcode
+
+// ----------------------------------------------------------------------------
+// Headers
+// ----------------------------------------------------------------------------
+#include <memory>
+#include <boost/cstdint.hpp>
+
+#include "sc/dtypes.h"
+#include "sc/proc/SharedMemory.h"
+#include "sc/proc/SharedMemoryBlock.h"
+
+// ----------------------------------------------------------------------------
+// Simple type definitions
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Forward class definitions
+// ----------------------------------------------------------------------------
+struct scShmTaskPoolHeader;
+struct scShmTaskWorkerArea;
+
+// ----------------------------------------------------------------------------
+// Constants
+// ----------------------------------------------------------------------------
+/// submit() target meaning "next worker, round-robin"
+const uint SC_SHM_POOL_ANY_WORKER = (uint)-1;
+
+// ----------------------------------------------------------------------------
+// Class definitions
+// ----------------------------------------------------------------------------
+
+class scShmTaskPool {
+public:
+  /// Creates pool segment
+  /// \param[in] queueCapacity capacity of each inbox & deque, rounded up to power of 2
+  /// \param[in] payloadSize max size of task data
+  /// \param[in] payloadCount max number of tasks queued in whole pool
+  scShmTaskPool(const scString &a_path, uint a_useFlags, uint workerCount, uint queueCapacity,
+    size_t payloadSize, uint payloadCount);
+  /// Attaches to existing pool
+  scShmTaskPool(const scString &a_path);
+  virtual ~scShmTaskPool();
+
+  /// Queues task in inbox of a given worker, can be called by any process
+  /// \return Returns false if pool is full
+  bool submit(const void *payload, size_t size, uint workerNo = SC_SHM_POOL_ANY_WORKER);
+  /// Queues task, data is written directly to task slot
+  bool submit(scShmWinWriterIntf *writer, uint workerNo = SC_SHM_POOL_ANY_WORKER);
+  /// Queues sub-task in worker's own deque, can be called only by that worker
+  bool spawn(uint workerNo, const void *payload, size_t size);
+
+  /// Executes next task available for worker, parks up to waitMs when there is none
+  /// \return Returns false if no task was executed
+  bool runNext(uint workerNo, scShmWinConsumerIntf *consumer, uint waitMs);
+
+  uint getWorkerCount() const;
+  size_t getPayloadSize() const;
+  /// Returns number of tasks executed by worker
+  uint getExecutedCount(uint workerNo) const;
+  /// Returns number of tasks worker took from other workers
+  uint getStolenCount(uint workerNo) const;
+protected:
+  void init(uint workerCount, uint queueCapacity, uint payloadCount);
+  void attach();
+  scShmTaskWorkerArea *getWorker(uint workerNo) const;
+  boost::uint32_t *getDequeBuffer(uint workerNo) const;
+  boost::uint32_t *getInboxCells(uint workerNo) const;
+  char *getSlot(boost::uint32_t slotNo) const;
+
+  boost::uint32_t allocSlot();
+  void freeSlot(boost::uint32_t slotNo);
+
+  bool dequePush(uint workerNo, boost::uint32_t slotNo);
+  bool dequePop(uint workerNo, boost::uint32_t &slotNo);
+  bool dequeSteal(uint workerNo, boost::uint32_t &slotNo);
+  bool inboxPush(uint workerNo, boost::uint32_t slotNo);
+  bool inboxPop(uint workerNo, boost::uint32_t &slotNo);
+
+  bool findTask(uint workerNo, boost::uint32_t &slotNo, bool &stolen);
+  void notifyWorker();
+  void waitForTask(boost::uint32_t wakeSeq, uint waitMs);
+  bool enqueue(boost::uint32_t slotNo, uint workerNo);
+private:
+  scShmTaskPool(const scShmTaskPool &);
+  scShmTaskPool &operator=(const scShmTaskPool &);
+private:
+  std::auto_ptr<scSharedMemory> m_memory;
+  scShmTaskPoolHeader *m_header;
+  char *m_base;
+};
+
+#endif // _SCSHTASKPOOL_H__
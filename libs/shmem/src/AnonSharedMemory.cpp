@@ -0,0 +1,334 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        AnonSharedMemory.cpp
+// Project:     scLib
+// Purpose:     Anonymous shared memory passed by descriptor
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#include "sc/proc/AnonSharedMemory.h"
+
+#include <cstring>
+#include <cstdio>
+
+#ifdef __linux__
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#define SCSHM_MEMFD
+#endif
+
+#include "sc/utils.h"
+
+#ifdef SCSHM_MEMFD
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#define MFD_ALLOW_SEALING 0x0002U
+#endif
+
+static scString anon_shm_error(const scString &action)
+{
+  return action + " failed: " + scString(strerror(errno));
+}
+
+static uint anon_shm_seals_to_os(uint sealFlags)
+{
+  uint res = 0;
+  if (sealFlags & scsmSealShrink) res |= F_SEAL_SHRINK;
+  if (sealFlags & scsmSealGrow) res |= F_SEAL_GROW;
+  if (sealFlags & scsmSealWrite) res |= F_SEAL_WRITE;
+  if (sealFlags & scsmSealSeal) res |= F_SEAL_SEAL;
+  return res;
+}
+
+static uint anon_shm_seals_from_os(uint osSeals)
+{
+  uint res = 0;
+  if (osSeals & F_SEAL_SHRINK) res |= scsmSealShrink;
+  if (osSeals & F_SEAL_GROW) res |= scsmSealGrow;
+  if (osSeals & F_SEAL_WRITE) res |= scsmSealWrite;
+  if (osSeals & F_SEAL_SEAL) res |= scsmSealSeal;
+  return res;
+}
+#endif
+
+scAnonSharedMemory::scAnonSharedMemory(const scString &a_name, size_t a_size):
+  scSharedMemory(scsmReadWrite, a_size), m_fd(-1), m_address(SC_NULL)
+{
+#ifdef SCSHM_MEMFD
+  // not owner in terms of scSharedMemory - there is no global name to 
+  // remove, block is destroyed when last descriptor & mapping is closed
+  m_path = a_name;
+
+  m_fd = static_cast<int>(syscall(__NR_memfd_create, stringToCharPtr(a_name), MFD_CLOEXEC | MFD_ALLOW_SEALING));
+  if (m_fd < 0)
+    throw scError(anon_shm_error("memfd_create"));
+
+  if (ftruncate(m_fd, a_size) != 0) {
+    scString msg(anon_shm_error("ftruncate"));
+    closeHandle();
+    throw scError(msg);
+  }
+
+  mapMemory();
+#else
+  throw scError("Anonymous shared memory not supported on this platform");
+#endif
+}
+
+scAnonSharedMemory::scAnonSharedMemory(int a_fd, scsmAccessMode accessMode):
+  scSharedMemory(accessMode, 0), m_fd(a_fd), m_address(SC_NULL)
+{
+#ifdef SCSHM_MEMFD
+  struct stat st;
+  if (fstat(m_fd, &st) != 0) {
+    scString msg(anon_shm_error("fstat"));
+    closeHandle();
+    throw scError(msg);
+  }
+  m_size = static_cast<size_t>(st.st_size);
+
+  // write-sealed block cannot be mapped for writing
+  if (isSealed(scsmSealWrite))
+    m_accessMode = scsmReadOnly;
+
+  mapMemory();
+#else
+  throw scError("Anonymous shared memory not supported on this platform");
+#endif
+}
+
+scAnonSharedMemory::~scAnonSharedMemory()
+{
+  freeResource();
+}
+
+scString scAnonSharedMemory::getKeyName()
+{
+#ifdef SCSHM_MEMFD
+  struct stat st;
+  if ((m_fd >= 0) && (fstat(m_fd, &st) == 0))
+    return scString("shmfd:")+toString(st.st_ino);
+#endif
+  return scString("shmfd:")+m_path;
+}
+
+void *scAnonSharedMemory::getAddress()
+{
+  return m_address;
+}
+
+int scAnonSharedMemory::getHandle()
+{
+  return m_fd;
+}
+
+void scAnonSharedMemory::freeResource()
+{
+  unmapMemory();
+  closeHandle();
+}
+
+void scAnonSharedMemory::mapMemory()
+{
+#ifdef SCSHM_MEMFD
+  if (m_size == 0)
+    return;
+
+  int prot = (m_accessMode == scsmReadOnly)?PROT_READ:(PROT_READ | PROT_WRITE);
+  void *res = mmap(SC_NULL, m_size, prot, MAP_SHARED, m_fd, 0);
+  if (res == MAP_FAILED) {
+    scString msg(anon_shm_error("mmap"));
+    closeHandle();
+    throw scError(msg);
+  }
+  m_address = res;
+#endif
+}
+
+void scAnonSharedMemory::unmapMemory()
+{
+#ifdef SCSHM_MEMFD
+  if (m_address != SC_NULL)
+    munmap(m_address, m_size);
+#endif
+  m_address = SC_NULL;
+}
+
+void scAnonSharedMemory::remapInPlace(bool writable)
+{
+#ifdef SCSHM_MEMFD
+  // mapping of read-only descriptor is not counted as writable by kernel,
+  // MAP_FIXED replaces old mapping atomically - no window without mapping
+  int fd = m_fd;
+  if (!writable) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/self/fd/%d", m_fd);
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      throw scError(anon_shm_error("open"));
+  }
+
+  int prot = writable?(PROT_READ | PROT_WRITE):PROT_READ;
+  void *res = mmap(m_address, m_size, prot, MAP_SHARED | MAP_FIXED, fd, 0);
+  scString msg(anon_shm_error("mmap"));
+
+  if (fd != m_fd)
+    close(fd);
+
+  if (res == MAP_FAILED)
+    throw scError(msg);
+#endif
+}
+
+void scAnonSharedMemory::closeHandle()
+{
+#ifdef SCSHM_MEMFD
+  if (m_fd >= 0)
+    close(m_fd);
+#endif
+  m_fd = -1;
+}
+
+void scAnonSharedMemory::seal(uint sealFlags)
+{
+#ifdef SCSHM_MEMFD
+  // write seal requires that no writable shared mapping exists
+  bool remap = ((sealFlags & scsmSealWrite) != 0) && (m_accessMode != scsmReadOnly) && (m_address != SC_NULL);
+  if (remap)
+    // address is kept, pointers handed out earlier stay valid
+    remapInPlace(false);
+
+  if (fcntl(m_fd, F_ADD_SEALS, anon_shm_seals_to_os(sealFlags)) != 0) {
+    scString msg(anon_shm_error("F_ADD_SEALS"));
+    if (remap)
+      remapInPlace(true);
+    throw scError(msg);
+  }
+
+  if ((sealFlags & scsmSealWrite) != 0)
+    m_accessMode = scsmReadOnly;
+#else
+  throw scError("Anonymous shared memory not supported on this platform");
+#endif
+}
+
+uint scAnonSharedMemory::getSeals()
+{
+#ifdef SCSHM_MEMFD
+  int res = fcntl(m_fd, F_GET_SEALS);
+  if (res < 0)
+    return 0;
+  return anon_shm_seals_from_os(static_cast<uint>(res));
+#else
+  return 0;
+#endif
+}
+
+bool scAnonSharedMemory::isSealed(uint sealFlags)
+{
+  return ((getSeals() & sealFlags) == sealFlags);
+}
+
+void scAnonSharedMemory::setInheritable(bool value)
+{
+#ifdef SCSHM_MEMFD
+  int flags = fcntl(m_fd, F_GETFD);
+  if (flags < 0)
+    throw scError(anon_shm_error("F_GETFD"));
+  if (value)
+    flags &= ~FD_CLOEXEC;
+  else
+    flags |= FD_CLOEXEC;
+  if (fcntl(m_fd, F_SETFD, flags) != 0)
+    throw scError(anon_shm_error("F_SETFD"));
+#endif
+}
+
+void scAnonSharedMemory::sendTo(int socketFd)
+{
+#ifdef SCSHM_MEMFD
+  // at least one byte of data needs to be sent together with descriptor
+  char data = 'M';
+  struct iovec iov;
+  iov.iov_base = &data;
+  iov.iov_len = sizeof(data);
+
+  char control[CMSG_SPACE(sizeof(int))];
+  std::memset(control, 0, sizeof(control));
+
+  struct msghdr msg;
+  std::memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+  std::memcpy(CMSG_DATA(cmsg), &m_fd, sizeof(int));
+
+  ssize_t res;
+  do {
+    res = sendmsg(socketFd, &msg, MSG_NOSIGNAL);
+  } while ((res < 0) && (errno == EINTR));
+
+  if (res < 0)
+    throw scError(anon_shm_error("sendmsg"));
+#else
+  throw scError("Anonymous shared memory not supported on this platform");
+#endif
+}
+
+scAnonSharedMemory *scAnonSharedMemory::receiveFrom(int socketFd, scsmAccessMode accessMode)
+{
+#ifdef SCSHM_MEMFD
+  char data;
+  struct iovec iov;
+  iov.iov_base = &data;
+  iov.iov_len = sizeof(data);
+
+  char control[CMSG_SPACE(sizeof(int))];
+  std::memset(control, 0, sizeof(control));
+
+  struct msghdr msg;
+  std::memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  ssize_t res;
+  do {
+    res = recvmsg(socketFd, &msg, MSG_CMSG_CLOEXEC);
+  } while ((res < 0) && (errno == EINTR));
+
+  if (res < 0)
+    throw scError(anon_shm_error("recvmsg"));
+
+  struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+  bool hasFd = (cmsg != SC_NULL) && (cmsg->cmsg_level == SOL_SOCKET) && (cmsg->cmsg_type == SCM_RIGHTS) &&
+    (cmsg->cmsg_len >= CMSG_LEN(sizeof(int)));
+
+  int fd = -1;
+  if (hasFd)
+    std::memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+
+  // truncated control data - peer sent more descriptors than expected
+  if ((res == 0) || !hasFd || ((msg.msg_flags & MSG_CTRUNC) != 0)) {
+    if (fd >= 0)
+      close(fd);
+    throw scError("No shared memory descriptor received");
+  }
+  return new scAnonSharedMemory(fd, accessMode);
+#else
+  throw scError("Anonymous shared memory not supported on this platform");
+#endif
+}
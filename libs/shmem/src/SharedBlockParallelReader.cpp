@@ -0,0 +1,263 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        SharedBlockParallelReader.cpp
+// Project:     scLib
+// Purpose:     Parallel chunked processing of shared block payload
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#include "sc/proc/SharedBlockParallelReader.h"
+
+#include "boost/interprocess/mapped_region.hpp"
+#include <boost/interprocess/sync/scoped_lock.hpp>
+#include <boost/interprocess/detail/atomic.hpp>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "sc/utils.h"
+
+using namespace boost::interprocess::ipcdetail;
+
+typedef boost::interprocess::scoped_lock<boost::interprocess::interprocess_mutex> scShmParLock;
+
+// passes payload from block read to reader
+class ShmParallelDispatch: public scShmWinConsumerIntf {
+public:
+  ShmParallelDispatch(scShmParallelReader &reader, scShmParallelConsumerIntf *consumer):
+    scShmWinConsumerIntf(), m_reader(reader), m_consumer(consumer) {}
+
+  void process(const char *cptr, size_t size)
+  {
+    m_reader.process(cptr, size, m_consumer);
+  }
+private:
+  scShmParallelReader &m_reader;
+  scShmParallelConsumerIntf *m_consumer;
+};
+
+// ----------------------------------------------------------------------------
+// scShmParallelReader
+// ----------------------------------------------------------------------------
+scShmParallelReader::scShmParallelReader(uint threadCount):
+  m_threadCount(SC_MAX(threadCount, 1U)), m_chunkSize(SC_SHM_PAR_DEF_CHUNK_SIZE), m_boundary(SC_NULL),
+  m_jobSeq(0), m_jobWorkerCount(0), m_runningCount(0), m_stop(false), m_data(SC_NULL), m_nextChunk(0), m_failed(false)
+{
+  // calling thread is worker 0
+  m_workerArgs.resize(m_threadCount);
+  for(uint i = 1; i < m_threadCount; i++)
+  {
+    m_workerArgs[i].reader = this;
+    m_workerArgs[i].workerNo = i;
+#ifdef WIN32
+    HANDLE thread = CreateThread(SC_NULL, 0, workerEntry, &m_workerArgs[i], 0, SC_NULL);
+    if (thread == SC_NULL)
+      break;
+    m_threads.push_back(thread);
+#else
+    pthread_t *thread = new pthread_t;
+    if (pthread_create(thread, SC_NULL, workerEntry, &m_workerArgs[i]) != 0) {
+      delete thread;
+      break;
+    }
+    m_threads.push_back(thread);
+#endif
+  }
+  m_threadCount = m_threads.size() + 1;
+}
+
+scShmParallelReader::~scShmParallelReader()
+{
+  {
+    scShmParLock lock(m_mutex);
+    m_stop = true;
+    m_jobReady.notify_all();
+  }
+
+  for(size_t i = 0, epos = m_threads.size(); i != epos; i++)
+  {
+#ifdef WIN32
+    WaitForSingleObject(static_cast<HANDLE>(m_threads[i]), INFINITE);
+    CloseHandle(static_cast<HANDLE>(m_threads[i]));
+#else
+    pthread_t *thread = static_cast<pthread_t *>(m_threads[i]);
+    pthread_join(*thread, SC_NULL);
+    delete thread;
+#endif
+  }
+}
+
+void scShmParallelReader::setChunkSize(size_t value)
+{
+  m_chunkSize = SC_MAX(value, static_cast<size_t>(1));
+}
+
+void scShmParallelReader::setBoundary(scShmChunkBoundaryIntf *boundary)
+{
+  m_boundary = boundary;
+}
+
+uint scShmParallelReader::getThreadCount() const
+{
+  return m_threadCount;
+}
+
+bool scShmParallelReader::read(scSharedMemoryBlock &block, scShmParallelConsumerIntf *consumer)
+{
+  ShmParallelDispatch dispatch(*this, consumer);
+  return block.read(&dispatch);
+}
+
+bool scShmParallelReader::read(scSharedMemoryBlock &block, scShmParallelConsumerIntf *consumer, size_t aOffset, size_t aLimit)
+{
+  ShmParallelDispatch dispatch(*this, consumer);
+  return block.read(&dispatch, aOffset, aLimit);
+}
+
+bool scShmParallelReader::read(scShmBlockHandle handle, scShmParallelConsumerIntf *consumer)
+{
+  ShmParallelDispatch dispatch(*this, consumer);
+  return scSharedMemoryBlock::read(handle, &dispatch);
+}
+
+void scShmParallelReader::splitChunks(const char *data, size_t size)
+{
+  size_t pageSize = boost::interprocess::mapped_region::get_page_size();
+  size_t chunkSize = ((m_chunkSize + pageSize - 1) / pageSize) * pageSize;
+  // chunk ends are aligned to pages of memory, not to payload start
+  size_t dataAddr = reinterpret_cast<size_t>(data);
+  size_t pos = 0;
+
+  m_chunks.clear();
+  while (pos < size)
+  {
+    size_t end = ((dataAddr + pos + chunkSize) / pageSize) * pageSize - dataAddr;
+    if (end <= pos)
+      end = pos + chunkSize;
+    if (end >= size) {
+      end = size;
+    } else if (m_boundary != SC_NULL) {
+      end = m_boundary->findBoundary(data, size, end);
+      if ((end <= pos) || (end > size))
+        end = size;
+    }
+
+    Chunk chunk;
+    chunk.offset = pos;
+    chunk.size = end - pos;
+    m_chunks.push_back(chunk);
+    pos = end;
+  }
+}
+
+void scShmParallelReader::process(const char *data, size_t size, scShmParallelConsumerIntf *consumer)
+{
+  splitChunks(data, size);
+
+  m_consumers.clear();
+  for(uint i = 0; i < m_threadCount; i++)
+    m_consumers.push_back(consumer->createWorkerConsumer(i));
+
+  uint workerCount = static_cast<uint>(SC_MIN(static_cast<size_t>(m_threadCount), SC_MAX(m_chunks.size(), static_cast<size_t>(1))));
+
+  {
+    scShmParLock lock(m_mutex);
+    m_data = data;
+    m_nextChunk = 0;
+    m_failed = false;
+    m_errorMsg.clear();
+    // small payloads do not wake all threads
+    m_jobWorkerCount = workerCount;
+    m_runningCount = workerCount - 1;
+    if (m_runningCount > 0) {
+      m_jobSeq++;
+      m_jobReady.notify_all();
+    }
+  }
+
+  runWorker(0);
+
+  {
+    scShmParLock lock(m_mutex);
+    while (m_runningCount > 0)
+      m_jobDone.wait(lock);
+  }
+
+  if (m_failed) {
+    m_consumers.clear();
+    throw scError("Parallel block processing failed: "+m_errorMsg);
+  }
+
+  for(uint i = 0; i < m_threadCount; i++)
+    consumer->reduce(i, &m_consumers[i]);
+  m_consumers.clear();
+}
+
+void scShmParallelReader::runWorker(uint workerNo)
+{
+  scShmWinConsumerIntf &consumer = m_consumers[workerNo];
+  boost::uint32_t chunkCount = m_chunks.size();
+
+  try {
+    for(;;) {
+      boost::uint32_t chunkNo = atomic_inc32(&m_nextChunk);
+      if (chunkNo >= chunkCount)
+        break;
+      consumer.process(m_data + m_chunks[chunkNo].offset, m_chunks[chunkNo].size);
+    }
+  }
+  catch(std::exception &e) {
+    scShmParLock lock(m_mutex);
+    if (!m_failed)
+      m_errorMsg = e.what();
+    m_failed = true;
+    atomic_write32(&m_nextChunk, chunkCount);
+  }
+  catch(...) {
+    scShmParLock lock(m_mutex);
+    if (!m_failed)
+      m_errorMsg = "unknown error";
+    m_failed = true;
+    atomic_write32(&m_nextChunk, chunkCount);
+  }
+}
+
+void scShmParallelReader::workerLoop(uint workerNo)
+{
+  uint seenJobSeq = 0;
+
+  for(;;) {
+    {
+      scShmParLock lock(m_mutex);
+      while (!m_stop && (m_jobSeq == seenJobSeq))
+        m_jobReady.wait(lock);
+      if (m_stop)
+        return;
+      seenJobSeq = m_jobSeq;
+      // job does not need this worker
+      if (workerNo >= m_jobWorkerCount)
+        continue;
+    }
+
+    runWorker(workerNo);
+
+    scShmParLock lock(m_mutex);
+    if (--m_runningCount == 0)
+      m_jobDone.notify_all();
+  }
+}
+
+#ifdef WIN32
+unsigned long __stdcall scShmParallelReader::workerEntry(void *arg)
+#else
+void *scShmParallelReader::workerEntry(void *arg)
+#endif
+{
+  WorkerArg *workerArg = static_cast<WorkerArg *>(arg);
+  workerArg->reader->workerLoop(workerArg->workerNo);
+  return 0;
+}
@@ -0,0 +1,689 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        SharedBlockReplication.cpp
+// Project:     scLib
+// Purpose:     Replication of shared memory blocks to another host over TCP
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#include "sc/proc/SharedBlockReplication.h"
+
+#include <cstring>
+#include <algorithm>
+
+#ifdef WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+typedef SOCKET scShmReplSocket;
+typedef int scShmReplSockLen;
+#define SC_SHM_REPL_CLOSE closesocket
+#else
+#include <errno.h>
+#include <netdb.h>
+#include <time.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+typedef int scShmReplSocket;
+typedef socklen_t scShmReplSockLen;
+#define INVALID_SOCKET (-1)
+#define SC_SHM_REPL_CLOSE ::close
+#endif
+
+#include "sc/utils.h"
+
+// ----------------------------------------------------------------------------
+// protocol
+// ----------------------------------------------------------------------------
+enum scShmReplFrameType {
+  srftBlock = 1,   // blockNo, offset = name length, value = block size, data = name
+  srftChunk = 2,   // blockNo, offset, value = length, data = chunk
+  srftCommit = 3,  // value = version
+  srftAck = 4      // value = version, receiver -> sender
+};
+
+struct scShmReplFrame {
+  boost::uint32_t type;
+  boost::uint32_t blockNo;
+  boost::uint64_t offset;
+  boost::uint64_t value;
+};
+
+struct scShmReplConnection {
+  scShmReplConnection(scShmReplSocket a_socket): socket(a_socket) {}
+  ~scShmReplConnection() { SC_SHM_REPL_CLOSE(socket); }
+  scShmReplSocket socket;
+};
+
+static void shm_repl_init_sockets()
+{
+#ifdef WIN32
+  static bool initDone = false;
+  if (!initDone) {
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+      throw scError("Winsock initialization failed");
+    initDone = true;
+  }
+#endif
+}
+
+static void shm_repl_send_all(scShmReplSocket sock, const char *data, size_t size)
+{
+  while (size > 0) {
+    int sent = ::send(sock, data, static_cast<int>(SC_MIN(size, static_cast<size_t>(1024 * 1024 * 1024))), 0);
+    if (sent <= 0) {
+#ifndef WIN32
+      if ((sent < 0) && (errno == EINTR))
+        continue;
+#endif
+      throw scError("Replication send failed");
+    }
+    data += sent;
+    size -= sent;
+  }
+}
+
+/// Returns false if connection was closed before any data was received
+static bool shm_repl_recv_all(scShmReplSocket sock, char *data, size_t size)
+{
+  size_t total = 0;
+  while (total < size) {
+    int received = ::recv(sock, data + total, static_cast<int>(SC_MIN(size - total, static_cast<size_t>(1024 * 1024 * 1024))), 0);
+    if (received == 0) {
+      if (total == 0)
+        return false;
+      throw scError("Replication connection closed inside of frame");
+    }
+    if (received < 0) {
+#ifndef WIN32
+      if (errno == EINTR)
+        continue;
+#endif
+      throw scError("Replication receive failed");
+    }
+    total += received;
+  }
+  return true;
+}
+
+/// timeoutMs < 0 means infinite
+static bool shm_repl_wait_readable(scShmReplSocket sock, int timeoutMs)
+{
+  fd_set readSet;
+  FD_ZERO(&readSet);
+  FD_SET(sock, &readSet);
+  struct timeval tv;
+  tv.tv_sec = (timeoutMs > 0)?timeoutMs / 1000:0;
+  tv.tv_usec = (timeoutMs > 0)?(timeoutMs % 1000) * 1000:0;
+  int res = select(static_cast<int>(sock) + 1, &readSet, SC_NULL, SC_NULL, (timeoutMs < 0)?SC_NULL:&tv);
+  return (res > 0);
+}
+
+static void shm_repl_set_no_delay(scShmReplSocket sock)
+{
+  int flag = 1;
+  setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char *>(&flag), sizeof(flag));
+}
+
+static void shm_repl_resolve(const scString &host, uint port, struct sockaddr_in &addr)
+{
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(static_cast<unsigned short>(port));
+
+  struct addrinfo hints, *info;
+  std::memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  if ((getaddrinfo(host.c_str(), SC_NULL, &hints, &info) != 0) || (info == SC_NULL))
+    throw scError("Cannot resolve host: ["+host+"]");
+  addr.sin_addr = reinterpret_cast<struct sockaddr_in *>(info->ai_addr)->sin_addr;
+  freeaddrinfo(info);
+}
+
+static boost::uint64_t shm_repl_clock_ms()
+{
+#ifdef WIN32
+  LARGE_INTEGER counter, freq;
+  QueryPerformanceCounter(&counter);
+  QueryPerformanceFrequency(&freq);
+  return counter.QuadPart / (freq.QuadPart / 1000);
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<boost::uint64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+#endif
+}
+
+/// Returns non-zero checksum, 0 is used for "not sent yet"
+static boost::uint64_t shm_repl_checksum(const char *data, size_t size)
+{
+  const boost::uint64_t prime = 1099511628211ULL;
+  boost::uint64_t res = 14695981039346656037ULL;
+  size_t i = 0;
+  boost::uint64_t word;
+
+  for(; i + sizeof(word) <= size; i += sizeof(word)) {
+    std::memcpy(&word, data + i, sizeof(word));
+    res = (res ^ word) * prime;
+  }
+  for(; i < size; i++)
+    res = (res ^ static_cast<unsigned char>(data[i])) * prime;
+
+  return res | 1;
+}
+
+class scShmReplStagedBlockPred {
+public:
+  scShmReplStagedBlockPred(uint blockNo): m_blockNo(blockNo) {}
+  template<typename T>
+  bool operator()(const T &chunk) const { return chunk.blockNo == m_blockNo; }
+private:
+  uint m_blockNo;
+};
+
+// ----------------------------------------------------------------------------
+// scShmReplicationSender
+// ----------------------------------------------------------------------------
+scShmReplicationSender::scShmReplicationSender(const scString &commitPath, size_t chunkSize,
+  size_t batchSize, uint maxInFlight):
+  m_record(commitPath, 0),
+  m_chunkSize(chunkSize), m_batchSize(batchSize), m_maxInFlight(SC_MAX(maxInFlight, 1U)),
+  m_sourceVersion(0), m_sentVersion(0), m_ackedVersion(0), m_versionSent(false), m_sentBytes(0)
+{
+  if (m_chunkSize == 0)
+    throw scError("Incorrect replication chunk size");
+  shm_repl_init_sockets();
+}
+
+scShmReplicationSender::~scShmReplicationSender()
+{
+}
+
+void scShmReplicationSender::addBlock(const scString &path, size_t size)
+{
+  std::auto_ptr<ReplBlock> block(new ReplBlock());
+  block->path = path;
+  block->size = size;
+  block->memory.reset(new scSharedMemory(path, scsmReadOnly, 0, size));
+  block->checksums.resize((size + m_chunkSize - 1) / m_chunkSize, 0);
+  m_blocks.push_back(block.release());
+
+  if (isConnected()) {
+    appendFrame(srftBlock, m_blocks.size() - 1, path.length(), size, path.c_str(), path.length());
+    flush();
+  }
+}
+
+void scShmReplicationSender::connect(const scString &host, uint port)
+{
+  disconnect();
+
+  struct sockaddr_in addr;
+  shm_repl_resolve(host, port, addr);
+
+  scShmReplSocket sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (sock == INVALID_SOCKET)
+    throw scError("Cannot create replication socket");
+  std::auto_ptr<scShmReplConnection> connection(new scShmReplConnection(sock));
+
+  if (::connect(sock, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0)
+    throw scError("Cannot connect to replication receiver: ["+host+":"+toString(port)+"]");
+  shm_repl_set_no_delay(sock);
+
+  m_connection = connection;
+  m_inFlight.clear();
+  m_recvBuffer.clear();
+  m_versionSent = false;
+  m_ackedVersion = 0;
+  sendBlockList();
+}
+
+void scShmReplicationSender::disconnect()
+{
+  m_connection.reset();
+  m_sendBuffer.clear();
+}
+
+bool scShmReplicationSender::isConnected() const
+{
+  return (m_connection.get() != SC_NULL);
+}
+
+void scShmReplicationSender::sendBlockList()
+{
+  // new receiver gets full contents
+  for(uint i = 0, epos = m_blocks.size(); i < epos; i++)
+  {
+    ReplBlock &block = m_blocks[i];
+    std::fill(block.checksums.begin(), block.checksums.end(), 0);
+    appendFrame(srftBlock, i, block.path.length(), block.size, block.path.c_str(), block.path.length());
+  }
+  flush();
+}
+
+bool scShmReplicationSender::replicate()
+{
+  if (!isConnected())
+    throw scError("Replication sender not connected");
+
+  readAcks(0);
+
+  m_sourceVersion = m_record.getCommitCount();
+  if (m_versionSent && (m_sourceVersion == m_sentVersion))
+    return false;
+
+  // window full - wait for receiver, do not buffer versions
+  if (m_inFlight.size() >= m_maxInFlight)
+    return false;
+
+  sendVersion();
+  return true;
+}
+
+void scShmReplicationSender::sendVersion()
+{
+  boost::uint64_t observedTime = shm_repl_clock_ms();
+  scShmCommitSeq seq;
+
+  // chunks sent from a torn read are resent in next pass,
+  // receiver keeps them invisible until commit frame
+  do {
+    seq = m_record.beginRead();
+    for(uint i = 0, epos = m_blocks.size(); i < epos; i++)
+      sendChanges(i);
+  } while (!m_record.validate(seq));
+
+  scShmCommitSeq version = seq / 2;
+  appendFrame(srftCommit, 0, 0, version, SC_NULL, 0);
+  flush();
+
+  InFlightVersion item;
+  item.version = version;
+  item.observedTime = observedTime;
+  m_inFlight.push_back(item);
+
+  m_sentVersion = m_sourceVersion = version;
+  m_versionSent = true;
+}
+
+bool scShmReplicationSender::sendChanges(uint blockNo)
+{
+  ReplBlock &block = m_blocks[blockNo];
+  const char *data = static_cast<const char *>(block.memory->getAddress());
+  bool res = false;
+
+  for(size_t i = 0, epos = block.checksums.size(); i < epos; i++)
+  {
+    size_t offset = i * m_chunkSize;
+    size_t size = SC_MIN(m_chunkSize, block.size - offset);
+    boost::uint64_t checksum = shm_repl_checksum(data + offset, size);
+    if (checksum == block.checksums[i])
+      continue;
+
+    appendFrame(srftChunk, blockNo, offset, size, data + offset, size);
+    block.checksums[i] = checksum;
+    res = true;
+  }
+
+  return res;
+}
+
+void scShmReplicationSender::appendFrame(boost::uint32_t type, boost::uint32_t blockNo, boost::uint64_t offset, boost::uint64_t value,
+  const void *data, size_t dataSize)
+{
+  if (!m_sendBuffer.empty() && (m_sendBuffer.size() + sizeof(scShmReplFrame) + dataSize > m_batchSize))
+    flush();
+
+  scShmReplFrame frame;
+  frame.type = type;
+  frame.blockNo = blockNo;
+  frame.offset = offset;
+  frame.value = value;
+
+  const char *framePtr = reinterpret_cast<const char *>(&frame);
+  m_sendBuffer.insert(m_sendBuffer.end(), framePtr, framePtr + sizeof(frame));
+  if (dataSize > 0)
+    m_sendBuffer.insert(m_sendBuffer.end(), static_cast<const char *>(data), static_cast<const char *>(data) + dataSize);
+}
+
+void scShmReplicationSender::flush()
+{
+  if (m_sendBuffer.empty() || !isConnected())
+    return;
+
+  try {
+    shm_repl_send_all(m_connection->socket, &m_sendBuffer[0], m_sendBuffer.size());
+  }
+  catch(...) {
+    disconnect();
+    throw;
+  }
+  m_sentBytes += m_sendBuffer.size();
+  m_sendBuffer.clear();
+}
+
+void scShmReplicationSender::readAcks(uint timeoutMs)
+{
+  char buffer[4096];
+  int waitTime = timeoutMs;
+
+  while (isConnected() && shm_repl_wait_readable(m_connection->socket, waitTime))
+  {
+    waitTime = 0;
+    int received = ::recv(m_connection->socket, buffer, sizeof(buffer), 0);
+    if (received <= 0) {
+      disconnect();
+      throw scError("Replication receiver closed connection");
+    }
+    m_recvBuffer.insert(m_recvBuffer.end(), buffer, buffer + received);
+
+    size_t frameCount = m_recvBuffer.size() / sizeof(scShmReplFrame);
+    for(size_t i = 0; i < frameCount; i++)
+    {
+      scShmReplFrame frame;
+      std::memcpy(&frame, &m_recvBuffer[i * sizeof(frame)], sizeof(frame));
+      if (frame.type != srftAck)
+        continue;
+
+      m_ackedVersion = static_cast<scShmCommitSeq>(frame.value);
+      while (!m_inFlight.empty() && (static_cast<boost::int32_t>(m_inFlight.front().version - m_ackedVersion) <= 0))
+        m_inFlight.pop_front();
+    }
+    m_recvBuffer.erase(m_recvBuffer.begin(), m_recvBuffer.begin() + frameCount * sizeof(scShmReplFrame));
+  }
+}
+
+scShmCommitSeq scShmReplicationSender::getSourceVersion() const
+{
+  return m_sourceVersion;
+}
+
+scShmCommitSeq scShmReplicationSender::getAckedVersion() const
+{
+  return m_ackedVersion;
+}
+
+scShmCommitSeq scShmReplicationSender::getVersionLag() const
+{
+  return m_sourceVersion - m_ackedVersion;
+}
+
+uint scShmReplicationSender::getLagMs() const
+{
+  if (m_inFlight.empty())
+    return 0;
+  return static_cast<uint>(shm_repl_clock_ms() - m_inFlight.front().observedTime);
+}
+
+boost::uint64_t scShmReplicationSender::getSentBytes() const
+{
+  return m_sentBytes;
+}
+
+// ----------------------------------------------------------------------------
+// scShmReplicationReceiver
+// ----------------------------------------------------------------------------
+scShmReplicationReceiver::scShmReplicationReceiver(const scString &commitPath, const scString &blockPrefix,
+  size_t maxStageSize, size_t maxBlockSize):
+  m_record(commitPath, scsmCreate), m_blockPrefix(blockPrefix),
+  m_maxStageSize(maxStageSize), m_maxBlockSize(maxBlockSize), m_directVersion(false),
+  m_appliedVersion(0), m_receivedBytes(0)
+{
+  shm_repl_init_sockets();
+}
+
+scShmReplicationReceiver::~scShmReplicationReceiver()
+{
+  close();
+}
+
+uint scShmReplicationReceiver::listen(const scString &host, uint port)
+{
+  struct sockaddr_in addr;
+  shm_repl_resolve(host, port, addr);
+
+  scShmReplSocket sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (sock == INVALID_SOCKET)
+    throw scError("Cannot create replication socket");
+  std::auto_ptr<scShmReplConnection> listener(new scShmReplConnection(sock));
+
+  int flag = 1;
+  setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char *>(&flag), sizeof(flag));
+
+  if ((::bind(sock, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0) || (::listen(sock, 1) != 0))
+    throw scError("Cannot listen on: ["+host+":"+toString(port)+"]");
+
+  scShmReplSockLen addrLen = sizeof(addr);
+  getsockname(sock, reinterpret_cast<struct sockaddr *>(&addr), &addrLen);
+
+  m_listener = listener;
+  return ntohs(addr.sin_port);
+}
+
+bool scShmReplicationReceiver::accept(uint timeoutMs)
+{
+  if (m_listener.get() == SC_NULL)
+    throw scError("Replication receiver not listening");
+
+  if (!shm_repl_wait_readable(m_listener->socket, (timeoutMs > 0)?static_cast<int>(timeoutMs):-1))
+    return false;
+
+  scShmReplSocket sock = ::accept(m_listener->socket, SC_NULL, SC_NULL);
+  if (sock == INVALID_SOCKET)
+    throw scError("Replication accept failed");
+  shm_repl_set_no_delay(sock);
+
+  close();
+  m_connection.reset(new scShmReplConnection(sock));
+  return true;
+}
+
+void scShmReplicationReceiver::close()
+{
+  // incomplete staged version is never applied, direct one is already partly written
+  if (m_directVersion) {
+    m_directVersion = false;
+    m_record.endCommit();
+  }
+  m_stagedChunks.clear();
+  m_stageBuffer.clear();
+  m_connection.reset();
+}
+
+bool scShmReplicationReceiver::receive(uint timeoutMs)
+{
+  if (m_connection.get() == SC_NULL)
+    throw scError("Replication receiver not connected");
+
+  if (!shm_repl_wait_readable(m_connection->socket, timeoutMs))
+    return true;
+
+  do {
+    if (!processFrame()) {
+      close();
+      return false;
+    }
+  } while (shm_repl_wait_readable(m_connection->socket, 0));
+
+  return true;
+}
+
+bool scShmReplicationReceiver::processFrame()
+{
+  scShmReplFrame frame;
+  if (!shm_repl_recv_all(m_connection->socket, reinterpret_cast<char *>(&frame), sizeof(frame)))
+    return false;
+  m_receivedBytes += sizeof(frame);
+
+  switch (frame.type) {
+    case srftBlock: {
+      if (frame.offset > SC_SHM_REPL_MAX_NAME_LEN)
+        throw scError(scString("Replicated block name too long: ")+toString(frame.blockNo));
+      if (frame.value > m_maxBlockSize)
+        throw scError(scString("Replicated block too large: ")+toString(frame.blockNo));
+      std::vector<char> name(static_cast<size_t>(frame.offset));
+      if (!name.empty() && !shm_repl_recv_all(m_connection->socket, &name[0], name.size()))
+        return false;
+      m_receivedBytes += name.size();
+      openBlock(frame.blockNo, scString(name.begin(), name.end()), static_cast<size_t>(frame.value));
+      break;
+    }
+    case srftChunk:
+      if (!stageChunk(frame.blockNo, frame.offset, frame.value))
+        return false;
+      break;
+    case srftCommit:
+      applyVersion(static_cast<scShmCommitSeq>(frame.value));
+      break;
+    default:
+      throw scError(scString("Unknown replication frame: ")+toString(frame.type));
+  }
+
+  return true;
+}
+
+void scShmReplicationReceiver::openBlock(uint blockNo, const scString &name, size_t size)
+{
+  scString localName = m_blockPrefix + name;
+
+  BlockMap::iterator it = m_blocks.find(blockNo);
+  if ((it != m_blocks.end()) && (it->second->getSize() == size) &&
+      (it->second->getKeyName() == scString("shm:") + localName))
+    return;
+
+  // block can be already in use by local readers (or be the source block when
+  // both ends run on one host without prefix), so it is opened, not recreated
+  std::auto_ptr<scSharedMemory> memory;
+  try {
+    memory.reset(new scSharedMemory(localName, scsmReadWrite, 0, size));
+  }
+  catch(...) {
+    memory.reset();
+  }
+  if (memory.get() == SC_NULL)
+    memory.reset(new scSharedMemory(localName, scsmReadWrite, scsmCreate, size));
+  if (memory->getMappedSize() < size)
+    throw scError("Local replicated block is too small: ["+localName+"]");
+
+  if (it != m_blocks.end()) {
+    // chunks staged for old block do not apply to new one
+    std::vector<StagedChunk>::iterator epos = std::remove_if(m_stagedChunks.begin(), m_stagedChunks.end(),
+      scShmReplStagedBlockPred(blockNo));
+    m_stagedChunks.erase(epos, m_stagedChunks.end());
+    releaseMemory(it->second);
+  }
+
+  m_blocks[blockNo] = memory.get();
+  m_memories.push_back(memory.release());
+}
+
+scSharedMemory *scShmReplicationReceiver::findBlock(uint blockNo)
+{
+  BlockMap::iterator it = m_blocks.find(blockNo);
+  if (it == m_blocks.end())
+    throw scError(scString("Unknown replicated block: ")+toString(blockNo));
+  return it->second;
+}
+
+void scShmReplicationReceiver::releaseMemory(scSharedMemory *memory)
+{
+  for(boost::ptr_vector<scSharedMemory>::iterator it = m_memories.begin(), epos = m_memories.end(); it != epos; ++it)
+    if (&(*it) == memory) {
+      m_memories.erase(it);
+      break;
+    }
+}
+
+bool scShmReplicationReceiver::stageChunk(uint blockNo, boost::uint64_t offset, boost::uint64_t size)
+{
+  scSharedMemory *block = findBlock(blockNo);
+  // values come from network, offset + size could wrap
+  boost::uint64_t blockSize = block->getSize();
+  if ((size > blockSize) || (offset > blockSize - size))
+    throw scError(scString("Replicated chunk outside of block: ")+toString(blockNo));
+
+  size_t chunkSize = static_cast<size_t>(size);
+  if (!m_directVersion && (chunkSize > m_maxStageSize - SC_MIN(m_stageBuffer.size(), m_maxStageSize)))
+    beginDirectVersion();
+
+  if (m_directVersion) {
+    char *target = static_cast<char *>(block->getAddress()) + static_cast<size_t>(offset);
+    if ((chunkSize > 0) && !shm_repl_recv_all(m_connection->socket, target, chunkSize))
+      return false;
+    m_receivedBytes += chunkSize;
+    return true;
+  }
+
+  StagedChunk chunk;
+  chunk.blockNo = blockNo;
+  chunk.offset = static_cast<size_t>(offset);
+  chunk.size = chunkSize;
+  chunk.bufferPos = m_stageBuffer.size();
+
+  // local block is not touched until whole version arrives
+  m_stageBuffer.resize(chunk.bufferPos + chunkSize);
+  if ((chunkSize > 0) && !shm_repl_recv_all(m_connection->socket, &m_stageBuffer[chunk.bufferPos], chunkSize))
+    return false;
+  m_stagedChunks.push_back(chunk);
+  m_receivedBytes += chunkSize;
+  return true;
+}
+
+void scShmReplicationReceiver::beginDirectVersion()
+{
+  m_record.beginCommit();
+  m_directVersion = true;
+  applyStaged();
+}
+
+void scShmReplicationReceiver::applyStaged()
+{
+  for(std::vector<StagedChunk>::const_iterator it = m_stagedChunks.begin(), epos = m_stagedChunks.end(); it != epos; ++it)
+    if (it->size > 0)
+      std::memcpy(static_cast<char *>(findBlock(it->blockNo)->getAddress()) + it->offset,
+        &m_stageBuffer[it->bufferPos], it->size);
+
+  m_stagedChunks.clear();
+  m_stageBuffer.clear();
+}
+
+void scShmReplicationReceiver::applyVersion(scShmCommitSeq version)
+{
+  if (!m_directVersion)
+    m_record.beginCommit();
+  m_directVersion = false;
+
+  try {
+    applyStaged();
+  }
+  catch(...) {
+    m_record.endCommit();
+    throw;
+  }
+  m_record.endCommit();
+
+  m_appliedVersion = version;
+
+  scShmReplFrame frame;
+  frame.type = srftAck;
+  frame.blockNo = 0;
+  frame.offset = 0;
+  frame.value = version;
+  shm_repl_send_all(m_connection->socket, reinterpret_cast<const char *>(&frame), sizeof(frame));
+}
+
+scShmCommitSeq scShmReplicationReceiver::getAppliedVersion() const
+{
+  return m_appliedVersion;
+}
+
+boost::uint64_t scShmReplicationReceiver::getReceivedBytes() const
+{
+  return m_receivedBytes;
+}
@@ -0,0 +1,458 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        SharedLeaseTable.cpp
+// Project:     scLib
+// Purpose:     Process-death-aware reader leases in shared memory
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#include "sc/proc/SharedLeaseTable.h"
+
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+
+#include <boost/interprocess/detail/atomic.hpp>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#if defined(__linux__) && !defined(SYS_pidfd_open)
+#define SYS_pidfd_open 434
+#endif
+#endif
+
+#include "sc/utils.h"
+
+using namespace boost::interprocess::ipcdetail;
+
+// ----------------------------------------------------------------------------
+// shared layout
+// ----------------------------------------------------------------------------
+const boost::uint32_t SC_SHM_LEASE_MAGIC = 0x5C1EA501;
+const size_t SC_SHM_LEASE_ALIGN = 64;
+
+enum scShmLeaseState {
+  slsFree = 0,
+  slsClaiming = 1,    // owner set, lease data not ready yet
+  slsActive = 2,
+  slsReleasing = 3
+};
+
+struct scShmLeaseHeader {
+  boost::uint32_t magic;
+  boost::uint32_t capacity;
+};
+
+// one lease per cache line, renewals of readers do not collide
+struct scShmLeaseSlot {
+  volatile boost::uint32_t owner;      // pid, 0 = free
+  volatile boost::uint32_t state;
+  volatile boost::uint32_t renewTime;  // ms, wraps
+  boost::uint32_t reserved;
+  boost::uint64_t startTime;
+  volatile boost::uint64_t value;
+  char pad[SC_SHM_LEASE_ALIGN - 4 * sizeof(boost::uint32_t) - 2 * sizeof(boost::uint64_t)];
+};
+
+// lease found dead by reclaim, with state it was seen in
+struct scShmDeadLease {
+  scShmLeaseId lease;
+  uint pid;
+  uint state;
+  scShmDeadLease(scShmLeaseId a_lease, uint a_pid, uint a_state): lease(a_lease), pid(a_pid), state(a_state) {}
+};
+
+inline void shm_lease_fence()
+{
+#ifdef WIN32
+  MemoryBarrier();
+#else
+  __sync_synchronize();
+#endif
+}
+
+inline uint shm_lease_current_pid()
+{
+#ifdef WIN32
+  return GetCurrentProcessId();
+#else
+  return getpid();
+#endif
+}
+
+// ----------------------------------------------------------------------------
+// scShmLeaseTable
+// ----------------------------------------------------------------------------
+scShmLeaseTable::scShmLeaseTable(const scString &a_path, uint a_useFlags, uint capacity):
+  m_header(SC_NULL), m_slots(SC_NULL)
+{
+  if (capacity == 0)
+    throw scError("Incorrect lease table size: ["+a_path+"]");
+
+  size_t totalSize = SC_SHM_LEASE_ALIGN + capacity * sizeof(scShmLeaseSlot);
+  m_memory.reset(new scSharedMemory(a_path, scsmReadWrite, a_useFlags, totalSize));
+
+  char *base = static_cast<char *>(m_memory->getAddress());
+  m_header = reinterpret_cast<scShmLeaseHeader *>(base);
+  m_slots = reinterpret_cast<scShmLeaseSlot *>(base + SC_SHM_LEASE_ALIGN);
+  m_header->capacity = capacity;
+  std::memset(m_slots, 0, capacity * sizeof(scShmLeaseSlot));
+
+  shm_lease_fence();
+  atomic_write32(&m_header->magic, SC_SHM_LEASE_MAGIC);
+
+  m_pid = shm_lease_current_pid();
+  m_startTime = getProcessStartTime(m_pid);
+}
+
+scShmLeaseTable::scShmLeaseTable(const scString &a_path): m_header(SC_NULL), m_slots(SC_NULL)
+{
+  m_memory.reset(new scSharedMemory(a_path, scsmReadWrite, 0, 0));
+  attach();
+
+  m_pid = shm_lease_current_pid();
+  m_startTime = getProcessStartTime(m_pid);
+}
+
+scShmLeaseTable::~scShmLeaseTable()
+{
+  for(scShmLeaseId i = 0, epos = m_watches.size(); i < epos; i++)
+    closeWatch(i);
+}
+
+void scShmLeaseTable::attach()
+{
+  char *base = static_cast<char *>(m_memory->getAddress());
+  m_header = reinterpret_cast<scShmLeaseHeader *>(base);
+  m_slots = reinterpret_cast<scShmLeaseSlot *>(base + SC_SHM_LEASE_ALIGN);
+  if (atomic_read32(&m_header->magic) != SC_SHM_LEASE_MAGIC)
+    throw scError("Shared lease table not initialized");
+}
+
+scShmLeaseSlot *scShmLeaseTable::getSlot(scShmLeaseId lease) const
+{
+  if (lease >= m_header->capacity)
+    throw scError(scString("Incorrect lease: ")+toString(lease));
+  return m_slots + lease;
+}
+
+scShmLeaseId scShmLeaseTable::acquire(boost::uint64_t value)
+{
+  for(scShmLeaseId i = 0, epos = m_header->capacity; i < epos; i++)
+  {
+    scShmLeaseSlot *slot = m_slots + i;
+    if (atomic_read32(&slot->owner) != 0)
+      continue;
+    if (atomic_cas32(&slot->owner, m_pid, 0) != 0)
+      continue;
+
+    atomic_write32(&slot->state, slsClaiming);
+    slot->startTime = m_startTime;
+    slot->value = value;
+    slot->renewTime = static_cast<boost::uint32_t>(getClockMs());
+    shm_lease_fence();
+    atomic_write32(&slot->state, slsActive);
+    return i;
+  }
+
+  return SC_SHM_NULL_LEASE;
+}
+
+bool scShmLeaseTable::renew(scShmLeaseId lease)
+{
+  scShmLeaseSlot *slot = getSlot(lease);
+  if ((atomic_read32(&slot->owner) != m_pid) || (atomic_read32(&slot->state) != slsActive))
+    return false;
+  atomic_write32(&slot->renewTime, static_cast<boost::uint32_t>(getClockMs()));
+  // lease lost meanwhile - stray renew time only delays timeout of new owner once
+  shm_lease_fence();
+  return (atomic_read32(&slot->owner) == m_pid) && (atomic_read32(&slot->state) == slsActive);
+}
+
+bool scShmLeaseTable::setValue(scShmLeaseId lease, boost::uint64_t value)
+{
+  scShmLeaseSlot *slot = getSlot(lease);
+  if (atomic_read32(&slot->owner) != m_pid)
+    return false;
+  // claiming lease of live owner is not reclaimed, so value cannot land in other owner's lease
+  if (atomic_cas32(&slot->state, slsClaiming, slsActive) != slsActive)
+    return false;
+  if (atomic_read32(&slot->owner) != m_pid) {
+    atomic_cas32(&slot->state, slsActive, slsClaiming);
+    return false;
+  }
+
+  slot->value = value;
+  slot->renewTime = static_cast<boost::uint32_t>(getClockMs());
+  shm_lease_fence();
+  atomic_write32(&slot->state, slsActive);
+  return true;
+}
+
+void scShmLeaseTable::release(scShmLeaseId lease)
+{
+  scShmLeaseSlot *slot = getSlot(lease);
+  // lease could be already taken away by writer
+  if (atomic_cas32(&slot->state, slsReleasing, slsActive) != slsActive)
+    return;
+  atomic_write32(&slot->state, slsFree);
+  shm_lease_fence();
+  atomic_write32(&slot->owner, 0);
+}
+
+void scShmLeaseTable::freeSlot(scShmLeaseId lease, uint pid, uint state, scShmLeaseReclaimIntf *handler)
+{
+  scShmLeaseSlot *slot = m_slots + lease;
+  // lease could be released and taken by other process since it was checked
+  if (atomic_read32(&slot->owner) != pid)
+    return;
+  // state changed - e.g. owner is in setValue, decision made on old state is not valid
+  if (state == slsReleasing)
+    return;
+  if (atomic_cas32(&slot->state, slsReleasing, state) != state)
+    return;
+
+  try {
+    if ((handler != SC_NULL) && (state == slsActive))
+      handler->reclaimed(lease, pid, slot->value);
+  }
+  catch(...) {
+    atomic_write32(&slot->state, slsFree);
+    shm_lease_fence();
+    atomic_write32(&slot->owner, 0);
+    throw;
+  }
+  atomic_write32(&slot->state, slsFree);
+  shm_lease_fence();
+  atomic_write32(&slot->owner, 0);
+}
+
+uint scShmLeaseTable::reclaim(scShmLeaseReclaimIntf *handler, uint renewTimeoutMs)
+{
+  uint capacity = m_header->capacity;
+  boost::uint32_t now = static_cast<boost::uint32_t>(getClockMs());
+  std::vector<scShmDeadLease> dead;
+
+#ifndef WIN32
+  std::vector<struct pollfd> pollFds;
+  std::vector<scShmLeaseId> polled;
+#endif
+
+  if (m_watches.size() < capacity) {
+    OwnerWatch watch;
+    watch.handle = -1;
+    watch.pid = 0;
+    watch.startTime = 0;
+    m_watches.resize(capacity, watch);
+  }
+
+  for(scShmLeaseId i = 0; i < capacity; i++)
+  {
+    scShmLeaseSlot *slot = m_slots + i;
+    uint pid = atomic_read32(&slot->owner);
+    if (pid == 0) {
+      closeWatch(i);
+      continue;
+    }
+
+    // free with owner set - owner died in acquire or release
+    boost::uint32_t state = atomic_read32(&slot->state);
+    if (state == slsReleasing)
+      continue;
+
+    shm_lease_fence();
+    boost::uint64_t startTime = (state == slsActive)?slot->startTime:0;
+
+    if ((renewTimeoutMs > 0) && (state == slsActive) &&
+        (now - atomic_read32(&slot->renewTime) > renewTimeoutMs)) {
+      dead.push_back(scShmDeadLease(i, pid, state));
+      continue;
+    }
+
+    if (!isOwnerAlive(i, pid, startTime)) {
+      dead.push_back(scShmDeadLease(i, pid, state));
+      continue;
+    }
+
+#ifndef WIN32
+    if (m_watches[i].handle >= 0) {
+      struct pollfd pfd;
+      pfd.fd = m_watches[i].handle;
+      pfd.events = POLLIN;
+      pfd.revents = 0;
+      pollFds.push_back(pfd);
+      polled.push_back(i);
+    }
+#endif
+  }
+
+#ifndef WIN32
+  // pidfd becomes readable when process exits
+  if (!pollFds.empty() && (poll(&pollFds[0], pollFds.size(), 0) > 0)) {
+    for(size_t i = 0, epos = pollFds.size(); i < epos; i++)
+      if ((pollFds[i].revents & (POLLIN | POLLHUP | POLLERR)) != 0)
+        // only active leases are watched
+        dead.push_back(scShmDeadLease(polled[i], m_watches[polled[i]].pid, slsActive));
+  }
+#endif
+
+  for(std::vector<scShmDeadLease>::const_iterator it = dead.begin(), epos = dead.end(); it != epos; ++it)
+  {
+    closeWatch(it->lease);
+    freeSlot(it->lease, it->pid, it->state, handler);
+  }
+
+  return dead.size();
+}
+
+bool scShmLeaseTable::isOwnerAlive(scShmLeaseId lease, uint pid, boost::uint64_t startTime)
+{
+  OwnerWatch &watch = m_watches[lease];
+
+  // already watched - checked by poll()
+  if ((watch.handle >= 0) && (watch.pid == pid) && (watch.startTime == startTime))
+    return true;
+  closeWatch(lease);
+
+#ifdef WIN32
+  boost::uint64_t currStartTime = getProcessStartTime(pid);
+  if (currStartTime == 0)
+    return false;
+  return ((startTime == 0) || (currStartTime == startTime));
+#else
+  int fd = -1;
+#ifdef SYS_pidfd_open
+  fd = syscall(SYS_pidfd_open, pid, 0);
+  if ((fd < 0) && (errno == ESRCH))
+    return false;
+#endif
+  if ((fd < 0) && (kill(pid, 0) != 0) && (errno == ESRCH))
+    return false;
+
+  // checked after pidfd is open, so it refers to the same process
+  boost::uint64_t currStartTime = getProcessStartTime(pid);
+  if ((currStartTime == 0) || ((startTime != 0) && (currStartTime != startTime))) {
+    if (fd >= 0)
+      close(fd);
+    return false;
+  }
+
+  // claiming lease is checked again when its start time is known
+  if ((fd >= 0) && (startTime != 0)) {
+    watch.handle = fd;
+    watch.pid = pid;
+    watch.startTime = startTime;
+  } else if (fd >= 0) {
+    close(fd);
+  }
+  return true;
+#endif
+}
+
+void scShmLeaseTable::closeWatch(scShmLeaseId lease)
+{
+  if (lease >= m_watches.size())
+    return;
+  OwnerWatch &watch = m_watches[lease];
+#ifndef WIN32
+  if (watch.handle >= 0)
+    close(watch.handle);
+#endif
+  watch.handle = -1;
+  watch.pid = 0;
+  watch.startTime = 0;
+}
+
+bool scShmLeaseTable::getMinValue(boost::uint64_t &output) const
+{
+  bool res = false;
+  for(scShmLeaseId i = 0, epos = m_header->capacity; i < epos; i++)
+  {
+    scShmLeaseSlot *slot = m_slots + i;
+    if (atomic_read32(&slot->state) != slsActive)
+      continue;
+    shm_lease_fence();
+    boost::uint64_t value = slot->value;
+    if (!res || (value < output))
+      output = value;
+    res = true;
+  }
+  return res;
+}
+
+uint scShmLeaseTable::getActiveCount() const
+{
+  uint res = 0;
+  for(scShmLeaseId i = 0, epos = m_header->capacity; i < epos; i++)
+    if (atomic_read32(&m_slots[i].state) == slsActive)
+      res++;
+  return res;
+}
+
+uint scShmLeaseTable::getCapacity() const
+{
+  return m_header->capacity;
+}
+
+boost::uint64_t scShmLeaseTable::getProcessStartTime(uint pid)
+{
+#ifdef WIN32
+  HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION | SYNCHRONIZE, FALSE, pid);
+  if (process == SC_NULL)
+    return 0;
+  FILETIME creationTime, exitTime, kernelTime, userTime;
+  boost::uint64_t res = 0;
+  if (GetProcessTimes(process, &creationTime, &exitTime, &kernelTime, &userTime) &&
+      (WaitForSingleObject(process, 0) == WAIT_TIMEOUT))
+    res = (static_cast<boost::uint64_t>(creationTime.dwHighDateTime) << 32) | creationTime.dwLowDateTime;
+  CloseHandle(process);
+  return res;
+#else
+  // field 22 of /proc/<pid>/stat, in clock ticks since boot
+  char path[64];
+  std::sprintf(path, "/proc/%u/stat", pid);
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return 0;
+  char buffer[512];
+  ssize_t len = read(fd, buffer, sizeof(buffer) - 1);
+  close(fd);
+  if (len <= 0)
+    return 0;
+  buffer[len] = '\0';
+
+  // process name can contain spaces
+  char *ptr = std::strrchr(buffer, ')');
+  if (ptr == SC_NULL)
+    return 0;
+  // skip to field 22, ptr points before field 3
+  for(uint fieldNo = 2; (fieldNo < 22) && (ptr != SC_NULL); fieldNo++)
+    ptr = std::strchr(ptr + 1, ' ');
+  if (ptr == SC_NULL)
+    return 0;
+  return std::strtoull(ptr + 1, SC_NULL, 10);
+#endif
+}
+
+boost::uint64_t scShmLeaseTable::getClockMs()
+{
+#ifdef WIN32
+  LARGE_INTEGER counter, freq;
+  QueryPerformanceCounter(&counter);
+  QueryPerformanceFrequency(&freq);
+  return counter.QuadPart / (freq.QuadPart / 1000);
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<boost::uint64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+#endif
+}
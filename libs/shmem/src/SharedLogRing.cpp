@@ -0,0 +1,600 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        SharedLogRing.cpp
+// Project:     scLib
+// Purpose:     Cross-process log sink in shared memory
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#include "sc/proc/SharedLogRing.h"
+
+#include <cstring>
+#include <ctime>
+
+#include <boost/interprocess/detail/atomic.hpp>
+#include <boost/interprocess/detail/os_thread_functions.hpp>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/time.h>
+#endif
+
+#include "sc/utils.h"
+
+using namespace boost::interprocess::ipcdetail;
+
+// ----------------------------------------------------------------------------
+// shared layout
+// ----------------------------------------------------------------------------
+const boost::uint32_t SC_SHM_LOG_MAGIC = 0x5C106A02;
+const size_t SC_SHM_LOG_ALIGN = 64;
+
+struct scShmLogRingHeader {
+  boost::uint32_t magic;
+  boost::uint32_t capacity;   // power of 2
+  boost::uint32_t argsSize;
+  boost::uint32_t recordStride;
+  char pad0[SC_SHM_LOG_ALIGN - 4 * sizeof(boost::uint32_t)];
+  volatile boost::uint32_t enqueuePos;
+  char pad1[SC_SHM_LOG_ALIGN - sizeof(boost::uint32_t)];
+  volatile boost::uint32_t dequeuePos;
+  char pad2[SC_SHM_LOG_ALIGN - sizeof(boost::uint32_t)];
+  volatile boost::uint32_t dropCount;
+  volatile boost::uint32_t skipCount;
+  char pad3[SC_SHM_LOG_ALIGN - 2 * sizeof(boost::uint32_t)];
+};
+
+struct scShmLogRecordHeader {
+  volatile boost::uint32_t sequence;
+  /// position and pid of producer which claimed the slot, written right after claim
+  volatile boost::uint32_t claimPos;
+  volatile boost::uint32_t claimPid;
+  boost::uint32_t level;
+  boost::uint32_t formatId;
+  boost::uint32_t pid;
+  boost::uint64_t timestamp;
+  boost::uint32_t argsSize;
+  boost::uint32_t flags;
+};
+
+// record flags
+const boost::uint32_t SC_SHM_LOG_FLAG_TRUNCATED = 1;
+
+// argument type codes
+const char SC_SHM_LOG_ARG_INT = 'i';
+const char SC_SHM_LOG_ARG_UINT = 'u';
+const char SC_SHM_LOG_ARG_FLOAT = 'd';
+const char SC_SHM_LOG_ARG_STR = 's';
+
+inline void shm_log_fence()
+{
+#ifdef WIN32
+  MemoryBarrier();
+#else
+  __sync_synchronize();
+#endif
+}
+
+static bool shm_log_process_exists(boost::uint32_t pid)
+{
+#ifdef WIN32
+  HANDLE handle = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+  if (handle == NULL)
+    return (GetLastError() == ERROR_ACCESS_DENIED);
+  DWORD exitCode = 0;
+  bool res = (GetExitCodeProcess(handle, &exitCode) != 0) && (exitCode == STILL_ACTIVE);
+  CloseHandle(handle);
+  return res;
+#else
+  return (kill(static_cast<pid_t>(pid), 0) == 0) || (errno != ESRCH);
+#endif
+}
+
+// ----------------------------------------------------------------------------
+// scShmLogArgs
+// ----------------------------------------------------------------------------
+scShmLogArgs::scShmLogArgs(): m_size(0), m_truncated(false)
+{
+}
+
+void scShmLogArgs::addValue(char typeCode, const void *value, size_t size)
+{
+  if (m_size + 1 + size > SC_SHM_LOG_ARGS_SIZE) {
+    // keep arguments added so far parseable
+    m_truncated = true;
+    return;
+  }
+  m_data[m_size++] = typeCode;
+  std::memcpy(m_data + m_size, value, size);
+  m_size += size;
+}
+
+scShmLogArgs &scShmLogArgs::add(int value)
+{
+  return add(static_cast<boost::int64_t>(value));
+}
+
+scShmLogArgs &scShmLogArgs::add(uint value)
+{
+  return add(static_cast<boost::uint64_t>(value));
+}
+
+scShmLogArgs &scShmLogArgs::add(boost::int64_t value)
+{
+  addValue(SC_SHM_LOG_ARG_INT, &value, sizeof(value));
+  return *this;
+}
+
+scShmLogArgs &scShmLogArgs::add(boost::uint64_t value)
+{
+  addValue(SC_SHM_LOG_ARG_UINT, &value, sizeof(value));
+  return *this;
+}
+
+scShmLogArgs &scShmLogArgs::add(double value)
+{
+  addValue(SC_SHM_LOG_ARG_FLOAT, &value, sizeof(value));
+  return *this;
+}
+
+scShmLogArgs &scShmLogArgs::add(const char *value)
+{
+  const size_t prefixSize = 1 + sizeof(boost::uint16_t);
+  if (m_size + prefixSize > SC_SHM_LOG_ARGS_SIZE) {
+    m_truncated = true;
+    return *this;
+  }
+
+  // long texts are truncated to what fits
+  size_t textLen = std::strlen(value);
+  boost::uint16_t len = static_cast<boost::uint16_t>(SC_MIN(textLen, SC_SHM_LOG_ARGS_SIZE - m_size - prefixSize));
+  if (len < textLen)
+    m_truncated = true;
+
+  m_data[m_size++] = SC_SHM_LOG_ARG_STR;
+  std::memcpy(m_data + m_size, &len, sizeof(len));
+  m_size += sizeof(len);
+  std::memcpy(m_data + m_size, value, len);
+  m_size += len;
+  return *this;
+}
+
+scShmLogArgs &scShmLogArgs::add(const scString &value)
+{
+  return add(value.c_str());
+}
+
+const char *scShmLogArgs::getData() const
+{
+  return m_data;
+}
+
+size_t scShmLogArgs::getSize() const
+{
+  return m_size;
+}
+
+bool scShmLogArgs::isTruncated() const
+{
+  return m_truncated;
+}
+
+// ----------------------------------------------------------------------------
+// scShmLogRing
+// ----------------------------------------------------------------------------
+scShmLogRing::scShmLogRing(const scString &a_path, uint a_useFlags, uint recordCount, size_t argsSize):
+  m_header(SC_NULL), m_base(SC_NULL),
+  m_stallTimeoutMs(SC_SHM_LOG_DEF_STALL_TIMEOUT_MS), m_stallPos(0), m_stallSince(0), m_stalled(false)
+{
+  if (recordCount == 0)
+    throw scError("Incorrect log ring size: ["+a_path+"]");
+
+  boost::uint32_t capacity = 1;
+  while (capacity < recordCount)
+    capacity <<= 1;
+
+  size_t recordStride = ((sizeof(scShmLogRecordHeader) + argsSize + 7) / 8) * 8;
+  size_t totalSize = sizeof(scShmLogRingHeader) + capacity * recordStride;
+
+  m_memory.reset(new scSharedMemory(a_path, scsmReadWrite, a_useFlags, totalSize));
+  m_base = static_cast<char *>(m_memory->getAddress());
+  m_header = reinterpret_cast<scShmLogRingHeader *>(m_base);
+
+  m_header->capacity = capacity;
+  m_header->argsSize = static_cast<boost::uint32_t>(argsSize);
+  m_header->recordStride = static_cast<boost::uint32_t>(recordStride);
+  m_header->enqueuePos = m_header->dequeuePos = 0;
+  m_header->dropCount = 0;
+  m_header->skipCount = 0;
+
+  for(boost::uint32_t i = 0; i < capacity; i++) {
+    scShmLogRecordHeader *record = getRecord(i);
+    record->sequence = i;
+    // never equal to position of first lap
+    record->claimPos = i + capacity;
+    record->claimPid = 0;
+  }
+
+  shm_log_fence();
+  atomic_write32(&m_header->magic, SC_SHM_LOG_MAGIC);
+
+#ifdef WIN32
+  m_pid = GetCurrentProcessId();
+#else
+  m_pid = getpid();
+#endif
+}
+
+scShmLogRing::scShmLogRing(const scString &a_path): m_header(SC_NULL), m_base(SC_NULL),
+  m_stallTimeoutMs(SC_SHM_LOG_DEF_STALL_TIMEOUT_MS), m_stallPos(0), m_stallSince(0), m_stalled(false)
+{
+  m_memory.reset(new scSharedMemory(a_path, scsmReadWrite, 0, 0));
+  attach();
+
+#ifdef WIN32
+  m_pid = GetCurrentProcessId();
+#else
+  m_pid = getpid();
+#endif
+}
+
+scShmLogRing::~scShmLogRing()
+{
+}
+
+void scShmLogRing::attach()
+{
+  m_base = static_cast<char *>(m_memory->getAddress());
+  m_header = reinterpret_cast<scShmLogRingHeader *>(m_base);
+  if (atomic_read32(&m_header->magic) != SC_SHM_LOG_MAGIC)
+    throw scError("Shared log ring not initialized");
+}
+
+scShmLogRecordHeader *scShmLogRing::getRecord(boost::uint32_t pos) const
+{
+  return reinterpret_cast<scShmLogRecordHeader *>(
+    m_base + sizeof(scShmLogRingHeader) + static_cast<size_t>(pos & (m_header->capacity - 1)) * m_header->recordStride);
+}
+
+bool scShmLogRing::append(scShmLogLevel level, uint formatId, const scShmLogArgs &args)
+{
+  return append(level, formatId, args.getData(), args.getSize(), args.isTruncated());
+}
+
+bool scShmLogRing::append(scShmLogLevel level, uint formatId, const void *args, size_t argsSize, bool truncated)
+{
+  scShmLogRecordHeader *record;
+  boost::uint32_t pos;
+
+  for(;;) {
+    pos = atomic_read32(&m_header->enqueuePos);
+    record = getRecord(pos);
+    boost::int32_t diff = static_cast<boost::int32_t>(atomic_read32(&record->sequence) - pos);
+    if (diff == 0) {
+      if (atomic_cas32(&m_header->enqueuePos, pos + 1, pos) == pos)
+        break;
+    } else if (diff < 0) {
+      // full - drop instead of waiting for collector
+      atomic_inc32(&m_header->dropCount);
+      return false;
+    }
+  }
+
+  // lets consumer skip the slot if this process dies before publishing it
+  atomic_write32(&record->claimPid, m_pid);
+  shm_log_fence();
+  atomic_write32(&record->claimPos, pos);
+
+  if (argsSize > m_header->argsSize) {
+    argsSize = m_header->argsSize;
+    truncated = true;
+  }
+
+  if (atomic_read32(&record->sequence) != pos) {
+    // stalled longer than consumer's timeout, slot was skipped
+    atomic_inc32(&m_header->dropCount);
+    return false;
+  }
+
+  record->level = level;
+  record->formatId = formatId;
+  record->pid = m_pid;
+  record->timestamp = getTimestamp();
+  record->argsSize = static_cast<boost::uint32_t>(argsSize);
+  record->flags = truncated?SC_SHM_LOG_FLAG_TRUNCATED:0;
+  if (argsSize > 0)
+    std::memcpy(record + 1, args, argsSize);
+
+  shm_log_fence();
+  if (atomic_cas32(&record->sequence, pos + 1, pos) != pos) {
+    atomic_inc32(&m_header->dropCount);
+    return false;
+  }
+  return true;
+}
+
+bool scShmLogRing::take(boost::uint64_t &timestamp, scShmLogLevel &level, uint &formatId, uint &pid,
+  char *args, size_t &argsSize, bool *truncated)
+{
+  scShmLogRecordHeader *record;
+  boost::uint32_t pos;
+
+  for(;;) {
+    pos = atomic_read32(&m_header->dequeuePos);
+    record = getRecord(pos);
+    boost::int32_t diff = static_cast<boost::int32_t>(atomic_read32(&record->sequence) - (pos + 1));
+    if (diff == 0) {
+      if (atomic_cas32(&m_header->dequeuePos, pos + 1, pos) == pos)
+        break;
+    } else if (diff < 0) {
+      // empty, or oldest record not published yet
+      if (!skipStalled(pos, record))
+        return false;
+    }
+  }
+
+  m_stalled = false;
+  timestamp = record->timestamp;
+  level = static_cast<scShmLogLevel>(record->level);
+  formatId = record->formatId;
+  pid = record->pid;
+  argsSize = record->argsSize;
+  if (truncated != SC_NULL)
+    *truncated = ((record->flags & SC_SHM_LOG_FLAG_TRUNCATED) != 0);
+  if (argsSize > 0)
+    std::memcpy(args, record + 1, argsSize);
+
+  shm_log_fence();
+  atomic_write32(&record->sequence, pos + m_header->capacity);
+  return true;
+}
+
+bool scShmLogRing::skipStalled(boost::uint32_t pos, scShmLogRecordHeader *record)
+{
+  if (static_cast<boost::int32_t>(atomic_read32(&m_header->enqueuePos) - pos) <= 0) {
+    // empty
+    m_stalled = false;
+    return false;
+  }
+
+  // claimed, but not published
+  shm_log_fence();
+  bool producerDead = (atomic_read32(&record->claimPos) == pos) && !shm_log_process_exists(atomic_read32(&record->claimPid));
+  if (!producerDead) {
+    boost::uint64_t now = getTimestamp();
+    if (!m_stalled || (m_stallPos != pos)) {
+      m_stalled = true;
+      m_stallPos = pos;
+      m_stallSince = now;
+      return false;
+    }
+    // producer died before it recorded its claim or does not finish
+    if (now < m_stallSince + static_cast<boost::uint64_t>(m_stallTimeoutMs) * 1000)
+      return false;
+  }
+
+  // slot is released for next lap unless producer has just published it
+  if (atomic_cas32(&record->sequence, pos + m_header->capacity, pos) != pos)
+    return true;
+  atomic_cas32(&m_header->dequeuePos, pos + 1, pos);
+  atomic_inc32(&m_header->skipCount);
+  m_stalled = false;
+  return true;
+}
+
+uint scShmLogRing::getDropCount() const
+{
+  return atomic_read32(&m_header->dropCount);
+}
+
+uint scShmLogRing::getSkipCount() const
+{
+  return atomic_read32(&m_header->skipCount);
+}
+
+void scShmLogRing::setStallTimeout(uint timeoutMs)
+{
+  m_stallTimeoutMs = timeoutMs;
+}
+
+size_t scShmLogRing::getArgsSize() const
+{
+  return m_header->argsSize;
+}
+
+uint scShmLogRing::getCapacity() const
+{
+  return m_header->capacity;
+}
+
+boost::uint64_t scShmLogRing::getTimestamp()
+{
+#ifdef WIN32
+  FILETIME ft;
+  GetSystemTimeAsFileTime(&ft);
+  boost::uint64_t res = (static_cast<boost::uint64_t>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+  // 100ns units since 1601 -> us since 1970
+  return (res - 116444736000000000ULL) / 10;
+#else
+  struct timeval tv;
+  gettimeofday(&tv, SC_NULL);
+  return static_cast<boost::uint64_t>(tv.tv_sec) * 1000000 + tv.tv_usec;
+#endif
+}
+
+// ----------------------------------------------------------------------------
+// scShmLogCollector
+// ----------------------------------------------------------------------------
+scShmLogCollector::scShmLogCollector(scShmLogRing &ring, const scString &fileName):
+  m_ring(ring), m_collectedCount(0), m_reportedDrops(0)
+{
+  m_file = std::fopen(fileName.c_str(), "ab");
+  if (m_file == SC_NULL)
+    throw scError("Cannot open log file: ["+fileName+"]");
+  // batches are written with a single call
+  std::setvbuf(m_file, SC_NULL, _IONBF, 0);
+  m_args.resize(SC_MAX(m_ring.getArgsSize(), static_cast<size_t>(1)));
+  m_reportedDrops = m_ring.getDropCount();
+}
+
+scShmLogCollector::~scShmLogCollector()
+{
+  std::fclose(m_file);
+}
+
+void scShmLogCollector::registerFormat(uint formatId, const scString &format)
+{
+  m_formats[formatId] = format;
+}
+
+uint scShmLogCollector::collect(uint maxRecords)
+{
+  boost::uint64_t timestamp;
+  scShmLogLevel level;
+  uint formatId, pid;
+  size_t argsSize;
+  bool truncated;
+  uint res = 0;
+
+  while ((maxRecords == 0) || (res < maxRecords))
+  {
+    if (!m_ring.take(timestamp, level, formatId, pid, &m_args[0], argsSize, &truncated))
+      break;
+    formatRecord(timestamp, level, formatId, pid, &m_args[0], argsSize, truncated, m_buffer);
+    res++;
+  }
+
+  uint dropCount = m_ring.getDropCount();
+  if (dropCount != m_reportedDrops) {
+    scShmLogArgs args;
+    args.add(dropCount - m_reportedDrops);
+    m_reportedDrops = dropCount;
+    formatRecord(scShmLogRing::getTimestamp(), shllWarning, 0, 0, args.getData(), args.getSize(), false, m_buffer);
+  }
+
+  flushBuffer();
+  m_collectedCount += res;
+  return res;
+}
+
+uint scShmLogCollector::collectFor(uint durationMs, uint idleMs)
+{
+  boost::uint64_t endTime = scShmLogRing::getTimestamp() + static_cast<boost::uint64_t>(durationMs) * 1000;
+  uint res = 0;
+
+  do {
+    uint cnt = collect(m_ring.getCapacity());
+    res += cnt;
+    if ((cnt == 0) && (idleMs > 0))
+      boost::interprocess::ipcdetail::thread_sleep(idleMs);
+  } while (scShmLogRing::getTimestamp() < endTime);
+
+  return res;
+}
+
+uint scShmLogCollector::getCollectedCount() const
+{
+  return m_collectedCount;
+}
+
+void scShmLogCollector::flushBuffer()
+{
+  if (m_buffer.empty())
+    return;
+  size_t written = std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_file);
+  m_buffer.clear();
+  if (written == 0)
+    throw scError("Log write failed");
+}
+
+void scShmLogCollector::formatRecord(boost::uint64_t timestamp, scShmLogLevel level, uint formatId, uint pid,
+  const char *args, size_t argsSize, bool truncated, scString &output)
+{
+  static const char *levelNames[] = {"?", "ERROR", "WARN", "INFO", "DEBUG"};
+
+  time_t secs = static_cast<time_t>(timestamp / 1000000);
+  struct tm *tmPtr = std::localtime(&secs);
+  char buffer[64];
+  size_t len = 0;
+  if (tmPtr != SC_NULL)
+    len = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", tmPtr);
+  std::sprintf(buffer + len, ".%06u %s [%u] ",
+    static_cast<uint>(timestamp % 1000000), levelNames[(level >= shllError && level <= shllDebug)?level:0], pid);
+  output += buffer;
+
+  if ((formatId == 0) && (pid == 0)) {
+    formatArgs("{} log records dropped", args, argsSize, output);
+  } else {
+    FormatMap::const_iterator it = m_formats.find(formatId);
+    if (it != m_formats.end()) {
+      formatArgs(it->second, args, argsSize, output);
+    } else {
+      std::sprintf(buffer, "format #%u:", formatId);
+      output += buffer;
+      formatArgs(" {} {} {} {} {} {} {} {}", args, argsSize, output);
+    }
+  }
+
+  if (truncated)
+    output += " [truncated]";
+  output += '\n';
+}
+
+void scShmLogCollector::formatArgs(const scString &format, const char *args, size_t argsSize, scString &output)
+{
+  const char *argPtr = args;
+  const char *argEnd = args + argsSize;
+  char buffer[64];
+  size_t start = 0, found;
+
+  while ((found = format.find("{}", start)) != scString::npos)
+  {
+    output.append(format, start, found - start);
+    start = found + 2;
+
+    if (argPtr >= argEnd)
+      continue;
+
+    char typeCode = *argPtr++;
+    if (typeCode == SC_SHM_LOG_ARG_STR) {
+      boost::uint16_t len;
+      if (argPtr + sizeof(len) > argEnd)
+        break;
+      std::memcpy(&len, argPtr, sizeof(len));
+      argPtr += sizeof(len);
+      len = static_cast<boost::uint16_t>(SC_MIN(static_cast<size_t>(len), static_cast<size_t>(argEnd - argPtr)));
+      output.append(argPtr, len);
+      argPtr += len;
+      continue;
+    }
+
+    if (argPtr + sizeof(boost::uint64_t) > argEnd)
+      break;
+
+    if (typeCode == SC_SHM_LOG_ARG_INT) {
+      boost::int64_t value;
+      std::memcpy(&value, argPtr, sizeof(value));
+      std::sprintf(buffer, "%lld", static_cast<long long>(value));
+    } else if (typeCode == SC_SHM_LOG_ARG_UINT) {
+      boost::uint64_t value;
+      std::memcpy(&value, argPtr, sizeof(value));
+      std::sprintf(buffer, "%llu", static_cast<unsigned long long>(value));
+    } else if (typeCode == SC_SHM_LOG_ARG_FLOAT) {
+      double value;
+      std::memcpy(&value, argPtr, sizeof(value));
+      std::sprintf(buffer, "%g", value);
+    } else {
+      break;
+    }
+    argPtr += sizeof(boost::uint64_t);
+    output += buffer;
+  }
+
+  if (start < format.size())
+    output.append(format, start, scString::npos);
+}
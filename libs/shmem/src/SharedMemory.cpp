@@ -22,8 +22,13 @@
 #include <boost/interprocess/detail/config_begin.hpp>
 #include <boost/interprocess/detail/workaround.hpp>
 #include <boost/interprocess/windows_shared_memory.hpp>
+#else
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <sys/file.h>
 #endif
 
+#include "sc/utils.h"
+
 #ifdef SCSHM_WINDOWS
 typedef boost::interprocess::windows_shared_memory scSharedMemObject;
 #else
@@ -45,12 +50,23 @@ scSharedMemory::scSharedMemory(const scString &a_path, scsmAccessMode accessMode
     
   bool createResource = ((a_useFlags & scsmCreate) != 0);  
   bool noAccess = ((a_useFlags & scsmNoAccess) != 0);
+  bool exclusive = ((a_useFlags & scsmExclusive) != 0);
   
-  if (createResource)
+  if (createResource && !exclusive)
     freeResource();
   
   if (accessMode == scsmReadOnly) {
-    if (createResource) {
+    if (createResource && exclusive) {
+    //== exclusive create + read-only
+      m_objectHandle = new scSharedMemObject
+       (create_only                  //fails if exists
+       ,stringToCharPtr(a_path)               //name
+       ,read_only                    //read-only mode
+#ifdef SCSHM_WINDOWS       
+       ,m_size
+#endif
+       );      
+    } else if (createResource) {
     //== create + read-only
       m_objectHandle = new scSharedMemObject
        (open_or_create               //open or create
@@ -69,7 +85,17 @@ scSharedMemory::scSharedMemory(const scString &a_path, scsmAccessMode accessMode
        );      
     }
   } else { // read-write
-    if (createResource) {
+    if (createResource && exclusive) {
+    //== exclusive create + read-write
+      m_objectHandle = new scSharedMemObject
+       (create_only                     //fails if exists
+       ,stringToCharPtr(a_path)               //name
+       ,read_write                   //read-write mode
+#ifdef SCSHM_WINDOWS       
+       ,m_size
+#endif       
+       );      
+    } else if (createResource) {
       m_objectHandle = new scSharedMemObject
        (open_or_create                  //open or create
        ,stringToCharPtr(a_path)               //name
@@ -89,20 +115,41 @@ scSharedMemory::scSharedMemory(const scString &a_path, scsmAccessMode accessMode
     }
   }
   
+#ifndef SCSHM_WINDOWS
+  // new object has zero size, so it needs to be resized before mapping
+  if (createResource && (m_size>0))  
+    ((scSharedMemObject *)m_objectHandle)->truncate(m_size);  
+#endif      
+
   if (!noAccess)
   {
+#ifndef SCSHM_WINDOWS
+    // registers writer, fails while snapshot of object is taken
+    if ((accessMode == scsmReadWrite) && (flock(getLockHandle(), LOCK_SH | LOCK_NB) != 0)) {
+      freeHandles();
+      throw scError("Shared memory is locked for writing: ["+a_path+"]");
+    }
+#endif
+
     if (accessMode == scsmReadOnly)
       m_regionHandle = new scSharedMemRegion(*((scSharedMemObject *)m_objectHandle), read_only);
     else  
       m_regionHandle = new scSharedMemRegion(*((scSharedMemObject *)m_objectHandle), read_write);  
       
-#ifndef SCSHM_WINDOWS
-    if (createResource && (m_size>0))  
-      ((scSharedMemObject *)m_objectHandle)->truncate(m_size);  
-#endif      
+    if ((a_useFlags & scsmPrefault) != 0)
+      warmUp((accessMode == scsmReadOnly)?shwmPopulateRead:shwmPopulateWrite);
   }
 }
 
+scSharedMemory::scSharedMemory(scsmAccessMode accessMode, size_t a_size):
+  scSharedResource()
+{
+  m_size = a_size;
+  m_accessMode = accessMode;
+  m_ownsResource = false;
+  m_regionHandle = m_objectHandle = SC_NULL;
+}
+
 scSharedMemory::~scSharedMemory()
 {
   if (m_ownsResource)
@@ -148,3 +195,63 @@ size_t scSharedMemory::getSize()
 {
   return m_size;
 }
+
+size_t scSharedMemory::getMappedSize()
+{
+  if (m_regionHandle != SC_NULL)
+    return (*((scSharedMemRegion *)m_regionHandle)).get_size();
+  return m_size;
+}
+
+int scSharedMemory::getLockHandle()
+{
+#ifdef SCSHM_WINDOWS
+  return -1;
+#else
+  if (m_objectHandle == SC_NULL)
+    return -1;
+  return ((scSharedMemObject *)m_objectHandle)->get_mapping_handle().handle;
+#endif
+}
+
+bool scSharedMemory::lockWriters()
+{
+#ifdef SCSHM_WINDOWS
+  return true;
+#else
+  int fd = getLockHandle();
+  if (fd < 0)
+    return false;
+  if (flock(fd, LOCK_EX | LOCK_NB) == 0)
+    return true;
+  // conversion is not atomic - shared lock is lost on failure
+  flock(fd, LOCK_SH | LOCK_NB);
+  return false;
+#endif
+}
+
+void scSharedMemory::unlockWriters()
+{
+#ifndef SCSHM_WINDOWS
+  int fd = getLockHandle();
+  if (fd >= 0)
+    flock(fd, LOCK_SH | LOCK_NB);
+#endif
+}
+
+bool scSharedMemory::warmUp(scShmWarmMode mode)
+{
+  void *address = getAddress();
+  if (address == SC_NULL)
+    return false;
+  return scShmWarmer::warm(address, getSize(), mode);
+}
+
+size_t scSharedMemory::getResidentSize()
+{
+  size_t res = 0;
+  void *address = getAddress();
+  if (address != SC_NULL)
+    scShmWarmer::getResidentSize(address, getSize(), res);
+  return res;
+}
@@ -8,6 +8,11 @@
 /////////////////////////////////////////////////////////////////////////////
 
 #include "sc/proc/SharedMemoryBlock.h"
+#include "sc/proc/SharedMemorySnapshot.h"
+#include "sc/proc/SharedMemoryTrace.h"
+
+#include <deque>
+#include <map>
 
 #include <boost/interprocess/detail/win32_api.hpp>
 
@@ -44,6 +49,51 @@ inline void shared_block_copy(void *dest, void *src, size_t dataSize)
   std::memcpy(dest, src, realSize);
 }
 
+inline void shared_block_process(const char *mem, size_t aOffset, size_t aLimit, size_t realLimit, scShmWinConsumerIntf *consumer)
+{
+  assert(realLimit > 0);
+  size_t sizeLimit = shared_block_length(mem+aOffset, realLimit);
+  if (aLimit < sizeLimit)
+    sizeLimit = aLimit;
+
+  consumer->process(mem+aOffset+sizeof(size_t), sizeLimit);
+}
+
+inline size_t shared_block_store(char *cptr, size_t aOffset, size_t realLimit, scShmWinWriterIntf *writer)
+{
+  size_t bytesWritten;
+  if (realLimit > sizeof(size_t)) 
+    bytesWritten = writer->write(cptr+aOffset+sizeof(size_t), realLimit - sizeof(size_t));
+  else
+    bytesWritten = 0;
+  std::memcpy(cptr+aOffset, &bytesWritten, sizeof(size_t));
+  assert(shared_block_length(cptr+aOffset, sizeof(size_t)) == bytesWritten);
+  return bytesWritten;
+}
+
+// interned block, registry keys are calculated once, addresses are cached
+// until any shared resource is released (generation change)
+struct ShmBlockEntry {
+  scString path;
+  size_t size;
+  scString regPath[3]; // indexed by ShBlockAccessType
+  void *address[3];
+  uint generation;
+};
+
+// deque keeps references to entries valid when new ones are added
+typedef std::deque<ShmBlockEntry> ShmBlockEntryColn;
+typedef std::map<scString, scShmBlockHandle> ShmBlockHandleMap;
+
+static ShmBlockEntryColn gs_blockEntries;
+static ShmBlockHandleMap gs_blockHandles;
+
+static ShmBlockEntry &checkBlockEntry(scShmBlockHandle handle)
+{
+  if ((handle == SC_SHM_NULL_HANDLE) || (handle > gs_blockEntries.size()))
+    throw std::runtime_error("Invalid shared block handle: "+toString(handle));
+  return gs_blockEntries[handle - 1];
+}
 
 class ShmWinWriterForMem: public scShmWinWriterIntf {
 public:
@@ -78,6 +128,7 @@ size_t scSharedMemoryBlock::length(const char *data, size_t dataSize)
 void scSharedMemoryBlock::create()
 {
   assert(m_size > 0);
+  scShmTraceScope trace(shtoCreate, m_path, m_size, 0, m_size);
 
 #ifdef DEBUG_SHM_CREATE
   Log::addDebug(scString("creating shared block, size: ")+toString(m_size)+", path: ["+m_path+"]");
@@ -162,20 +213,14 @@ bool scSharedMemoryBlock::read(scShmWinConsumerIntf *consumer)
 
 bool scSharedMemoryBlock::read(scShmWinConsumerIntf *consumer, size_t aOffset, size_t aLimit)
 {
+  scShmTraceScope trace(shtoRead, m_path, m_size, aOffset, aLimit);
   checkPos(aOffset, aLimit);
 
   void *data = get(shbat_read_only);
   if (data != NULL)
   {
     const char *mem = (char*)data;
-
-    size_t realLimit = recalcLimit(aOffset, aLimit);
-    assert(realLimit > 0);
-    size_t sizeLimit = shared_block_length(mem+aOffset, realLimit);
-    if (aLimit < sizeLimit)
-      sizeLimit = aLimit;
-
-    consumer->process(mem+aOffset+sizeof(size_t), sizeLimit);
+    shared_block_process(mem, aOffset, aLimit, recalcLimit(aOffset, aLimit), consumer);
   } else {
 
     std::auto_ptr<scSharedMemory> shMemoryGuard;
@@ -185,14 +230,7 @@ bool scSharedMemoryBlock::read(scShmWinConsumerIntf *consumer, size_t aOffset, s
       scsmReadOnly, 0, m_size));
 
     const char *mem = (char*)shMemoryGuard->getAddress();
-
-    size_t realLimit = recalcLimit(aOffset, aLimit);
-    assert(realLimit > 0);
-    size_t sizeLimit = shared_block_length(mem+aOffset, realLimit);
-    if (aLimit < sizeLimit)
-      sizeLimit = aLimit;
-
-    consumer->process(mem+aOffset+sizeof(size_t), sizeLimit);
+    shared_block_process(mem, aOffset, aLimit, recalcLimit(aOffset, aLimit), consumer);
 
     registerBlock(shbat_read_only, shMemoryGuard.release(), false);
   }
@@ -202,6 +240,7 @@ bool scSharedMemoryBlock::read(scShmWinConsumerIntf *consumer, size_t aOffset, s
 
 void scSharedMemoryBlock::write(scShmWinWriterIntf *writer, size_t aOffset, size_t aLimit)
 {
+  scShmTraceScope trace(shtoWrite, m_path, m_size, aOffset, aLimit);
   checkPos(aOffset, aLimit);
   size_t realLimit = recalcLimit(aOffset, aLimit);
   assert(realLimit > 0);
@@ -210,26 +249,13 @@ void scSharedMemoryBlock::write(scShmWinWriterIntf *writer, size_t aOffset, size
   if (shdata != NULL)
   {
     char *cptr = (char *)shdata;
-    size_t bytesWritten;
-    if (realLimit > sizeof(size_t)) 
-      bytesWritten = writer->write(cptr+aOffset+sizeof(size_t), realLimit - sizeof(size_t));
-    else
-      bytesWritten = 0;
-    std::memcpy(cptr+aOffset, &bytesWritten, sizeof(size_t));
-    assert(shared_block_length(cptr+aOffset, sizeof(size_t)) == bytesWritten);
+    trace.setDataSize(shared_block_store(cptr, aOffset, realLimit, writer));
   } else {
     std::auto_ptr<scSharedMemory> sharedGuard(
         new scSharedMemory(m_path, scsmReadWrite, 0, m_size));
 
     char *cptr = (char *)sharedGuard->getAddress();
-    size_t bytesWritten;
-    if (realLimit > sizeof(size_t))
-      bytesWritten = writer->write(cptr+aOffset+sizeof(size_t), realLimit - sizeof(size_t));
-    else
-      bytesWritten = 0;
-
-    std::memcpy(cptr+aOffset, &bytesWritten, sizeof(size_t));
-    assert(shared_block_length(cptr+aOffset, sizeof(size_t)) == bytesWritten);
+    trace.setDataSize(shared_block_store(cptr, aOffset, realLimit, writer));
     
     registerBlock(shbat_read_write, sharedGuard.release(), false);
   }
@@ -248,6 +274,41 @@ void scSharedMemoryBlock::clear(size_t aOffset, size_t aLimit)
   write(&writer, aOffset, clrSize);
 }
 
+scSharedMemorySnapshot *scSharedMemoryBlock::snapshot()
+{
+  // snapshot protects the mapping used by writer and locks out other ones
+  void *address = attach(shbat_read_write);
+  scSharedMemory *memory = checked_cast<scSharedMemory *>(scSharedResourceManager::find(calcRegPath(shbat_read_write)));
+  return new scSharedMemorySnapshot(address, m_size, memory);
+}
+
+scSharedMemoryBlock::ShBlockAccessType scSharedMemoryBlock::calcWarmAccessType(scShmWarmMode mode)
+{
+  return (mode == shwmPopulateWrite)?shbat_read_write:shbat_read_only;
+}
+
+bool scSharedMemoryBlock::warmUp(scShmWarmMode mode)
+{
+  return scShmWarmer::warm(attach(calcWarmAccessType(mode)), m_size, mode);
+}
+
+scShmWarmer *scSharedMemoryBlock::warmUpAsync(scShmWarmMode mode, uint threadCount)
+{
+  return new scShmWarmer(attach(calcWarmAccessType(mode)), m_size, mode, threadCount);
+}
+
+size_t scSharedMemoryBlock::getResidentSize()
+{
+  void *data = get(shbat_read_only);
+  if (data == NULL)
+    data = get(shbat_read_write);
+
+  size_t res = 0;
+  if (data != NULL)
+    scShmWarmer::getResidentSize(data, m_size, res);
+  return res;
+}
+
 void scSharedMemoryBlock::copy(const scString &blockPathSrc, const scString &blockPathDest, size_t blockSize, bool useReadOnly)
 {
   copy(blockPathSrc, blockPathDest, blockSize, 0, blockSize, useReadOnly);
@@ -255,6 +316,8 @@ void scSharedMemoryBlock::copy(const scString &blockPathSrc, const scString &blo
 
 void scSharedMemoryBlock::copy(const scString &blockPathSrc, const scString &blockPathDest, size_t blockSize, size_t aOffset, size_t aLimit, bool useReadOnly)
 {
+  scShmTraceScope trace(shtoCopy, blockPathSrc, blockSize, aOffset, aLimit);
+  trace.setTarget(blockPathDest, useReadOnly?SC_SHM_TRACE_READ_ONLY:0);
   char *dataSrc;
 
   // read-write can be used to limit number of blocks being allocated
@@ -306,13 +369,18 @@ size_t scSharedMemoryBlock::recalcLimit(size_t aBlockSize, size_t aOffset, size_
 
 void scSharedMemoryBlock::checkPos(size_t aOffset, size_t aLimit)
 {
-  if (aOffset + aLimit > m_size)
+  checkPos(m_path, m_size, aOffset, aLimit);
+}
+
+void scSharedMemoryBlock::checkPos(const scString &path, size_t aBlockSize, size_t aOffset, size_t aLimit)
+{
+  if (aOffset + aLimit > aBlockSize)
     throw std::runtime_error(
       scString("Shared block offset + limit incorrect")+
-        ", size="+toString(m_size)+
+        ", size="+toString(aBlockSize)+
         ", offset="+toString(aOffset)+
         ", limit="+toString(aLimit)+
-        ", path=["+m_path+"]");
+        ", path=["+path+"]");
 }
 
 void *scSharedMemoryBlock::get(ShBlockAccessType accessType)
@@ -320,6 +388,19 @@ void *scSharedMemoryBlock::get(ShBlockAccessType accessType)
   return get(m_path, accessType);
 }
 
+void *scSharedMemoryBlock::attach(ShBlockAccessType accessType)
+{
+  void *res = get(accessType);
+  if (res == NULL)
+  {
+    std::auto_ptr<scSharedMemory> sharedGuard(
+        new scSharedMemory(m_path, (accessType == shbat_read_only)?scsmReadOnly:scsmReadWrite, 0, m_size));
+    res = sharedGuard->getAddress();
+    registerBlock(accessType, sharedGuard.release(), false);
+  }
+  return res;
+}
+
 void *scSharedMemoryBlock::get(const scString &path, ShBlockAccessType accessType)
 {
 #ifdef TRACE_IO_CNT
@@ -345,3 +426,156 @@ void *scSharedMemoryBlock::get(const scString &path, ShBlockAccessType accessTyp
   }
 }
 
+// ----------------------------------------------------------------------------
+// interned block access
+// ----------------------------------------------------------------------------
+scShmBlockHandle scSharedMemoryBlock::intern(const scString &blockPath, size_t aSize)
+{
+  ShmBlockHandleMap::const_iterator it = gs_blockHandles.find(blockPath);
+  if (it != gs_blockHandles.end())
+  {
+    if (gs_blockEntries[it->second - 1].size != aSize)
+      throw std::runtime_error(
+        scString("Shared block already interned with different size")+
+          ", size="+toString(gs_blockEntries[it->second - 1].size)+
+          ", requested="+toString(aSize)+
+          ", path=["+blockPath+"]");
+    return it->second;
+  }
+
+  gs_blockEntries.push_back(ShmBlockEntry());
+  ShmBlockEntry &entry = gs_blockEntries.back();
+  entry.path = blockPath;
+  entry.size = aSize;
+  entry.regPath[shbat_read_only] = calcRegPath(blockPath, shbat_read_only);
+  entry.regPath[shbat_read_write] = calcRegPath(blockPath, shbat_read_write);
+  entry.regPath[shbat_create] = calcRegPath(blockPath, shbat_create);
+  entry.address[shbat_read_only] = entry.address[shbat_read_write] = entry.address[shbat_create] = SC_NULL;
+  entry.generation = scSharedResourceManager::getGeneration();
+
+  scShmBlockHandle handle = static_cast<scShmBlockHandle>(gs_blockEntries.size());
+  gs_blockHandles.insert(std::make_pair(blockPath, handle));
+  return handle;
+}
+
+const scString &scSharedMemoryBlock::getPath(scShmBlockHandle handle)
+{
+  return checkBlockEntry(handle).path;
+}
+
+size_t scSharedMemoryBlock::getSize(scShmBlockHandle handle)
+{
+  return checkBlockEntry(handle).size;
+}
+
+bool scSharedMemoryBlock::read(scShmBlockHandle handle, scShmWinConsumerIntf *consumer)
+{
+  return read(handle, consumer, 0, getSize(handle));
+}
+
+bool scSharedMemoryBlock::read(scShmBlockHandle handle, scShmWinConsumerIntf *consumer, size_t aOffset, size_t aLimit)
+{
+  const ShmBlockEntry &entry = checkBlockEntry(handle);
+  scShmTraceScope trace(shtoRead, entry.path, entry.size, aOffset, aLimit);
+  checkPos(entry.path, entry.size, aOffset, aLimit);
+
+  const char *mem = (char *)get(handle, shbat_read_only);
+  if (mem != NULL) {
+    shared_block_process(mem, aOffset, aLimit, recalcLimit(entry.size, aOffset, aLimit), consumer);
+    return true;
+  }
+
+  // first access - open & register block, next calls will use cached address
+  scSharedMemoryBlock block(entry.path, entry.size);
+  return block.read(consumer, aOffset, aLimit);
+}
+
+void scSharedMemoryBlock::write(scShmBlockHandle handle, scShmWinWriterIntf *writer, size_t aOffset, size_t aLimit)
+{
+  const ShmBlockEntry &entry = checkBlockEntry(handle);
+  scShmTraceScope trace(shtoWrite, entry.path, entry.size, aOffset, aLimit);
+  checkPos(entry.path, entry.size, aOffset, aLimit);
+
+  char *cptr = (char *)get(handle, shbat_read_write);
+  if (cptr != NULL) {
+    size_t realLimit = recalcLimit(entry.size, aOffset, aLimit);
+    assert(realLimit > 0);
+    trace.setDataSize(shared_block_store(cptr, aOffset, realLimit, writer));
+    return;
+  }
+
+  scSharedMemoryBlock block(entry.path, entry.size);
+  block.write(writer, aOffset, aLimit);
+}
+
+void scSharedMemoryBlock::clear(scShmBlockHandle handle)
+{
+  clear(handle, 0, getSize(handle));
+}
+
+void scSharedMemoryBlock::clear(scShmBlockHandle handle, size_t aOffset, size_t aLimit)
+{
+  char clearChars[] = {'\0'};
+  size_t clrSize = sizeof(clearChars) / sizeof(char);
+  ShmWinWriterForMem writer(clearChars, clrSize);
+  write(handle, &writer, aOffset, clrSize);
+}
+
+void scSharedMemoryBlock::copy(scShmBlockHandle handleSrc, scShmBlockHandle handleDest, bool useReadOnly)
+{
+  copy(handleSrc, handleDest, 0, getSize(handleDest), useReadOnly);
+}
+
+void scSharedMemoryBlock::copy(scShmBlockHandle handleSrc, scShmBlockHandle handleDest, size_t aOffset, size_t aLimit, bool useReadOnly)
+{
+  const ShmBlockEntry &entrySrc = checkBlockEntry(handleSrc);
+  const ShmBlockEntry &entryDest = checkBlockEntry(handleDest);
+  scShmTraceScope trace(shtoCopy, entrySrc.path, entryDest.size, aOffset, aLimit);
+  trace.setTarget(entryDest.path, useReadOnly?SC_SHM_TRACE_READ_ONLY:0);
+
+  char *dataSrc = (char *)get(handleSrc, useReadOnly?shbat_read_only:shbat_read_write);
+  char *dataDest = (char *)get(handleDest, shbat_read_write);
+
+  if ((dataSrc != NULL) && (dataDest != NULL))
+  {
+    size_t realLimit = recalcLimit(entryDest.size, aOffset, aLimit);
+    shared_block_copy(dataDest+aOffset, dataSrc+aOffset, realLimit);
+  } else {
+    copy(entrySrc.path, entryDest.path, entryDest.size, aOffset, aLimit, useReadOnly);
+  }
+}
+
+void *scSharedMemoryBlock::get(scShmBlockHandle handle, ShBlockAccessType accessType)
+{
+#ifdef TRACE_IO_CNT
+  Counter::inc("io-shm-block-get-cnt");
+#endif
+
+  ShmBlockEntry &entry = checkBlockEntry(handle);
+
+  uint generation = scSharedResourceManager::getGeneration();
+  if (entry.generation != generation) 
+  {
+    entry.address[shbat_read_only] = entry.address[shbat_read_write] = entry.address[shbat_create] = SC_NULL;
+    entry.generation = generation;
+  }
+
+  void *res = entry.address[accessType];
+  if (res == NULL)
+  {
+    scSharedMemory *memory = checked_cast<scSharedMemory *>(scSharedResourceManager::find(entry.regPath[accessType]));
+    if (memory != NULL) {
+      res = memory->getAddress();
+      entry.address[accessType] = res;
+    }
+  }
+
+#ifdef TRACE_IO_CNT
+  if (res != NULL)
+    Counter::inc("io-shm-block-get-hit-cnt");
+  else
+    Counter::inc("io-shm-block-get-mis-cnt");
+#endif
+
+  return res;
+}
@@ -0,0 +1,375 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        SharedMemorySnapshot.cpp
+// Project:     scLib
+// Purpose:     Point-in-time copy-on-write snapshot of shared memory
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#include "sc/proc/SharedMemorySnapshot.h"
+
+#include "boost/interprocess/mapped_region.hpp"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+#include <linux/userfaultfd.h>
+#if defined(__NR_userfaultfd) && defined(UFFD_FEATURE_WP_HUGETLBFS_SHMEM) && defined(__NR_memfd_create)
+#define SCSHM_SNAPSHOT_COW
+#endif
+#endif
+
+#include "sc/utils.h"
+
+#ifdef SCSHM_SNAPSHOT_COW
+static int shm_snapshot_open_fault_fd()
+{
+  // not UFFD_USER_MODE_ONLY - kernel writes to protected pages would fail with EFAULT
+  // instead of waiting for copy; without privileges snapshot falls back to full copy
+  int fd = static_cast<int>(syscall(__NR_userfaultfd, O_CLOEXEC | O_NONBLOCK));
+  if (fd < 0)
+    return -1;
+
+  struct uffdio_api api;
+  std::memset(&api, 0, sizeof(api));
+  api.api = UFFD_API;
+  api.features = UFFD_FEATURE_PAGEFAULT_FLAG_WP | UFFD_FEATURE_WP_HUGETLBFS_SHMEM;
+  if (ioctl(fd, UFFDIO_API, &api) != 0) {
+    close(fd);
+    return -1;
+  }
+
+  return fd;
+}
+
+static bool shm_snapshot_protect(int faultFd, char *address, size_t size, bool protect)
+{
+  struct uffdio_writeprotect wp;
+  wp.range.start = reinterpret_cast<unsigned long>(address);
+  wp.range.len = size;
+  wp.mode = protect?UFFDIO_WRITEPROTECT_MODE_WP:0;
+  return (ioctl(faultFd, UFFDIO_WRITEPROTECT, &wp) == 0);
+}
+#endif
+
+scSharedMemorySnapshot::scSharedMemorySnapshot(void *address, size_t size, scSharedMemory *memory):
+  m_source(static_cast<char *>(address)), m_size(size),
+  m_pageSize(boost::interprocess::mapped_region::get_page_size()),
+  m_copy(SC_NULL), m_copiedCount(0), m_copyOnWrite(false),
+  m_memFd(-1), m_faultFd(-1), m_stopFd(-1), m_thread(SC_NULL), m_memory(SC_NULL)
+{
+  if (reinterpret_cast<size_t>(address) % m_pageSize != 0)
+    throw scError("Snapshot source address must be page-aligned");
+
+  m_copied.resize((m_size + m_pageSize - 1) / m_pageSize, 0);
+
+  // write-protect faults are raised only for writes through this mapping
+  if (memory != SC_NULL) {
+    if (!memory->lockWriters())
+      throw scError("Snapshot source is mapped for writing elsewhere");
+    m_memory = memory;
+  }
+
+  initCopyOnWrite();
+  if (!m_copyOnWrite) {
+    initFullCopy();
+    // copy is complete, writers do not need to be blocked
+    unlockWriters();
+  }
+}
+
+scSharedMemorySnapshot::~scSharedMemorySnapshot()
+{
+  freeHandles();
+  unlockWriters();
+}
+
+void scSharedMemorySnapshot::unlockWriters()
+{
+  if (m_memory != SC_NULL) {
+    m_memory->unlockWriters();
+    m_memory = SC_NULL;
+  }
+}
+
+bool scSharedMemorySnapshot::isSupported()
+{
+#ifdef SCSHM_SNAPSHOT_COW
+  int fd = shm_snapshot_open_fault_fd();
+  if (fd < 0)
+    return false;
+  close(fd);
+  return true;
+#else
+  return false;
+#endif
+}
+
+void scSharedMemorySnapshot::initCopyOnWrite()
+{
+#ifdef SCSHM_SNAPSHOT_COW
+  size_t mapSize = m_copied.size() * m_pageSize;
+
+  // sparse memfd - pages are allocated only when writer modifies them
+  m_memFd = static_cast<int>(syscall(__NR_memfd_create, "scshm-snapshot", MFD_CLOEXEC));
+  if (m_memFd < 0)
+    return;
+
+  if (ftruncate(m_memFd, mapSize) != 0) {
+    freeHandles();
+    return;
+  }
+
+  void *copy = mmap(SC_NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_memFd, 0);
+  if (copy == MAP_FAILED) {
+    freeHandles();
+    return;
+  }
+  m_copy = static_cast<char *>(copy);
+
+  m_faultFd = shm_snapshot_open_fault_fd();
+  if (m_faultFd < 0) {
+    freeHandles();
+    return;
+  }
+
+  struct uffdio_register reg;
+  std::memset(&reg, 0, sizeof(reg));
+  reg.range.start = reinterpret_cast<unsigned long>(m_source);
+  reg.range.len = mapSize;
+  reg.mode = UFFDIO_REGISTER_MODE_WP;
+  if (ioctl(m_faultFd, UFFDIO_REGISTER, &reg) != 0) {
+    freeHandles();
+    return;
+  }
+
+#ifdef MADV_POPULATE_WRITE
+  // older kernels can protect only pages present in page table
+  madvise(m_source, mapSize, MADV_POPULATE_WRITE);
+#endif
+
+  m_stopFd = eventfd(0, EFD_CLOEXEC);
+  if (m_stopFd < 0) {
+    freeHandles();
+    return;
+  }
+
+  pthread_t *thread = new pthread_t;
+  if (pthread_create(thread, SC_NULL, handlerEntry, this) != 0) {
+    delete thread;
+    freeHandles();
+    return;
+  }
+  m_thread = thread;
+
+  // snapshot point - from now on each first write to a page is intercepted
+  if (!shm_snapshot_protect(m_faultFd, m_source, mapSize, true)) {
+    freeHandles();
+    return;
+  }
+
+  m_copyOnWrite = true;
+#endif
+}
+
+void scSharedMemorySnapshot::initFullCopy()
+{
+  m_copy = new char[m_size];
+  std::memcpy(m_copy, m_source, m_size);
+  std::fill(m_copied.begin(), m_copied.end(), 1);
+  m_copiedCount = m_copied.size();
+}
+
+void scSharedMemorySnapshot::freeHandles()
+{
+#ifdef SCSHM_SNAPSHOT_COW
+  size_t mapSize = m_copied.size() * m_pageSize;
+
+  if (m_thread != SC_NULL) {
+    pthread_t *thread = static_cast<pthread_t *>(m_thread);
+    uint64_t stopValue = 1;
+    if (write(m_stopFd, &stopValue, sizeof(stopValue)) == sizeof(stopValue))
+      pthread_join(*thread, SC_NULL);
+    delete thread;
+    m_thread = SC_NULL;
+  }
+
+  if (m_faultFd >= 0) {
+    // unregister also releases write-protection and wakes blocked writers
+    shm_snapshot_protect(m_faultFd, m_source, mapSize, false);
+    struct uffdio_range range;
+    range.start = reinterpret_cast<unsigned long>(m_source);
+    range.len = mapSize;
+    ioctl(m_faultFd, UFFDIO_UNREGISTER, &range);
+    close(m_faultFd);
+    m_faultFd = -1;
+  }
+
+  if (m_stopFd >= 0) {
+    close(m_stopFd);
+    m_stopFd = -1;
+  }
+
+  if (m_memFd >= 0) {
+    if (m_copy != SC_NULL)
+      munmap(m_copy, mapSize);
+    m_copy = SC_NULL;
+    close(m_memFd);
+    m_memFd = -1;
+  }
+#endif
+
+  delete [] m_copy;
+  m_copy = SC_NULL;
+}
+
+#ifdef __linux__
+void *scSharedMemorySnapshot::handlerEntry(void *arg)
+{
+  static_cast<scSharedMemorySnapshot *>(arg)->handleFaults();
+  return SC_NULL;
+}
+
+void scSharedMemorySnapshot::handleFaults()
+{
+#ifdef SCSHM_SNAPSHOT_COW
+  struct pollfd fds[2];
+  fds[0].fd = m_faultFd;
+  fds[0].events = POLLIN;
+  fds[1].fd = m_stopFd;
+  fds[1].events = POLLIN;
+
+  for(;;) {
+    if (poll(fds, 2, -1) < 0)
+      continue;
+    if (fds[1].revents != 0)
+      break;
+
+    struct uffd_msg msg;
+    while (::read(m_faultFd, &msg, sizeof(msg)) == sizeof(msg))
+    {
+      if ((msg.event != UFFD_EVENT_PAGEFAULT) || !(msg.arg.pagefault.flags & UFFD_PAGEFAULT_FLAG_WP))
+        continue;
+
+      size_t pageOffset = static_cast<size_t>(msg.arg.pagefault.address - reinterpret_cast<unsigned long>(m_source));
+      pageOffset -= pageOffset % m_pageSize;
+      size_t pageNo = pageOffset / m_pageSize;
+
+      if (!isPageCopied(pageNo)) {
+        std::memcpy(m_copy + pageOffset, m_source + pageOffset, m_pageSize);
+        // readers of live page verify this flag after reading
+        __atomic_store_n(&m_copied[pageNo], 1, __ATOMIC_SEQ_CST);
+        // read by owner thread
+        __atomic_add_fetch(&m_copiedCount, 1, __ATOMIC_RELAXED);
+      }
+
+      // unprotect & wake writer
+      shm_snapshot_protect(m_faultFd, m_source + pageOffset, m_pageSize, false);
+    }
+  }
+#endif
+}
+#endif
+
+bool scSharedMemorySnapshot::isPageCopied(size_t pageNo) const
+{
+#ifdef __linux__
+  return (__atomic_load_n(&m_copied[pageNo], __ATOMIC_SEQ_CST) != 0);
+#else
+  return (m_copied[pageNo] != 0);
+#endif
+}
+
+const char *scSharedMemorySnapshot::readPage(size_t pageNo, size_t pageOffset, size_t len, char *buffer)
+{
+  size_t offset = pageNo * m_pageSize + pageOffset;
+
+  if (isPageCopied(pageNo))
+    return m_copy + offset;
+
+  // page not modified yet - read live data, it is still valid if page was
+  // not copied in the meantime (writer is unblocked only after copy)
+  std::memcpy(buffer, m_source + offset, len);
+#ifdef __linux__
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+#endif
+  if (isPageCopied(pageNo))
+    return m_copy + offset;
+
+  return buffer;
+}
+
+size_t scSharedMemorySnapshot::read(void *output, size_t aOffset, size_t aSize)
+{
+  if (aOffset >= m_size)
+    return 0;
+
+  size_t endPos = SC_MIN(m_size, aOffset + aSize);
+  char *optr = static_cast<char *>(output);
+  size_t pos = aOffset;
+
+  while (pos < endPos)
+  {
+    size_t pageNo = pos / m_pageSize;
+    size_t pageOffset = pos % m_pageSize;
+    size_t len = SC_MIN(m_pageSize - pageOffset, endPos - pos);
+    char *dest = optr + (pos - aOffset);
+
+    const char *src = readPage(pageNo, pageOffset, len, dest);
+    if (src != dest)
+      std::memcpy(dest, src, len);
+
+    pos += len;
+  }
+
+  return endPos - aOffset;
+}
+
+size_t scSharedMemorySnapshot::read(scShmWinConsumerIntf *consumer, size_t aOffset, size_t aSize)
+{
+  if (aOffset >= m_size)
+    return 0;
+
+  size_t endPos = SC_MIN(m_size, aOffset + aSize);
+  std::vector<char> buffer(m_pageSize);
+  size_t pos = aOffset;
+
+  while (pos < endPos)
+  {
+    size_t pageNo = pos / m_pageSize;
+    size_t pageOffset = pos % m_pageSize;
+    size_t len = SC_MIN(m_pageSize - pageOffset, endPos - pos);
+
+    consumer->process(readPage(pageNo, pageOffset, len, &buffer[0]), len);
+
+    pos += len;
+  }
+
+  return endPos - aOffset;
+}
+
+size_t scSharedMemorySnapshot::getSize() const
+{
+  return m_size;
+}
+
+size_t scSharedMemorySnapshot::getCopiedPageCount() const
+{
+#ifdef __linux__
+  return __atomic_load_n(&m_copiedCount, __ATOMIC_RELAXED);
+#else
+  return m_copiedCount;
+#endif
+}
+
+bool scSharedMemorySnapshot::isCopyOnWrite() const
+{
+  return m_copyOnWrite;
+}
@@ -0,0 +1,742 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        SharedMemoryTrace.cpp
+// Project:     scLib
+// Purpose:     Recording and replay of shared memory block operations
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#include "sc/proc/SharedMemoryTrace.h"
+
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+
+#include "sc/proc/SharedMemoryBlock.h"
+#include "sc/proc/SharedResource.h"
+#include "sc/utils.h"
+
+// ----------------------------------------------------------------------------
+// trace file layout
+// ----------------------------------------------------------------------------
+const char SC_SHM_TRACE_MAGIC[8] = {'S', 'C', 'S', 'H', 'T', 'R', 'C', '1'};
+const size_t SC_SHM_TRACE_BUFFER_SIZE = 64 * 1024;
+/// replay processes start together after this time per process
+const boost::uint64_t SC_SHM_TRACE_REPLAY_START_NS = 10000000;
+
+typedef std::map<scString, boost::uint32_t> ShmTraceIdMap;
+
+// recorder state, block operations are not thread-safe so no locking here
+static FILE *gs_traceFile = SC_NULL;
+static std::vector<char> gs_traceBuffer;
+static ShmTraceIdMap gs_traceIds;
+static boost::uint64_t gs_traceRecordCount = 0;
+static uint gs_traceDepth = 0;
+static boost::uint32_t gs_tracePid = 0;
+
+inline boost::uint32_t shm_trace_pid()
+{
+#ifdef WIN32
+  return GetCurrentProcessId();
+#else
+  return static_cast<boost::uint32_t>(getpid());
+#endif
+}
+
+inline void shm_trace_sleep_ns(boost::uint64_t value)
+{
+#ifdef WIN32
+  Sleep(static_cast<DWORD>(value / 1000000));
+#else
+  struct timespec ts;
+  ts.tv_sec = static_cast<time_t>(value / 1000000000ULL);
+  ts.tv_nsec = static_cast<long>(value % 1000000000ULL);
+  nanosleep(&ts, SC_NULL);
+#endif
+}
+
+// ----------------------------------------------------------------------------
+// scShmTraceRecorder
+// ----------------------------------------------------------------------------
+void scShmTraceRecorder::start(const scString &fileName)
+{
+  stop();
+
+  FILE *file = fopen(fileName.c_str(), "wb");
+  if (file == SC_NULL)
+    throw scError("Cannot create shared memory trace: ["+fileName+"]");
+
+  gs_traceFile = file;
+  gs_traceBuffer.clear();
+  gs_traceBuffer.reserve(SC_SHM_TRACE_BUFFER_SIZE);
+  gs_traceIds.clear();
+  gs_traceRecordCount = 0;
+  gs_traceDepth = 0;
+  gs_tracePid = shm_trace_pid();
+  append(SC_SHM_TRACE_MAGIC, sizeof(SC_SHM_TRACE_MAGIC));
+}
+
+void scShmTraceRecorder::stop()
+{
+  if (gs_traceFile == SC_NULL)
+    return;
+
+  flush();
+  fclose(gs_traceFile);
+  gs_traceFile = SC_NULL;
+  gs_traceIds.clear();
+}
+
+bool scShmTraceRecorder::isActive()
+{
+  return (gs_traceFile != SC_NULL);
+}
+
+boost::uint64_t scShmTraceRecorder::getRecordCount()
+{
+  return gs_traceRecordCount;
+}
+
+boost::uint64_t scShmTraceRecorder::getTime()
+{
+#ifdef WIN32
+  LARGE_INTEGER counter, freq;
+  QueryPerformanceCounter(&counter);
+  QueryPerformanceFrequency(&freq);
+  boost::uint64_t c = counter.QuadPart, f = freq.QuadPart;
+  return (c / f) * 1000000000ULL + ((c % f) * 1000000000ULL) / f;
+#else
+  // CLOCK_MONOTONIC is shared by all processes of the system
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<boost::uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+bool scShmTraceRecorder::enter()
+{
+  if (gs_traceFile == SC_NULL)
+    return false;
+  ++gs_traceDepth;
+  return true;
+}
+
+bool scShmTraceRecorder::isOutermost()
+{
+  // nested operations are part of the outer one
+  return (gs_traceDepth == 1);
+}
+
+void scShmTraceRecorder::leave()
+{
+  if (gs_traceDepth > 0)
+    --gs_traceDepth;
+}
+
+void scShmTraceRecorder::record(scShmTraceRecord &record, const scString &path, size_t blockSize, const scString *targetPath)
+{
+  if (gs_traceFile == SC_NULL)
+    return;
+
+  record.pid = gs_tracePid;
+  record.blockId = getBlockId(path, blockSize);
+  record.targetId = (targetPath != SC_NULL)?getBlockId(*targetPath, blockSize):0;
+  append(&record, sizeof(record));
+  ++gs_traceRecordCount;
+}
+
+boost::uint32_t scShmTraceRecorder::getBlockId(const scString &path, size_t blockSize)
+{
+  ShmTraceIdMap::const_iterator it = gs_traceIds.find(path);
+  if (it != gs_traceIds.end())
+    return it->second;
+
+  boost::uint32_t id = static_cast<boost::uint32_t>(gs_traceIds.size() + 1);
+  gs_traceIds.insert(std::make_pair(path, id));
+
+  scShmTraceRecord nameRecord;
+  std::memset(&nameRecord, 0, sizeof(nameRecord));
+  nameRecord.op = shtoName;
+  nameRecord.pid = gs_tracePid;
+  nameRecord.blockId = id;
+  nameRecord.size = blockSize;
+  nameRecord.dataSize = path.length();
+  append(&nameRecord, sizeof(nameRecord));
+  append(path.c_str(), path.length());
+  return id;
+}
+
+void scShmTraceRecorder::append(const void *data, size_t size)
+{
+  if (gs_traceBuffer.size() + size > SC_SHM_TRACE_BUFFER_SIZE)
+    flush();
+  const char *cptr = static_cast<const char *>(data);
+  gs_traceBuffer.insert(gs_traceBuffer.end(), cptr, cptr + size);
+}
+
+void scShmTraceRecorder::flush()
+{
+  if (!gs_traceBuffer.empty() && (gs_traceFile != SC_NULL))
+    fwrite(&gs_traceBuffer[0], 1, gs_traceBuffer.size(), gs_traceFile);
+  gs_traceBuffer.clear();
+}
+
+// ----------------------------------------------------------------------------
+// scShmTraceScope
+// ----------------------------------------------------------------------------
+scShmTraceScope::scShmTraceScope(scShmTraceOp op, const scString &path, size_t blockSize, size_t aOffset, size_t aLimit):
+  m_entered(scShmTraceRecorder::enter()), m_active(m_entered && scShmTraceRecorder::isOutermost()), m_path(&path), m_targetPath(SC_NULL), m_blockSize(blockSize)
+{
+  if (!m_active)
+    return;
+
+  std::memset(&m_record, 0, sizeof(m_record));
+  m_record.op = static_cast<boost::uint16_t>(op);
+  m_record.offset = aOffset;
+  m_record.size = aLimit;
+  m_record.timestamp = scShmTraceRecorder::getTime();
+}
+
+scShmTraceScope::~scShmTraceScope()
+{
+  if (m_active) {
+    boost::uint64_t duration = scShmTraceRecorder::getTime() - m_record.timestamp;
+    m_record.duration = static_cast<boost::uint32_t>(SC_MIN(duration, static_cast<boost::uint64_t>(0xffffffffU)));
+    if (std::uncaught_exception())
+      m_record.flags |= SC_SHM_TRACE_FAILED;
+    scShmTraceRecorder::record(m_record, *m_path, m_blockSize, m_targetPath);
+  }
+  if (m_entered)
+    scShmTraceRecorder::leave();
+}
+
+void scShmTraceScope::setDataSize(size_t value)
+{
+  m_record.dataSize = value;
+}
+
+void scShmTraceScope::setTarget(const scString &path, boost::uint16_t flags)
+{
+  m_targetPath = &path;
+  m_record.flags |= flags;
+}
+
+// ----------------------------------------------------------------------------
+// replay helpers
+// ----------------------------------------------------------------------------
+// touches one byte per cache line, as a minimal consumer would
+class ShmTraceReplayConsumer: public scShmWinConsumerIntf {
+public:
+  ShmTraceReplayConsumer(): scShmWinConsumerIntf(), m_sum(0) {}
+
+  void process(const char *cptr, size_t size)
+  {
+    for(size_t i = 0; i < size; i += 64)
+      m_sum += static_cast<unsigned char>(cptr[i]);
+  }
+  uint getSum() const { return m_sum; }
+private:
+  uint m_sum;
+};
+
+class ShmTraceReplayWriter: public scShmWinWriterIntf {
+public:
+  ShmTraceReplayWriter(size_t dataSize): scShmWinWriterIntf(), m_dataSize(dataSize) {}
+
+  size_t write(char *output, size_t outputSize)
+  {
+    size_t res = SC_MIN(outputSize, m_dataSize);
+    std::memset(output, 0x5c, res);
+    return res;
+  }
+private:
+  size_t m_dataSize;
+};
+
+#ifndef WIN32
+static void shm_trace_write_all(int fd, const void *data, size_t size)
+{
+  const char *cptr = static_cast<const char *>(data);
+  while (size > 0) {
+    ssize_t res = ::write(fd, cptr, size);
+    if (res < 0) {
+      if (errno == EINTR)
+        continue;
+      throw scError("Cannot send replay results");
+    }
+    cptr += res;
+    size -= static_cast<size_t>(res);
+  }
+}
+
+static bool shm_trace_read_all(int fd, void *data, size_t size)
+{
+  char *cptr = static_cast<char *>(data);
+  while (size > 0) {
+    ssize_t res = ::read(fd, cptr, size);
+    if (res < 0) {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    if (res == 0)
+      return false;
+    cptr += res;
+    size -= static_cast<size_t>(res);
+  }
+  return true;
+}
+#endif
+
+// ----------------------------------------------------------------------------
+// scShmTraceReplayer
+// ----------------------------------------------------------------------------
+scShmTraceReplayer::scShmTraceReplayer(const scString &blockPrefix): m_blockPrefix(blockPrefix), m_speed(1.0)
+{
+  for(uint i = 0; i < shtoCount; i++)
+    m_errors[i] = 0;
+}
+
+scShmTraceReplayer::~scShmTraceReplayer()
+{
+  releaseBlocks();
+}
+
+void scShmTraceReplayer::addTrace(const scString &fileName)
+{
+  FILE *file = fopen(fileName.c_str(), "rb");
+  if (file == SC_NULL)
+    throw scError("Cannot open shared memory trace: ["+fileName+"]");
+
+  char magic[sizeof(SC_SHM_TRACE_MAGIC)];
+  if ((fread(magic, 1, sizeof(magic), file) != sizeof(magic)) ||
+      (std::memcmp(magic, SC_SHM_TRACE_MAGIC, sizeof(magic)) != 0))
+  {
+    fclose(file);
+    throw scError("Incorrect shared memory trace: ["+fileName+"]");
+  }
+
+  // block ids are local to trace file
+  std::map<boost::uint32_t, uint> blockNos;
+  size_t firstOp = m_ops.size();
+  TraceOp op;
+
+  while (fread(&op.record, sizeof(op.record), 1, file) == 1)
+  {
+    if (op.record.op == shtoName) {
+      std::vector<char> name(static_cast<size_t>(op.record.dataSize) + 1, '\0');
+      if ((op.record.dataSize > 0) && (fread(&name[0], static_cast<size_t>(op.record.dataSize), 1, file) != 1))
+        break;
+      blockNos[op.record.blockId] = addBlock(scString(&name[0]), static_cast<size_t>(op.record.size));
+      continue;
+    }
+
+    if (op.record.op >= shtoCount)
+      break;
+
+    std::map<boost::uint32_t, uint>::const_iterator it = blockNos.find(op.record.blockId);
+    if (it == blockNos.end())
+      continue;
+    op.blockNo = it->second;
+    op.targetNo = op.blockNo;
+    if (op.record.op == shtoCopy) {
+      it = blockNos.find(op.record.targetId);
+      if (it == blockNos.end())
+        continue;
+      op.targetNo = it->second;
+    }
+    if (op.record.op == shtoCreate)
+      m_blocks[op.blockNo].createdByTrace = true;
+    m_ops.push_back(op);
+  }
+
+  fclose(file);
+
+  // records of one file are already ordered
+  std::vector<TraceOp> merged;
+  merged.reserve(m_ops.size());
+  std::vector<TraceOp>::iterator middle = m_ops.begin() + firstOp;
+  for(std::vector<TraceOp>::iterator a = m_ops.begin(), b = middle; (a != middle) || (b != m_ops.end()); )
+  {
+    if ((b == m_ops.end()) || ((a != middle) && (a->record.timestamp <= b->record.timestamp)))
+      merged.push_back(*a++);
+    else
+      merged.push_back(*b++);
+  }
+  m_ops.swap(merged);
+}
+
+void scShmTraceReplayer::setSpeed(double speed)
+{
+  m_speed = (speed > 0.0)?speed:0.0;
+}
+
+uint scShmTraceReplayer::addBlock(const scString &name, size_t size)
+{
+  std::map<scString, uint>::const_iterator it = m_blockNames.find(name);
+  if (it != m_blockNames.end()) {
+    m_blocks[it->second].size = SC_MAX(m_blocks[it->second].size, size);
+    return it->second;
+  }
+
+  TraceBlock block;
+  block.name = m_blockPrefix + name;
+  block.size = size;
+  block.createdByTrace = false;
+  block.created = false;
+  m_blocks.push_back(block);
+
+  uint res = static_cast<uint>(m_blocks.size() - 1);
+  m_blockNames.insert(std::make_pair(name, res));
+  return res;
+}
+
+void scShmTraceReplayer::createBlocks()
+{
+  // blocks created before recording started are created before replay
+  for(std::vector<TraceBlock>::iterator it = m_blocks.begin(), epos = m_blocks.end(); it != epos; ++it)
+  {
+    if (it->createdByTrace || it->created || (it->size == 0))
+      continue;
+    scSharedMemoryBlock block(it->name, it->size);
+    block.create();
+    it->created = true;
+  }
+}
+
+void scShmTraceReplayer::releaseBlocks()
+{
+  if (!scSharedResourceManager::ready())
+    return;
+
+  const char *suffixes[] = {"", "_rd", "_wr"};
+  for(std::vector<TraceBlock>::iterator it = m_blocks.begin(), epos = m_blocks.end(); it != epos; ++it)
+  {
+    if (!it->created)
+      continue;
+    for(uint i = 0; i < sizeof(suffixes) / sizeof(suffixes[0]); i++)
+      if (scSharedResourceManager::find(it->name + suffixes[i]) != SC_NULL)
+        scSharedResourceManager::releaseRef(it->name + suffixes[i]);
+    it->created = false;
+  }
+}
+
+void scShmTraceReplayer::run()
+{
+  for(uint i = 0; i < shtoCount; i++) {
+    m_latency[i].clear();
+    m_original[i].clear();
+    m_errors[i] = 0;
+  }
+
+  createBlocks();
+
+  if (m_ops.empty())
+    return;
+
+  for(std::vector<TraceOp>::const_iterator it = m_ops.begin(), epos = m_ops.end(); it != epos; ++it)
+    if ((it->record.flags & SC_SHM_TRACE_FAILED) == 0)
+      m_original[it->record.op].push_back(it->record.duration);
+
+  boost::uint64_t traceStart = m_ops.front().record.timestamp;
+
+#ifndef WIN32
+  std::vector<boost::uint32_t> pids;
+  getPids(pids);
+  if (pids.size() > 1) {
+    replayInProcesses(pids, traceStart);
+    return;
+  }
+#endif
+
+  replayOps(0, traceStart, scShmTraceRecorder::getTime());
+}
+
+uint scShmTraceReplayer::getProcessCount() const
+{
+  std::vector<boost::uint32_t> pids;
+  getPids(pids);
+  return static_cast<uint>(pids.size());
+}
+
+void scShmTraceReplayer::getPids(std::vector<boost::uint32_t> &output) const
+{
+  output.clear();
+  for(std::vector<TraceOp>::const_iterator it = m_ops.begin(), epos = m_ops.end(); it != epos; ++it)
+    output.push_back(it->record.pid);
+  std::sort(output.begin(), output.end());
+  output.erase(std::unique(output.begin(), output.end()), output.end());
+}
+
+void scShmTraceReplayer::replayOps(boost::uint32_t pid, boost::uint64_t traceStart, boost::uint64_t replayStart)
+{
+  for(std::vector<TraceOp>::const_iterator it = m_ops.begin(), epos = m_ops.end(); it != epos; ++it)
+  {
+    const scShmTraceRecord &record = it->record;
+    if ((record.flags & SC_SHM_TRACE_FAILED) != 0)
+      continue;
+    if ((pid != 0) && (record.pid != pid))
+      continue;
+
+    if (m_speed > 0.0)
+      waitUntil(replayStart + static_cast<boost::uint64_t>((record.timestamp - traceStart) / m_speed));
+
+    boost::uint64_t startTime = scShmTraceRecorder::getTime();
+    try {
+      execute(*it);
+    }
+    catch(std::exception &) {
+      m_errors[record.op]++;
+      continue;
+    }
+    if (record.op != shtoRegister)
+      m_latency[record.op].push_back(scShmTraceRecorder::getTime() - startTime);
+  }
+}
+
+#ifndef WIN32
+void scShmTraceReplayer::replayInProcesses(const std::vector<boost::uint32_t> &pids, boost::uint64_t traceStart)
+{
+  // blocks created by one replay process are used by others, so all of them
+  // are released after every process finished its part
+  int releaseFds[2];
+  if (pipe(releaseFds) != 0)
+    throw scError("Cannot create replay pipe");
+
+  boost::uint64_t replayStart = scShmTraceRecorder::getTime() + SC_SHM_TRACE_REPLAY_START_NS * pids.size();
+  std::vector<pid_t> children;
+  std::vector<int> resultFds;
+
+  for(std::vector<boost::uint32_t>::const_iterator it = pids.begin(), epos = pids.end(); it != epos; ++it)
+  {
+    int fds[2];
+    if (pipe(fds) != 0)
+      break;
+
+    pid_t child = fork();
+    if (child == 0) {
+      int exitCode = 0;
+      try {
+        ::close(fds[0]);
+        ::close(releaseFds[1]);
+        replayOps(*it, traceStart, replayStart);
+
+        for(uint op = 0; op < shtoCount; op++) {
+          boost::uint64_t count = m_latency[op].size();
+          shm_trace_write_all(fds[1], &m_errors[op], sizeof(m_errors[op]));
+          shm_trace_write_all(fds[1], &count, sizeof(count));
+          if (count > 0)
+            shm_trace_write_all(fds[1], &m_latency[op][0], count * sizeof(m_latency[op][0]));
+        }
+        ::close(fds[1]);
+
+        char c;
+        while ((::read(releaseFds[0], &c, 1) < 0) && (errno == EINTR))
+          ;
+        releaseBlocks();
+      }
+      catch(...) {
+        exitCode = 1;
+      }
+      // parent's resources and buffers are not released by child
+      _exit(exitCode);
+    }
+
+    ::close(fds[1]);
+    if (child < 0) {
+      ::close(fds[0]);
+      break;
+    }
+    children.push_back(child);
+    resultFds.push_back(fds[0]);
+  }
+
+  bool failed = (children.size() != pids.size());
+  for(size_t i = 0, epos = resultFds.size(); i < epos; i++)
+  {
+    for(uint op = 0; (op < shtoCount) && !failed; op++) {
+      uint errors;
+      boost::uint64_t count;
+      if (!shm_trace_read_all(resultFds[i], &errors, sizeof(errors)) ||
+          !shm_trace_read_all(resultFds[i], &count, sizeof(count))) {
+        failed = true;
+        break;
+      }
+      m_errors[op] += errors;
+      size_t oldSize = m_latency[op].size();
+      m_latency[op].resize(oldSize + static_cast<size_t>(count));
+      if ((count > 0) &&
+          !shm_trace_read_all(resultFds[i], &m_latency[op][oldSize], static_cast<size_t>(count) * sizeof(m_latency[op][0])))
+        failed = true;
+    }
+    ::close(resultFds[i]);
+  }
+
+  ::close(releaseFds[1]);
+  ::close(releaseFds[0]);
+  for(std::vector<pid_t>::const_iterator it = children.begin(), epos = children.end(); it != epos; ++it)
+  {
+    int status = 0;
+    while ((waitpid(*it, &status, 0) < 0) && (errno == EINTR))
+      ;
+    if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+      failed = true;
+  }
+
+  if (failed)
+    throw scError("Shared memory trace replay process failed");
+}
+#endif
+
+void scShmTraceReplayer::execute(const TraceOp &op)
+{
+  const scShmTraceRecord &record = op.record;
+  TraceBlock &block = m_blocks[op.blockNo];
+
+  switch (record.op) {
+    case shtoCreate: {
+      scSharedMemoryBlock shmBlock(block.name, block.size);
+      shmBlock.create();
+      block.created = true;
+      break;
+    }
+    case shtoRead: {
+      ShmTraceReplayConsumer consumer;
+      scSharedMemoryBlock::read(scSharedMemoryBlock::intern(block.name, block.size), &consumer,
+        static_cast<size_t>(record.offset), static_cast<size_t>(record.size));
+      break;
+    }
+    case shtoWrite: {
+      ShmTraceReplayWriter writer(static_cast<size_t>(record.dataSize));
+      scSharedMemoryBlock::write(scSharedMemoryBlock::intern(block.name, block.size), &writer,
+        static_cast<size_t>(record.offset), static_cast<size_t>(record.size));
+      break;
+    }
+    case shtoCopy: {
+      TraceBlock &target = m_blocks[op.targetNo];
+      scSharedMemoryBlock::copy(
+        scSharedMemoryBlock::intern(block.name, block.size),
+        scSharedMemoryBlock::intern(target.name, target.size),
+        static_cast<size_t>(record.offset), static_cast<size_t>(record.size),
+        (record.flags & SC_SHM_TRACE_READ_ONLY) != 0);
+      break;
+    }
+    case shtoRelease:
+      // resources of the replay are named like recorded ones, with prefix
+      if (scSharedResourceManager::find(block.name) != SC_NULL)
+        scSharedResourceManager::releaseRef(block.name);
+      break;
+    default:
+      // registration of other resources cannot be repeated, it is reported
+      // with original durations only
+      break;
+  }
+}
+
+void scShmTraceReplayer::waitUntil(boost::uint64_t time)
+{
+  boost::uint64_t now = scShmTraceRecorder::getTime();
+  // sleep is coarse, last part is spent spinning
+  while (now + 2000000 < time) {
+    shm_trace_sleep_ns(time - now - 1000000);
+    now = scShmTraceRecorder::getTime();
+  }
+  while (now < time)
+    now = scShmTraceRecorder::getTime();
+}
+
+const char *scShmTraceReplayer::getOpName(scShmTraceOp op)
+{
+  switch (op) {
+    case shtoName: return "name";
+    case shtoCreate: return "create";
+    case shtoRead: return "read";
+    case shtoWrite: return "write";
+    case shtoCopy: return "copy";
+    case shtoRegister: return "register";
+    case shtoRelease: return "release";
+    default: return "unknown";
+  }
+}
+
+uint scShmTraceReplayer::getCount(scShmTraceOp op) const
+{
+  return static_cast<uint>(m_original[op].size());
+}
+
+uint scShmTraceReplayer::getErrorCount(scShmTraceOp op) const
+{
+  return m_errors[op];
+}
+
+boost::uint64_t scShmTraceReplayer::getPercentile(scShmTraceOp op, double percent, bool original) const
+{
+  return calcPercentile(original?m_original[op]:m_latency[op], percent);
+}
+
+boost::uint64_t scShmTraceReplayer::calcPercentile(const LatencyColn &values, double percent)
+{
+  if (values.empty())
+    return 0;
+
+  LatencyColn sorted(values);
+  std::sort(sorted.begin(), sorted.end());
+
+  // nearest rank
+  double rank = (percent / 100.0) * sorted.size();
+  size_t idx = static_cast<size_t>(rank);
+  if ((static_cast<double>(idx) < rank) || (idx == 0))
+    idx++;
+  return sorted[SC_MIN(idx, sorted.size()) - 1];
+}
+
+scString scShmTraceReplayer::getReport() const
+{
+  const double percents[] = {50.0, 90.0, 99.0, 99.9, 100.0};
+  const uint percentCount = sizeof(percents) / sizeof(percents[0]);
+  char line[256];
+
+  scString res;
+  snprintf(line, sizeof(line), "%-9s %-8s %8s %8s %10s %10s %10s %10s %10s\n",
+    "op", "source", "count", "errors", "p50[us]", "p90[us]", "p99[us]", "p99.9[us]", "max[us]");
+  res += line;
+
+  for(uint op = shtoCreate; op < shtoCount; op++)
+  {
+    if (m_original[op].empty())
+      continue;
+
+    for(uint pass = 0; pass < 2; pass++)
+    {
+      bool original = (pass == 1);
+      const LatencyColn &values = original?m_original[op]:m_latency[op];
+
+      snprintf(line, sizeof(line), "%-9s %-8s %8u %8u", getOpName(static_cast<scShmTraceOp>(op)),
+        original?"trace":"replay", static_cast<uint>(values.size()), original?0U:m_errors[op]);
+      res += line;
+
+      for(uint i = 0; i < percentCount; i++) {
+        if (values.empty())
+          snprintf(line, sizeof(line), " %10s", "-");
+        else
+          snprintf(line, sizeof(line), " %10.1f", calcPercentile(values, percents[i]) / 1000.0);
+        res += line;
+      }
+      res += "\n";
+    }
+  }
+
+  return res;
+}
@@ -0,0 +1,248 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        SharedMemoryTransaction.cpp
+// Project:     scLib
+// Purpose:     Atomic updates of multiple shared memory blocks
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#include "sc/proc/SharedMemoryTransaction.h"
+
+#include <cstring>
+
+#include <boost/interprocess/detail/atomic.hpp>
+#include <boost/interprocess/detail/os_thread_functions.hpp>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <signal.h>
+#endif
+
+#include "sc/utils.h"
+
+using namespace boost::interprocess::ipcdetail;
+
+/// number of waits after which owner of commit is checked
+const uint SC_SHM_TRANS_CHECK_SPINS = 1024;
+
+// shared layout of commit record
+struct scShmCommitLayout {
+  /// odd while commit is in progress
+  volatile boost::uint32_t sequence;
+  /// pid of writer, 0 - none
+  volatile boost::uint32_t owner;
+  /// number of commits abandoned by dead writers
+  volatile boost::uint32_t recoveries;
+};
+
+static boost::uint32_t shm_trans_current_pid()
+{
+  return static_cast<boost::uint32_t>(get_current_process_id());
+}
+
+static bool shm_trans_process_exists(boost::uint32_t pid)
+{
+#ifdef WIN32
+  HANDLE handle = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+  if (handle == NULL)
+    return (GetLastError() == ERROR_ACCESS_DENIED);
+  DWORD exitCode = 0;
+  bool res = (GetExitCodeProcess(handle, &exitCode) != 0) && (exitCode == STILL_ACTIVE);
+  CloseHandle(handle);
+  return res;
+#else
+  return (kill(static_cast<pid_t>(pid), 0) == 0) || (errno != ESRCH);
+#endif
+}
+
+// orders data reads before validation of sequence
+inline void shm_trans_read_fence()
+{
+#ifdef WIN32
+  MemoryBarrier();
+#else
+  __sync_synchronize();
+#endif
+}
+
+class ShmTransStagedWriter: public scShmWinWriterIntf {
+public:
+  ShmTransStagedWriter(const std::vector<char> &input): scShmWinWriterIntf(), m_input(input) {}
+
+  size_t write(char *output, size_t outputSize)
+  {
+    size_t dataLimit = SC_MIN(outputSize, m_input.size());
+    if (dataLimit > 0)
+      std::memcpy(output, &m_input[0], dataLimit);
+    return dataLimit;
+  }
+private:
+  const std::vector<char> &m_input;
+};
+
+// ----------------------------------------------------------------------------
+// scShmCommitRecord
+// ----------------------------------------------------------------------------
+scShmCommitRecord::scShmCommitRecord(const scString &a_path, uint a_useFlags)
+{
+  m_memory.reset(new scSharedMemory(a_path, scsmReadWrite, a_useFlags, sizeof(scShmCommitLayout)));
+  m_layout = static_cast<scShmCommitLayout *>(m_memory->getAddress());
+  if ((a_useFlags & scsmCreate) != 0) {
+    atomic_write32(const_cast<boost::uint32_t *>(&m_layout->sequence), 0);
+    atomic_write32(const_cast<boost::uint32_t *>(&m_layout->owner), 0);
+    atomic_write32(const_cast<boost::uint32_t *>(&m_layout->recoveries), 0);
+  }
+}
+
+scShmCommitRecord::~scShmCommitRecord()
+{
+}
+
+scShmCommitSeq scShmCommitRecord::beginRead()
+{
+  scShmCommitSeq res;
+  uint spins = 0;
+  while (((res = atomic_read32(&m_layout->sequence)) & 1) != 0)
+  {
+    if (++spins % SC_SHM_TRANS_CHECK_SPINS == 0)
+      recoverDeadWriter();
+    thread_yield();
+  }
+  return res;
+}
+
+bool scShmCommitRecord::validate(scShmCommitSeq seq)
+{
+  shm_trans_read_fence();
+  return (atomic_read32(&m_layout->sequence) == seq);
+}
+
+scShmCommitSeq scShmCommitRecord::getCommitCount()
+{
+  return atomic_read32(&m_layout->sequence) / 2;
+}
+
+uint scShmCommitRecord::getRecoveryCount()
+{
+  return atomic_read32(&m_layout->recoveries);
+}
+
+void scShmCommitRecord::beginCommit()
+{
+  // owner excludes concurrent writers, then sequence even -> odd
+  boost::uint32_t pid = shm_trans_current_pid();
+  uint spins = 0;
+  while (atomic_cas32(&m_layout->owner, pid, 0) != 0)
+  {
+    if (++spins % SC_SHM_TRANS_CHECK_SPINS == 0)
+      recoverDeadWriter();
+    thread_yield();
+  }
+  atomic_inc32(&m_layout->sequence);
+}
+
+void scShmCommitRecord::endCommit()
+{
+  atomic_inc32(&m_layout->sequence);
+  atomic_write32(&m_layout->owner, 0);
+}
+
+bool scShmCommitRecord::recoverDeadWriter()
+{
+  boost::uint32_t owner = atomic_read32(&m_layout->owner);
+  if ((owner == 0) || shm_trans_process_exists(owner))
+    return false;
+
+  // only one process takes over record of dead writer
+  if (atomic_cas32(&m_layout->owner, shm_trans_current_pid(), owner) != owner)
+    return false;
+
+  // partial commit becomes visible as a new version
+  if ((atomic_read32(&m_layout->sequence) & 1) != 0) {
+    atomic_inc32(&m_layout->sequence);
+    atomic_inc32(&m_layout->recoveries);
+  }
+  atomic_write32(&m_layout->owner, 0);
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+// scShmTransaction
+// ----------------------------------------------------------------------------
+scShmTransaction::scShmTransaction(scShmCommitRecord &record): m_record(record)
+{
+}
+
+scShmTransaction::~scShmTransaction()
+{
+}
+
+void scShmTransaction::write(const scString &blockPath, size_t blockSize, scShmWinWriterIntf *writer, size_t aOffset, size_t aLimit)
+{
+  write(scSharedMemoryBlock::intern(blockPath, blockSize), writer, aOffset, aLimit);
+}
+
+void scShmTransaction::write(scShmBlockHandle handle, scShmWinWriterIntf *writer, size_t aOffset, size_t aLimit)
+{
+  size_t blockSize = scSharedMemoryBlock::getSize(handle);
+  if (aOffset + aLimit > blockSize)
+    throw std::runtime_error(
+      scString("Shared block offset + limit incorrect")+
+        ", size="+toString(blockSize)+
+        ", offset="+toString(aOffset)+
+        ", limit="+toString(aLimit)+
+        ", path=["+scSharedMemoryBlock::getPath(handle)+"]");
+
+  // block data starts with its length
+  size_t capacity = (aLimit > sizeof(size_t))?aLimit - sizeof(size_t):0;
+
+  std::auto_ptr<StagedWrite> staged(new StagedWrite());
+  staged->handle = handle;
+  staged->offset = aOffset;
+  staged->limit = aLimit;
+  staged->data.resize(capacity);
+
+  size_t bytesWritten = 0;
+  if (capacity > 0)
+    bytesWritten = writer->write(&staged->data[0], capacity);
+  staged->data.resize(bytesWritten);
+
+  m_staged.push_back(staged.release());
+}
+
+void scShmTransaction::commit()
+{
+  if (m_staged.empty())
+    return;
+
+  m_record.beginCommit();
+  try {
+    for(StagedWriteColn::iterator it = m_staged.begin(), epos = m_staged.end(); it != epos; ++it)
+    {
+      ShmTransStagedWriter writer(it->data);
+      scSharedMemoryBlock::write(it->handle, &writer, it->offset, it->limit);
+    }
+  }
+  catch(...) {
+    // readers must not stay blocked, partial commit is visible as new version
+    m_record.endCommit();
+    m_staged.clear();
+    throw;
+  }
+  m_record.endCommit();
+
+  m_staged.clear();
+}
+
+void scShmTransaction::rollback()
+{
+  m_staged.clear();
+}
+
+size_t scShmTransaction::getStagedCount() const
+{
+  return m_staged.size();
+}
@@ -0,0 +1,172 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        SharedMemoryWarmer.cpp
+// Project:     scLib
+// Purpose:     Prefaulting and residency check of mapped memory
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#include "sc/proc/SharedMemoryWarmer.h"
+
+#include "boost/interprocess/mapped_region.hpp"
+
+#ifndef WIN32
+#include <errno.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#endif
+
+#include "sc/utils.h"
+
+scShmWarmer::scShmWarmer(void *address, size_t size, scShmWarmMode mode, uint threadCount)
+{
+  size_t pageSize = boost::interprocess::mapped_region::get_page_size();
+  size_t pageCount = (size + pageSize - 1) / pageSize;
+
+  if (threadCount == 0)
+    threadCount = 1;
+  if (threadCount > pageCount)
+    threadCount = static_cast<uint>(SC_MAX(pageCount, static_cast<size_t>(1)));
+
+  // each thread gets continuous, page-aligned part of range
+  size_t pagesPerThread = (pageCount + threadCount - 1) / threadCount;
+  char *cptr = static_cast<char *>(address);
+  size_t pos = 0;
+
+  while (pos < size)
+  {
+    WarmerTask task;
+    task.address = cptr + pos;
+    task.size = SC_MIN(pagesPerThread * pageSize, size - pos);
+    task.mode = mode;
+    m_tasks.push_back(task);
+    pos += task.size;
+  }
+
+#ifdef WIN32
+  // no background workers on this platform
+  for(size_t i = 0, epos = m_tasks.size(); i != epos; i++)
+    warm(m_tasks[i].address, m_tasks[i].size, m_tasks[i].mode);
+#else
+  for(size_t i = 0, epos = m_tasks.size(); i != epos; i++)
+  {
+    pthread_t *thread = new pthread_t;
+    if (pthread_create(thread, SC_NULL, workerEntry, &m_tasks[i]) != 0) {
+      delete thread;
+      warm(m_tasks[i].address, m_tasks[i].size, m_tasks[i].mode);
+    } else {
+      m_threads.push_back(thread);
+    }
+  }
+#endif
+}
+
+scShmWarmer::~scShmWarmer()
+{
+  wait();
+}
+
+void scShmWarmer::wait()
+{
+#ifndef WIN32
+  for(size_t i = 0, epos = m_threads.size(); i != epos; i++)
+  {
+    pthread_t *thread = static_cast<pthread_t *>(m_threads[i]);
+    pthread_join(*thread, SC_NULL);
+    delete thread;
+  }
+#endif
+  m_threads.clear();
+}
+
+#ifndef WIN32
+void *scShmWarmer::workerEntry(void *arg)
+{
+  WarmerTask *task = static_cast<WarmerTask *>(arg);
+  warm(task->address, task->size, task->mode);
+  return SC_NULL;
+}
+#endif
+
+void scShmWarmer::touch(const void *address, size_t size)
+{
+  size_t pageSize = boost::interprocess::mapped_region::get_page_size();
+  const volatile char *cptr = static_cast<const volatile char *>(address);
+  char sum = 0;
+
+  for(size_t pos = 0; pos < size; pos += pageSize)
+    sum ^= cptr[pos];
+  if (size > 0)
+    sum ^= cptr[size - 1];
+
+  // keep loads from being optimized out, read-modify-write so sink is used
+  static volatile char sink;
+  sink ^= sum;
+}
+
+bool scShmWarmer::warm(void *address, size_t size, scShmWarmMode mode)
+{
+  if (size == 0)
+    return true;
+
+#ifndef WIN32
+  size_t pageSize = boost::interprocess::mapped_region::get_page_size();
+  char *start = static_cast<char *>(address);
+  char *alignedStart = start - (reinterpret_cast<size_t>(start) % pageSize);
+  size_t alignedSize = size + (start - alignedStart);
+
+  switch (mode) {
+    case shwmAdvise:
+      return (posix_madvise(alignedStart, alignedSize, POSIX_MADV_WILLNEED) == 0);
+#ifdef MADV_POPULATE_READ
+    case shwmPopulateRead:
+      if (madvise(alignedStart, alignedSize, MADV_POPULATE_READ) == 0)
+        return true;
+      break;
+    case shwmPopulateWrite:
+      if (madvise(alignedStart, alignedSize, MADV_POPULATE_WRITE) == 0)
+        return true;
+      break;
+#endif
+    default:
+      break;
+  }
+#endif
+
+  touch(address, size);
+  return ((mode == shwmTouch) || (mode == shwmPopulateRead));
+}
+
+bool scShmWarmer::getResidentSize(const void *address, size_t size, size_t &output)
+{
+#ifndef WIN32
+  size_t pageSize = boost::interprocess::mapped_region::get_page_size();
+  const char *start = static_cast<const char *>(address);
+  const char *alignedStart = start - (reinterpret_cast<size_t>(start) % pageSize);
+  size_t alignedSize = size + (start - alignedStart);
+  size_t pageCount = (alignedSize + pageSize - 1) / pageSize;
+
+  output = 0;
+  if (pageCount == 0)
+    return true;
+
+#ifdef __linux__
+  std::vector<unsigned char> pageFlags(pageCount);
+#else
+  std::vector<char> pageFlags(pageCount);
+#endif
+  if (mincore(const_cast<char *>(alignedStart), alignedSize, &pageFlags[0]) != 0)
+    return false;
+
+  for(size_t i = 0; i < pageCount; i++)
+    if (pageFlags[i] & 1)
+      output += pageSize;
+
+  output = SC_MIN(output, alignedSize);
+  return true;
+#else
+  output = 0;
+  return false;
+#endif
+}
@@ -0,0 +1,280 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        SharedMemoryWindow.cpp
+// Project:     scLib
+// Purpose:     Windowed access to large shared memory segments
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#ifdef WIN32
+#define SCSHM_WINDOWS
+#endif
+
+//sc
+#include "sc/proc/SharedMemoryWindow.h"
+#include "sc/utils.h"
+
+#include "boost/interprocess/mapped_region.hpp"
+
+#ifdef SCSHM_WINDOWS
+#include <boost/interprocess/windows_shared_memory.hpp>
+#else
+#include <boost/interprocess/shared_memory_object.hpp>
+#endif
+
+#ifdef SCSHM_WINDOWS
+typedef boost::interprocess::windows_shared_memory scSharedMemObject;
+#else
+typedef boost::interprocess::shared_memory_object scSharedMemObject;
+#endif
+typedef boost::interprocess::mapped_region scSharedMemRegion;
+
+scSharedMemoryWindow::scSharedMemoryWindow(const scString &a_path, scsmAccessMode accessMode, uint a_useFlags,
+  scShmOffset a_segmentSize, size_t a_windowSize):
+  m_objectHandle(SC_NULL), m_regionHandle(SC_NULL),
+  m_path(a_path), m_accessMode(accessMode),
+  m_ownsResource((a_useFlags & scsmOwner) != 0), m_sequential(false),
+  m_segmentSize(a_segmentSize), m_windowOffset(0), m_windowLength(0), m_windowAddress(SC_NULL),
+  m_pos(0), m_mapCount(0)
+{
+  using namespace boost::interprocess;
+
+  // windows must start on page boundary, so window needs to be at least
+  // one page larger than any range requested by map()
+  size_t pageSize = scSharedMemRegion::get_page_size();
+  if (a_windowSize < pageSize)
+    a_windowSize = pageSize;
+  m_windowSize = ((a_windowSize + pageSize - 1) / pageSize) * pageSize;
+
+  bool createResource = ((a_useFlags & scsmCreate) != 0);
+  boost::interprocess::mode_t mode = (accessMode == scsmReadOnly)?read_only:read_write;
+
+  if (createResource) {
+#ifndef SCSHM_WINDOWS
+    scSharedMemObject::remove(stringToCharPtr(a_path));
+#endif
+    m_objectHandle = new scSharedMemObject
+     (open_or_create
+     ,stringToCharPtr(a_path)
+     ,mode
+#ifdef SCSHM_WINDOWS
+     ,m_segmentSize
+#endif
+     );
+#ifndef SCSHM_WINDOWS
+    if (m_segmentSize > 0)
+      ((scSharedMemObject *)m_objectHandle)->truncate(m_segmentSize);
+#endif
+  } else {
+    m_objectHandle = new scSharedMemObject
+     (open_only
+     ,stringToCharPtr(a_path)
+     ,mode
+     );
+  }
+}
+
+scSharedMemoryWindow::~scSharedMemoryWindow()
+{
+  freeHandles();
+#ifndef SCSHM_WINDOWS
+  if (m_ownsResource && (m_path.length() > 0))
+    scSharedMemObject::remove(m_path.c_str());
+#endif
+}
+
+void scSharedMemoryWindow::freeHandles()
+{
+  unmapWindow();
+  delete ((scSharedMemObject *)m_objectHandle);
+  m_objectHandle = SC_NULL;
+}
+
+void scSharedMemoryWindow::unmapWindow()
+{
+  delete ((scSharedMemRegion *)m_regionHandle);
+  m_regionHandle = SC_NULL;
+  m_windowAddress = SC_NULL;
+  m_windowLength = 0;
+}
+
+void scSharedMemoryWindow::mapWindow(scShmOffset pos)
+{
+  using namespace boost::interprocess;
+
+  if (pos >= m_segmentSize)
+    throw scError(scString("Shared window position outside of segment")+
+      ", pos="+toString(pos)+
+      ", size="+toString(m_segmentSize)+
+      ", path=["+m_path+"]");
+
+  unmapWindow();
+
+  scShmOffset pageSize = scSharedMemRegion::get_page_size();
+  scShmOffset start = pos - (pos % pageSize);
+  size_t length = static_cast<size_t>(SC_MIN(static_cast<scShmOffset>(m_windowSize), m_segmentSize - start));
+
+  scSharedMemRegion *region = new scSharedMemRegion(
+    *((scSharedMemObject *)m_objectHandle),
+    (m_accessMode == scsmReadOnly)?read_only:read_write,
+    static_cast<offset_t>(start), length);
+
+  m_regionHandle = region;
+  m_windowAddress = static_cast<char *>(region->get_address());
+  m_windowOffset = start;
+  m_windowLength = length;
+  ++m_mapCount;
+
+  if (m_sequential) {
+    region->advise(scSharedMemRegion::advice_sequential);
+    region->advise(scSharedMemRegion::advice_willneed);
+  }
+}
+
+void *scSharedMemoryWindow::map(scShmOffset offset, size_t length)
+{
+  if ((offset + length > m_segmentSize) || (length > m_windowSize - (offset % scSharedMemRegion::get_page_size())))
+    throw scError(scString("Shared window range incorrect")+
+      ", offset="+toString(offset)+
+      ", length="+toString(length)+
+      ", window="+toString(m_windowSize)+
+      ", path=["+m_path+"]");
+
+  if ((m_windowAddress == SC_NULL) || (offset < m_windowOffset) ||
+      (offset + length > m_windowOffset + m_windowLength))
+    mapWindow(offset);
+
+  return m_windowAddress + static_cast<size_t>(offset - m_windowOffset);
+}
+
+size_t scSharedMemoryWindow::calcAvailable()
+{
+  if (m_pos >= m_segmentSize)
+    return 0;
+
+  if ((m_windowAddress == SC_NULL) || (m_pos < m_windowOffset) ||
+      (m_pos >= m_windowOffset + m_windowLength))
+    mapWindow(m_pos);
+
+  return static_cast<size_t>(m_windowOffset + m_windowLength - m_pos);
+}
+
+void scSharedMemoryWindow::seek(scShmOffset pos)
+{
+  m_pos = SC_MIN(pos, m_segmentSize);
+}
+
+scShmOffset scSharedMemoryWindow::tell() const
+{
+  return m_pos;
+}
+
+bool scSharedMemoryWindow::eof() const
+{
+  return (m_pos >= m_segmentSize);
+}
+
+size_t scSharedMemoryWindow::read(void *output, size_t size)
+{
+  char *optr = static_cast<char *>(output);
+  size_t res = 0;
+  size_t avail;
+
+  while ((res < size) && ((avail = calcAvailable()) > 0))
+  {
+    size_t chunk = SC_MIN(avail, size - res);
+    std::memcpy(optr + res, m_windowAddress + static_cast<size_t>(m_pos - m_windowOffset), chunk);
+    m_pos += chunk;
+    res += chunk;
+  }
+
+  return res;
+}
+
+size_t scSharedMemoryWindow::write(const void *input, size_t size)
+{
+  if (m_accessMode == scsmReadOnly)
+    throw scError("Shared window opened as read-only: ["+m_path+"]");
+
+  const char *iptr = static_cast<const char *>(input);
+  size_t res = 0;
+  size_t avail;
+
+  while ((res < size) && ((avail = calcAvailable()) > 0))
+  {
+    size_t chunk = SC_MIN(avail, size - res);
+    std::memcpy(m_windowAddress + static_cast<size_t>(m_pos - m_windowOffset), iptr + res, chunk);
+    m_pos += chunk;
+    res += chunk;
+  }
+
+  return res;
+}
+
+size_t scSharedMemoryWindow::read(scShmWinConsumerIntf *consumer, size_t size)
+{
+  size_t res = 0;
+  size_t avail;
+
+  while ((res < size) && ((avail = calcAvailable()) > 0))
+  {
+    size_t chunk = SC_MIN(avail, size - res);
+    consumer->process(m_windowAddress + static_cast<size_t>(m_pos - m_windowOffset), chunk);
+    m_pos += chunk;
+    res += chunk;
+  }
+
+  return res;
+}
+
+size_t scSharedMemoryWindow::write(scShmWinWriterIntf *writer, size_t size)
+{
+  if (m_accessMode == scsmReadOnly)
+    throw scError("Shared window opened as read-only: ["+m_path+"]");
+
+  size_t res = 0;
+  size_t avail;
+
+  while ((res < size) && ((avail = calcAvailable()) > 0))
+  {
+    size_t chunk = SC_MIN(avail, size - res);
+    size_t written = writer->write(m_windowAddress + static_cast<size_t>(m_pos - m_windowOffset), chunk);
+    m_pos += written;
+    res += written;
+    if (written < chunk)
+      break;
+  }
+
+  return res;
+}
+
+void scSharedMemoryWindow::setSequential(bool value)
+{
+  m_sequential = value;
+}
+
+scShmOffset scSharedMemoryWindow::getSegmentSize() const
+{
+  return m_segmentSize;
+}
+
+size_t scSharedMemoryWindow::getWindowSize() const
+{
+  return m_windowSize;
+}
+
+scShmOffset scSharedMemoryWindow::getWindowOffset() const
+{
+  return m_windowOffset;
+}
+
+size_t scSharedMemoryWindow::getWindowLength() const
+{
+  return m_windowLength;
+}
+
+uint scSharedMemoryWindow::getMapCount() const
+{
+  return m_mapCount;
+}
@@ -0,0 +1,308 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        SharedRateLimiter.cpp
+// Project:     scLib
+// Purpose:     Token bucket rate limiter shared by processes
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#include "sc/proc/SharedRateLimiter.h"
+
+#include <cstring>
+#include <new>
+
+#include <boost/interprocess/detail/atomic.hpp>
+#include <boost/interprocess/sync/interprocess_mutex.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "sc/utils.h"
+
+using namespace boost::interprocess::ipcdetail;
+
+typedef boost::interprocess::scoped_lock<boost::interprocess::interprocess_mutex> scShmRateLock;
+
+// ----------------------------------------------------------------------------
+// shared layout
+// ----------------------------------------------------------------------------
+const boost::uint32_t SC_SHM_RATE_MAGIC = 0x5C7A7E01;
+const size_t SC_SHM_RATE_ALIGN = 64;
+
+struct scShmRateHeader {
+  boost::interprocess::interprocess_mutex mutex;  // guards adding of buckets
+  boost::uint32_t magic;
+  boost::uint32_t maxBuckets;
+  volatile boost::uint32_t count;
+};
+
+// one bucket per cache line
+struct scShmRateBucket {
+  volatile boost::uint64_t arrivalTime;  // theoretical arrival time, ns
+  boost::uint64_t interval;              // ns per token
+  boost::uint64_t limit;                 // burst * interval
+  boost::uint32_t burst;
+  boost::uint32_t parent;
+  char name[SC_SHM_BUCKET_NAME_LEN];
+};
+
+inline void shm_rate_fence()
+{
+#ifdef WIN32
+  MemoryBarrier();
+#else
+  __sync_synchronize();
+#endif
+}
+
+inline boost::uint64_t shm_rate_cas64(volatile boost::uint64_t *mem, boost::uint64_t with, boost::uint64_t cmp)
+{
+#ifdef WIN32
+  return static_cast<boost::uint64_t>(InterlockedCompareExchange64(
+    reinterpret_cast<volatile LONGLONG *>(mem), static_cast<LONGLONG>(with), static_cast<LONGLONG>(cmp)));
+#else
+  return __sync_val_compare_and_swap(mem, cmp, with);
+#endif
+}
+
+inline boost::uint64_t shm_rate_read64(volatile boost::uint64_t *mem)
+{
+#if defined(_WIN64) || defined(__x86_64__) || defined(__aarch64__)
+  return *mem;
+#else
+  return shm_rate_cas64(mem, 0, 0);
+#endif
+}
+
+inline size_t shm_rate_header_size()
+{
+  return ((sizeof(scShmRateHeader) + SC_SHM_RATE_ALIGN - 1) / SC_SHM_RATE_ALIGN) * SC_SHM_RATE_ALIGN;
+}
+
+inline size_t shm_rate_bucket_stride()
+{
+  return ((sizeof(scShmRateBucket) + SC_SHM_RATE_ALIGN - 1) / SC_SHM_RATE_ALIGN) * SC_SHM_RATE_ALIGN;
+}
+
+// ----------------------------------------------------------------------------
+// scShmRateLimiter
+// ----------------------------------------------------------------------------
+scShmRateLimiter::scShmRateLimiter(const scString &a_path, uint a_useFlags, uint maxBuckets):
+  m_header(SC_NULL), m_buckets(SC_NULL)
+{
+  if (maxBuckets == 0)
+    throw scError("Incorrect number of buckets: ["+a_path+"]");
+
+  size_t totalSize = shm_rate_header_size() + maxBuckets * shm_rate_bucket_stride();
+  m_memory.reset(new scSharedMemory(a_path, scsmReadWrite, a_useFlags, totalSize));
+
+  char *base = static_cast<char *>(m_memory->getAddress());
+  m_header = new (base) scShmRateHeader();
+  m_buckets = reinterpret_cast<scShmRateBucket *>(base + shm_rate_header_size());
+  m_header->maxBuckets = maxBuckets;
+  m_header->count = 0;
+
+  shm_rate_fence();
+  atomic_write32(&m_header->magic, SC_SHM_RATE_MAGIC);
+}
+
+scShmRateLimiter::scShmRateLimiter(const scString &a_path): m_header(SC_NULL), m_buckets(SC_NULL)
+{
+  m_memory.reset(new scSharedMemory(a_path, scsmReadWrite, 0, 0));
+  attach();
+}
+
+scShmRateLimiter::~scShmRateLimiter()
+{
+}
+
+void scShmRateLimiter::attach()
+{
+  char *base = static_cast<char *>(m_memory->getAddress());
+  m_header = reinterpret_cast<scShmRateHeader *>(base);
+  m_buckets = reinterpret_cast<scShmRateBucket *>(base + shm_rate_header_size());
+  if (atomic_read32(&m_header->magic) != SC_SHM_RATE_MAGIC)
+    throw scError("Shared rate limiter not initialized");
+}
+
+scShmRateBucket *scShmRateLimiter::getBucket(scShmBucketId bucket) const
+{
+  if (bucket >= atomic_read32(&m_header->count))
+    throw scError(scString("Unknown rate bucket: ")+toString(bucket));
+  return reinterpret_cast<scShmRateBucket *>(reinterpret_cast<char *>(m_buckets) + bucket * shm_rate_bucket_stride());
+}
+
+scShmBucketId scShmRateLimiter::addBucket(const scString &name, double rate, uint burst, const scString &parentName)
+{
+  if (name.empty() || (name.length() >= SC_SHM_BUCKET_NAME_LEN))
+    throw scError("Incorrect bucket name: ["+name+"]");
+  if ((rate <= 0.0) || (burst == 0))
+    throw scError("Incorrect bucket limits: ["+name+"]");
+
+  scShmRateLock lock(m_header->mutex);
+
+  scShmBucketId res = findBucket(name);
+  if (res != SC_SHM_NULL_BUCKET)
+    return res;
+
+  scShmBucketId parent = SC_SHM_NULL_BUCKET;
+  if (!parentName.empty()) {
+    // parent must exist before child, so there are no cycles
+    parent = findBucket(parentName);
+    if (parent == SC_SHM_NULL_BUCKET)
+      throw scError("Unknown parent bucket: ["+parentName+"]");
+  }
+
+  res = m_header->count;
+  if (res >= m_header->maxBuckets)
+    throw scError("Too many rate buckets: ["+name+"]");
+
+  scShmRateBucket *bucket = reinterpret_cast<scShmRateBucket *>(reinterpret_cast<char *>(m_buckets) + res * shm_rate_bucket_stride());
+  std::strcpy(bucket->name, name.c_str());
+  bucket->parent = parent;
+  bucket->burst = burst;
+  bucket->interval = SC_MAX(static_cast<boost::uint64_t>(1000000000.0 / rate), static_cast<boost::uint64_t>(1));
+  bucket->limit = bucket->interval * burst;
+  // bucket starts full
+  bucket->arrivalTime = 0;
+
+  shm_rate_fence();
+  atomic_write32(&m_header->count, res + 1);
+  return res;
+}
+
+scShmBucketId scShmRateLimiter::findBucket(const scString &name) const
+{
+  uint count = atomic_read32(&m_header->count);
+  for(uint i = 0; i < count; i++)
+    if (name == getBucket(i)->name)
+      return i;
+  return SC_SHM_NULL_BUCKET;
+}
+
+bool scShmRateLimiter::acquireOne(scShmRateBucket *bucket, boost::uint64_t cost, boost::uint64_t now)
+{
+  for(;;) {
+    boost::uint64_t arrivalTime = shm_rate_read64(&bucket->arrivalTime);
+    boost::uint64_t newTime = SC_MAX(arrivalTime, now) + cost;
+    if (newTime - now > bucket->limit)
+      return false;
+    if (shm_rate_cas64(&bucket->arrivalTime, newTime, arrivalTime) == arrivalTime)
+      return true;
+  }
+}
+
+void scShmRateLimiter::releaseOne(scShmRateBucket *bucket, boost::uint64_t cost)
+{
+  for(;;) {
+    boost::uint64_t arrivalTime = shm_rate_read64(&bucket->arrivalTime);
+    boost::uint64_t newTime = (arrivalTime > cost)?arrivalTime - cost:0;
+    if (shm_rate_cas64(&bucket->arrivalTime, newTime, arrivalTime) == arrivalTime)
+      return;
+  }
+}
+
+bool scShmRateLimiter::acquire(scShmBucketId bucketId, uint n)
+{
+  boost::uint64_t now = getClock();
+  scShmRateBucket *bucket = getBucket(bucketId);
+
+  if (!acquireOne(bucket, bucket->interval * n, now))
+    return false;
+
+  if (bucket->parent == SC_SHM_NULL_BUCKET)
+    return true;
+
+  // take from parents, give back on failure
+  scShmRateBucket *failed = SC_NULL;
+  for(scShmRateBucket *parent = getBucket(bucket->parent); ; parent = getBucket(parent->parent))
+  {
+    if (!acquireOne(parent, parent->interval * n, now)) {
+      failed = parent;
+      break;
+    }
+    if (parent->parent == SC_SHM_NULL_BUCKET)
+      break;
+  }
+
+  if (failed == SC_NULL)
+    return true;
+
+  for(scShmRateBucket *item = bucket; item != failed; item = getBucket(item->parent))
+    releaseOne(item, item->interval * n);
+  return false;
+}
+
+bool scShmRateLimiter::acquire(const scString &name, uint n)
+{
+  scShmBucketId bucket = findBucket(name);
+  if (bucket == SC_SHM_NULL_BUCKET)
+    throw scError("Unknown rate bucket: ["+name+"]");
+  return acquire(bucket, n);
+}
+
+void scShmRateLimiter::release(scShmBucketId bucketId, uint n)
+{
+  for(scShmRateBucket *bucket = getBucket(bucketId); ; bucket = getBucket(bucket->parent))
+  {
+    releaseOne(bucket, bucket->interval * n);
+    if (bucket->parent == SC_SHM_NULL_BUCKET)
+      break;
+  }
+}
+
+uint scShmRateLimiter::getAvailable(scShmBucketId bucketId) const
+{
+  scShmRateBucket *bucket = getBucket(bucketId);
+  boost::uint64_t now = getClock();
+  boost::uint64_t arrivalTime = shm_rate_read64(&bucket->arrivalTime);
+  if (arrivalTime <= now)
+    return bucket->burst;
+  boost::uint64_t used = arrivalTime - now;
+  if (used >= bucket->limit)
+    return 0;
+  return static_cast<uint>((bucket->limit - used) / bucket->interval);
+}
+
+boost::uint64_t scShmRateLimiter::getWaitTime(scShmBucketId bucketId, uint n) const
+{
+  boost::uint64_t now = getClock();
+  boost::uint64_t res = 0;
+
+  for(scShmRateBucket *bucket = getBucket(bucketId); ; bucket = getBucket(bucket->parent))
+  {
+    boost::uint64_t newTime = SC_MAX(shm_rate_read64(&bucket->arrivalTime), now) + bucket->interval * n;
+    if (newTime - now > bucket->limit)
+      res = SC_MAX(res, newTime - now - bucket->limit);
+    if (bucket->parent == SC_SHM_NULL_BUCKET)
+      break;
+  }
+
+  return res / 1000;
+}
+
+uint scShmRateLimiter::getBucketCount() const
+{
+  return atomic_read32(&m_header->count);
+}
+
+boost::uint64_t scShmRateLimiter::getClock()
+{
+#ifdef WIN32
+  LARGE_INTEGER counter, freq;
+  QueryPerformanceCounter(&counter);
+  QueryPerformanceFrequency(&freq);
+  boost::uint64_t c = counter.QuadPart, f = freq.QuadPart;
+  return (c / f) * 1000000000ULL + ((c % f) * 1000000000ULL) / f;
+#else
+  // CLOCK_MONOTONIC is shared by all processes of the system
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<boost::uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+#endif
+}
@@ -8,6 +8,7 @@
 /////////////////////////////////////////////////////////////////////////////
 
 #include "sc/proc/SharedResource.h"
+#include "sc/proc/SharedMemoryTrace.h"
 #include "sc/dtypes.h"
 #include "sc/utils.h"
 #include "perf/Timer.h"
@@ -23,6 +24,7 @@ using namespace perf;
 // scSharedResourceManager
 // ----------------------------------------------------------------------------
 scSharedResourceManager* scSharedResourceManager::m_activeManager = SC_NULL;
+uint scSharedResourceManager::m_generation = 0;
 
 scSharedResourceManager::scSharedResourceManager()
 {
@@ -51,6 +53,7 @@ Timer::start("io-shm-res-man-destroy");
 #endif  
   if (m_activeManager == this)
     m_activeManager = SC_NULL;
+  ++m_generation;
 #ifdef TRACE_IO_TIME  
 Timer::stop("io-shm-res-man-destroy");
 #endif  
@@ -86,6 +89,11 @@ scSharedResource *scSharedResourceManager::find(const scString &keyName)
   return checkManager()->intFind(keyName);
 }
 
+uint scSharedResourceManager::getGeneration()
+{
+  return m_generation;
+}
+
 scSharedResourceManager *scSharedResourceManager::checkManager()
 {
   if (m_activeManager == SC_NULL)
@@ -99,6 +107,7 @@ void scSharedResourceManager::intAdd(scSharedResource *a_resource, const scStrin
   scString useName = keyName;
   if (useName.length() == 0)
     useName = a_resource->getKeyName();
+  scShmTraceScope trace(shtoRegister, useName, 0, 0, 0);
     
   m_resourceList.insert(useName, new scSharedResourceTransporter(a_resource));
   intAddRef(useName);
@@ -118,6 +127,7 @@ void scSharedResourceManager::intReleaseRef(const scString &keyName)
 #ifdef SC_SHRES_TRACK     
       scLog::addInfo("Releasing reference to: "+keyName);                           
 #endif      
+  scShmTraceScope trace(shtoRelease, keyName, 0, 0, 0);
   scResourceMMapColn::iterator fi, pback;
   scResourceMapColn::iterator resi;
   
@@ -127,8 +137,10 @@ void scSharedResourceManager::intReleaseRef(const scString &keyName)
     if (fi == m_handleList.upper_bound(keyName))
     { // last one - free resource    
       resi = m_resourceList.find(keyName);
-      if (resi != m_resourceList.end())
+      if (resi != m_resourceList.end()) {
         m_resourceList.erase(resi);
+        ++m_generation;
+      }
 #ifdef SC_SHRES_TRACK     
       scLog::addInfo("Resource released");                           
 #endif      
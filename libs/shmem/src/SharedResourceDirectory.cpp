@@ -0,0 +1,468 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        SharedResourceDirectory.cpp
+// Project:     scLib
+// Purpose:     System-wide directory of shared memory segments
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#ifdef WIN32
+#define SCSHM_WINDOWS
+#endif
+
+#include "sc/proc/SharedResourceDirectory.h"
+
+#include <cstring>
+
+#include <boost/interprocess/sync/interprocess_mutex.hpp>
+#include <boost/interprocess/detail/os_thread_functions.hpp>
+
+#ifdef SCSHM_WINDOWS
+#include <windows.h>
+#include <boost/interprocess/managed_windows_shared_memory.hpp>
+#else
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#endif
+
+#include "sc/utils.h"
+
+#ifdef SCSHM_WINDOWS
+typedef boost::interprocess::managed_windows_shared_memory scShmDirSegment;
+#else
+typedef boost::interprocess::managed_shared_memory scShmDirSegment;
+#endif
+
+/// table is rebuilt when deleted slots exceed 1/SC_SHM_DIR_REHASH_DIV of capacity
+const boost::uint32_t SC_SHM_DIR_REHASH_DIV = 4;
+
+// ----------------------------------------------------------------------------
+// shared layout
+// ----------------------------------------------------------------------------
+enum scShmDirEntryState {
+  sdesEmpty = 0,
+  sdesUsed = 1,
+  sdesDeleted = 2
+};
+
+#ifdef SCSHM_WINDOWS
+// Win32: boost::interprocess has no robust mutex, dead owner is not detected
+class scShmDirMutex {
+public:
+  scShmDirMutex() {}
+  /// \return Returns false if previous owner died while holding mutex
+  bool lock() { m_mutex.lock(); return true; }
+  void unlock() { m_mutex.unlock(); }
+private:
+  boost::interprocess::interprocess_mutex m_mutex;
+};
+#else
+// robust mutex - process which dies holding it does not block others
+class scShmDirMutex {
+public:
+  scShmDirMutex() {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&m_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+  }
+  /// \return Returns false if previous owner died while holding mutex
+  bool lock() {
+    int res = pthread_mutex_lock(&m_mutex);
+    if (res == EOWNERDEAD) {
+      pthread_mutex_consistent(&m_mutex);
+      return false;
+    }
+    if (res != 0)
+      throw scError(scString("Shared directory lock failed: ")+toString(res));
+    return true;
+  }
+  void unlock() { pthread_mutex_unlock(&m_mutex); }
+private:
+  pthread_mutex_t m_mutex;
+};
+#endif
+
+struct scShmDirHeader {
+  scShmDirHeader(boost::uint32_t a_capacity): capacity(a_capacity), count(0), deletedCount(0), version(0) {}
+  scShmDirMutex mutex;
+  boost::uint32_t capacity;
+  boost::uint32_t count;
+  boost::uint32_t deletedCount;
+  boost::uint32_t version;
+};
+
+struct scShmDirEntry {
+  scShmDirEntry(): state(sdesEmpty) {}
+  char name[SC_SHM_DIR_NAME_LEN];
+  boost::uint64_t size;
+  boost::uint32_t state;
+  boost::uint32_t hash;
+  boost::uint32_t ownerPid;
+  boost::uint32_t refCount;
+  boost::uint32_t version;
+  boost::uint32_t attachCount;  // number of used slots in attached
+  boost::uint32_t attached[SC_SHM_DIR_MAX_ATTACH];
+};
+
+static boost::uint32_t shm_dir_current_pid()
+{
+  return static_cast<boost::uint32_t>(boost::interprocess::ipcdetail::get_current_process_id());
+}
+
+static bool shm_dir_process_exists(boost::uint32_t pid)
+{
+#ifdef SCSHM_WINDOWS
+  HANDLE handle = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+  if (handle == NULL)
+    return (GetLastError() == ERROR_ACCESS_DENIED);
+  DWORD exitCode = 0;
+  bool res = (GetExitCodeProcess(handle, &exitCode) != 0) && (exitCode == STILL_ACTIVE);
+  CloseHandle(handle);
+  return res;
+#else
+  return (kill(static_cast<pid_t>(pid), 0) == 0) || (errno != ESRCH);
+#endif
+}
+
+class scShmDirLock {
+public:
+  scShmDirLock(scSharedResourceDirectory *directory, scShmDirMutex &mutex): m_mutex(mutex) {
+    if (!m_mutex.lock()) {
+      try {
+        directory->intRecover();
+      } catch(...) {
+        m_mutex.unlock();
+        throw;
+      }
+    }
+  }
+  ~scShmDirLock() { m_mutex.unlock(); }
+private:
+  scShmDirMutex &m_mutex;
+};
+
+// ----------------------------------------------------------------------------
+// scSharedResourceDirectory
+// ----------------------------------------------------------------------------
+scSharedResourceDirectory::scSharedResourceDirectory(const scString &dirName, uint capacity):
+  m_segmentHandle(SC_NULL), m_header(SC_NULL), m_entries(SC_NULL), m_dirName(dirName)
+{
+  using namespace boost::interprocess;
+
+  if (capacity == 0)
+    throw scError("Shared directory capacity must be greater than zero");
+
+  // room for allocator & named object index
+  size_t segmentSize = sizeof(scShmDirHeader) + capacity * sizeof(scShmDirEntry) + 64 * 1024;
+
+  std::auto_ptr<scShmDirSegment> segmentGuard(
+    new scShmDirSegment(open_or_create, stringToCharPtr(dirName), segmentSize));
+
+  // construction of named objects is atomic between processes
+  m_header = segmentGuard->find_or_construct<scShmDirHeader>("header")(capacity);
+  m_entries = segmentGuard->find_or_construct<scShmDirEntry>("entries")[m_header->capacity]();
+  m_segmentHandle = segmentGuard.release();
+}
+
+scSharedResourceDirectory::~scSharedResourceDirectory()
+{
+  delete static_cast<scShmDirSegment *>(m_segmentHandle);
+}
+
+void scSharedResourceDirectory::remove(const scString &dirName)
+{
+#ifndef SCSHM_WINDOWS
+  boost::interprocess::shared_memory_object::remove(stringToCharPtr(dirName));
+#endif
+}
+
+uint scSharedResourceDirectory::calcHash(const char *name)
+{
+  // FNV-1a
+  boost::uint32_t res = 2166136261U;
+  while (*name != '\0') {
+    res ^= static_cast<unsigned char>(*name++);
+    res *= 16777619U;
+  }
+  return res;
+}
+
+void scSharedResourceDirectory::checkName(const scString &name)
+{
+  if ((name.length() == 0) || (name.length() >= SC_SHM_DIR_NAME_LEN))
+    throw scError("Incorrect shared directory entry name: ["+name+"]");
+}
+
+scShmDirEntry *scSharedResourceDirectory::intFind(const char *name)
+{
+  boost::uint32_t capacity = m_header->capacity;
+  boost::uint32_t hash = calcHash(name);
+
+  for(boost::uint32_t i = 0; i < capacity; i++)
+  {
+    scShmDirEntry *entry = m_entries + ((hash + i) % capacity);
+    if (entry->state == sdesEmpty)
+      break;
+    if ((entry->state == sdesUsed) && (entry->hash == hash) && (std::strcmp(entry->name, name) == 0))
+      return entry;
+  }
+
+  return SC_NULL;
+}
+
+scShmDirEntry *scSharedResourceDirectory::intInsert(const char *name)
+{
+  boost::uint32_t capacity = m_header->capacity;
+  boost::uint32_t hash = calcHash(name);
+
+  if (m_header->count >= capacity)
+    // references of crashed processes can hold slots
+    intPrune();
+
+  if (m_header->count >= capacity)
+    throw scError(scString("Shared directory is full, capacity: ")+toString(capacity));
+
+  // first empty or deleted slot, name is known to be absent
+  scShmDirEntry *entry = SC_NULL;
+  for(boost::uint32_t i = 0; i < capacity; i++)
+  {
+    entry = m_entries + ((hash + i) % capacity);
+    if (entry->state != sdesUsed)
+      break;
+  }
+
+  if (entry->state == sdesDeleted)
+    --m_header->deletedCount;
+
+  std::strncpy(entry->name, name, SC_SHM_DIR_NAME_LEN - 1);
+  entry->name[SC_SHM_DIR_NAME_LEN - 1] = '\0';
+  entry->hash = hash;
+  entry->state = sdesUsed;
+  ++m_header->count;
+  return entry;
+}
+
+void scSharedResourceDirectory::intRemove(scShmDirEntry *entry)
+{
+  entry->state = sdesDeleted;
+  entry->name[0] = '\0';
+  --m_header->count;
+  ++m_header->deletedCount;
+
+  // deleted slots do not end probing, too many make lookups linear
+  if (m_header->deletedCount > m_header->capacity / SC_SHM_DIR_REHASH_DIV)
+    intRehash();
+}
+
+void scSharedResourceDirectory::intRehash()
+{
+  boost::uint32_t capacity = m_header->capacity;
+  std::vector<scShmDirEntry> used;
+  used.reserve(m_header->count);
+
+  for(boost::uint32_t i = 0; i < capacity; i++)
+  {
+    if (m_entries[i].state == sdesUsed)
+      used.push_back(m_entries[i]);
+    m_entries[i].state = sdesEmpty;
+    m_entries[i].name[0] = '\0';
+  }
+
+  for(std::vector<scShmDirEntry>::const_iterator it = used.begin(), epos = used.end(); it != epos; ++it)
+  {
+    for(boost::uint32_t i = 0; i < capacity; i++)
+    {
+      scShmDirEntry *entry = m_entries + ((it->hash + i) % capacity);
+      if (entry->state == sdesEmpty) {
+        *entry = *it;
+        break;
+      }
+    }
+  }
+
+  m_header->count = used.size();
+  m_header->deletedCount = 0;
+}
+
+uint scSharedResourceDirectory::intPrune()
+{
+  boost::uint32_t capacity = m_header->capacity;
+  uint res = 0;
+
+  for(boost::uint32_t i = 0; i < capacity; i++)
+  {
+    scShmDirEntry *entry = m_entries + i;
+    if (entry->state != sdesUsed)
+      continue;
+
+    boost::uint32_t j = 0;
+    while (j < entry->attachCount)
+    {
+      if (shm_dir_process_exists(entry->attached[j])) {
+        j++;
+        continue;
+      }
+
+      entry->attached[j] = entry->attached[--entry->attachCount];
+      if (entry->refCount > 0)
+        --entry->refCount;
+      ++entry->version;
+      ++m_header->version;
+      res++;
+    }
+
+    if (entry->refCount == 0) {
+      scString name(entry->name);
+      intRemove(entry);
+      destroySegment(name);
+      // rehash could move entries, start again
+      i = static_cast<boost::uint32_t>(-1);
+    }
+  }
+
+  return res;
+}
+
+void scSharedResourceDirectory::intRecover()
+{
+  // previous lock owner could stop in the middle of update - recount slots
+  boost::uint32_t count = 0;
+  for(boost::uint32_t i = 0; i < m_header->capacity; i++)
+    if (m_entries[i].state == sdesUsed)
+      count++;
+  m_header->count = count;
+
+  intRehash();
+  intPrune();
+}
+
+uint scSharedResourceDirectory::pruneDeadProcesses()
+{
+  scShmDirLock lock(this, m_header->mutex);
+  return intPrune();
+}
+
+bool scSharedResourceDirectory::add(const scString &name, boost::uint64_t size)
+{
+  checkName(name);
+  scShmDirLock lock(this, m_header->mutex);
+
+  if (intFind(name.c_str()) != SC_NULL)
+    return false;
+
+  scShmDirEntry *entry = intInsert(name.c_str());
+  boost::uint32_t pid = shm_dir_current_pid();
+  entry->size = size;
+  entry->ownerPid = pid;
+  entry->refCount = 1;
+  entry->version = 1;
+  entry->attachCount = 1;
+  entry->attached[0] = pid;
+  ++m_header->version;
+  return true;
+}
+
+bool scSharedResourceDirectory::attach(const scString &name)
+{
+  checkName(name);
+  scShmDirLock lock(this, m_header->mutex);
+
+  scShmDirEntry *entry = intFind(name.c_str());
+  if (entry == SC_NULL)
+    return false;
+
+  ++entry->refCount;
+  ++entry->version;
+  // processes above slot limit are counted, but not listed
+  if (entry->attachCount < SC_SHM_DIR_MAX_ATTACH)
+    entry->attached[entry->attachCount++] = shm_dir_current_pid();
+  ++m_header->version;
+  return true;
+}
+
+bool scSharedResourceDirectory::detach(const scString &name)
+{
+  checkName(name);
+  bool destroy = false;
+
+  {
+    scShmDirLock lock(this, m_header->mutex);
+
+    scShmDirEntry *entry = intFind(name.c_str());
+    if (entry == SC_NULL)
+      return false;
+
+    boost::uint32_t pid = shm_dir_current_pid();
+    for(boost::uint32_t i = 0; i < entry->attachCount; i++)
+      if (entry->attached[i] == pid) {
+        entry->attached[i] = entry->attached[--entry->attachCount];
+        break;
+      }
+
+    ++entry->version;
+    if (--entry->refCount == 0) {
+      intRemove(entry);
+      destroy = true;
+    }
+    ++m_header->version;
+  }
+
+  if (destroy)
+    destroySegment(name);
+
+  return destroy;
+}
+
+void scSharedResourceDirectory::destroySegment(const scString &name)
+{
+#ifndef SCSHM_WINDOWS
+  boost::interprocess::shared_memory_object::remove(stringToCharPtr(name));
+#endif
+  // Win32: segment is released by system with the last handle
+}
+
+bool scSharedResourceDirectory::find(const scString &name, scShmDirEntryInfo &output)
+{
+  checkName(name);
+  scShmDirLock lock(this, m_header->mutex);
+
+  scShmDirEntry *entry = intFind(name.c_str());
+  if (entry == SC_NULL)
+    return false;
+
+  output.name = entry->name;
+  output.size = entry->size;
+  output.ownerPid = entry->ownerPid;
+  output.refCount = entry->refCount;
+  output.version = entry->version;
+  output.attached.assign(entry->attached, entry->attached + entry->attachCount);
+  return true;
+}
+
+bool scSharedResourceDirectory::exists(const scString &name)
+{
+  checkName(name);
+  scShmDirLock lock(this, m_header->mutex);
+  return (intFind(name.c_str()) != SC_NULL);
+}
+
+uint scSharedResourceDirectory::getRefCount(const scString &name)
+{
+  checkName(name);
+  scShmDirLock lock(this, m_header->mutex);
+  scShmDirEntry *entry = intFind(name.c_str());
+  return (entry != SC_NULL)?entry->refCount:0;
+}
+
+uint scSharedResourceDirectory::getVersion()
+{
+  scShmDirLock lock(this, m_header->mutex);
+  return m_header->version;
+}
@@ -0,0 +1,532 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        SharedTaskPool.cpp
+// Project:     scLib
+// Purpose:     Work-stealing task pool shared by worker processes
+// Author:      Piotr Likus
+// Modified by:
+// Created:     19/10/2026
+/////////////////////////////////////////////////////////////////////////////
+
+#include "sc/proc/SharedTaskPool.h"
+
+#include <cstring>
+
+#include <boost/interprocess/detail/atomic.hpp>
+#include <boost/interprocess/detail/os_thread_functions.hpp>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#define SCSHM_POOL_FUTEX
+#endif
+#endif
+
+#include "sc/utils.h"
+
+using namespace boost::interprocess::ipcdetail;
+
+// ----------------------------------------------------------------------------
+// shared layout
+// ----------------------------------------------------------------------------
+const boost::uint32_t SC_SHM_POOL_MAGIC = 0x5C7A5B01;
+const size_t SC_SHM_POOL_ALIGN = 64;
+
+struct scShmTaskPoolHeader {
+  boost::uint32_t magic;
+  boost::uint32_t workerCount;
+  boost::uint32_t capacity;        // power of 2
+  boost::uint32_t payloadSize;
+  boost::uint32_t slotCount;
+  boost::uint32_t slotStride;
+  boost::uint32_t workerStride;
+  boost::uint32_t workersOffset;
+  boost::uint64_t slotsOffset;
+  char pad0[SC_SHM_POOL_ALIGN];
+  volatile boost::uint64_t freeHead; // ABA tag << 32 | (slotNo + 1), 0 = empty
+  char pad1[SC_SHM_POOL_ALIGN - sizeof(boost::uint64_t)];
+  volatile boost::uint32_t sleepers;
+  volatile boost::uint32_t wakeSeq;
+  volatile boost::uint32_t nextWorker;
+};
+
+// hot counters are kept on separate cache lines
+struct scShmTaskWorkerArea {
+  volatile boost::uint32_t top;
+  char pad0[SC_SHM_POOL_ALIGN - sizeof(boost::uint32_t)];
+  volatile boost::uint32_t bottom;
+  char pad1[SC_SHM_POOL_ALIGN - sizeof(boost::uint32_t)];
+  volatile boost::uint32_t enqueuePos;
+  char pad2[SC_SHM_POOL_ALIGN - sizeof(boost::uint32_t)];
+  volatile boost::uint32_t dequeuePos;
+  char pad3[SC_SHM_POOL_ALIGN - sizeof(boost::uint32_t)];
+  volatile boost::uint32_t executed;
+  volatile boost::uint32_t stolen;
+  char pad4[SC_SHM_POOL_ALIGN - 2 * sizeof(boost::uint32_t)];
+};
+
+struct scShmTaskSlot {
+  boost::uint32_t next;  // free list link, slotNo + 1
+  boost::uint32_t size;
+};
+
+inline size_t shm_pool_align(size_t value, size_t align)
+{
+  return ((value + align - 1) / align) * align;
+}
+
+inline void shm_pool_fence()
+{
+#ifdef WIN32
+  MemoryBarrier();
+#else
+  __sync_synchronize();
+#endif
+}
+
+inline boost::uint64_t shm_pool_cas64(volatile boost::uint64_t *mem, boost::uint64_t with, boost::uint64_t cmp)
+{
+#ifdef WIN32
+  return static_cast<boost::uint64_t>(InterlockedCompareExchange64(
+    reinterpret_cast<volatile LONGLONG *>(mem), static_cast<LONGLONG>(with), static_cast<LONGLONG>(cmp)));
+#else
+  return __sync_val_compare_and_swap(mem, cmp, with);
+#endif
+}
+
+inline boost::uint64_t shm_pool_read64(volatile boost::uint64_t *mem)
+{
+  // atomic also on 32-bit platforms
+  return shm_pool_cas64(mem, 0, 0);
+}
+
+// ----------------------------------------------------------------------------
+// scShmTaskPool
+// ----------------------------------------------------------------------------
+scShmTaskPool::scShmTaskPool(const scString &a_path, uint a_useFlags, uint workerCount, uint queueCapacity,
+    size_t payloadSize, uint payloadCount): m_header(SC_NULL), m_base(SC_NULL)
+{
+  if ((workerCount == 0) || (queueCapacity == 0) || (payloadCount == 0))
+    throw scError("Incorrect task pool parameters: ["+a_path+"]");
+
+  boost::uint32_t capacity = 1;
+  while (capacity < queueCapacity)
+    capacity <<= 1;
+
+  size_t workerStride = shm_pool_align(sizeof(scShmTaskWorkerArea) + 3 * capacity * sizeof(boost::uint32_t), SC_SHM_POOL_ALIGN);
+  size_t slotStride = shm_pool_align(sizeof(scShmTaskSlot) + payloadSize, sizeof(boost::uint64_t));
+  size_t workersOffset = shm_pool_align(sizeof(scShmTaskPoolHeader), SC_SHM_POOL_ALIGN);
+  size_t slotsOffset = workersOffset + workerCount * workerStride;
+  size_t totalSize = slotsOffset + payloadCount * slotStride;
+
+  m_memory.reset(new scSharedMemory(a_path, scsmReadWrite, a_useFlags, totalSize));
+  m_base = static_cast<char *>(m_memory->getAddress());
+  m_header = reinterpret_cast<scShmTaskPoolHeader *>(m_base);
+
+  m_header->workerCount = workerCount;
+  m_header->capacity = capacity;
+  m_header->payloadSize = static_cast<boost::uint32_t>(payloadSize);
+  m_header->slotCount = payloadCount;
+  m_header->slotStride = static_cast<boost::uint32_t>(slotStride);
+  m_header->workerStride = static_cast<boost::uint32_t>(workerStride);
+  m_header->workersOffset = static_cast<boost::uint32_t>(workersOffset);
+  m_header->slotsOffset = slotsOffset;
+
+  init(workerCount, capacity, payloadCount);
+}
+
+scShmTaskPool::scShmTaskPool(const scString &a_path): m_header(SC_NULL), m_base(SC_NULL)
+{
+  m_memory.reset(new scSharedMemory(a_path, scsmReadWrite, 0, 0));
+  attach();
+}
+
+scShmTaskPool::~scShmTaskPool()
+{
+}
+
+void scShmTaskPool::init(uint workerCount, uint queueCapacity, uint payloadCount)
+{
+  for(uint w = 0; w < workerCount; w++)
+  {
+    scShmTaskWorkerArea *worker = getWorker(w);
+    worker->top = worker->bottom = 0;
+    worker->enqueuePos = worker->dequeuePos = 0;
+    worker->executed = worker->stolen = 0;
+
+    boost::uint32_t *cells = getInboxCells(w);
+    for(boost::uint32_t i = 0; i < queueCapacity; i++) {
+      cells[2 * i] = i;  // sequence
+      cells[2 * i + 1] = 0;
+    }
+  }
+
+  for(boost::uint32_t i = 0; i < payloadCount; i++)
+    reinterpret_cast<scShmTaskSlot *>(getSlot(i))->next = (i + 1 < payloadCount)?i + 2:0;
+
+  m_header->freeHead = 1;
+  m_header->sleepers = m_header->wakeSeq = m_header->nextWorker = 0;
+
+  shm_pool_fence();
+  atomic_write32(&m_header->magic, SC_SHM_POOL_MAGIC);
+}
+
+void scShmTaskPool::attach()
+{
+  m_base = static_cast<char *>(m_memory->getAddress());
+  m_header = reinterpret_cast<scShmTaskPoolHeader *>(m_base);
+  if (atomic_read32(&m_header->magic) != SC_SHM_POOL_MAGIC)
+    throw scError("Shared task pool not initialized");
+}
+
+scShmTaskWorkerArea *scShmTaskPool::getWorker(uint workerNo) const
+{
+  return reinterpret_cast<scShmTaskWorkerArea *>(m_base + m_header->workersOffset + workerNo * m_header->workerStride);
+}
+
+boost::uint32_t *scShmTaskPool::getDequeBuffer(uint workerNo) const
+{
+  return reinterpret_cast<boost::uint32_t *>(reinterpret_cast<char *>(getWorker(workerNo)) + sizeof(scShmTaskWorkerArea));
+}
+
+boost::uint32_t *scShmTaskPool::getInboxCells(uint workerNo) const
+{
+  return getDequeBuffer(workerNo) + m_header->capacity;
+}
+
+char *scShmTaskPool::getSlot(boost::uint32_t slotNo) const
+{
+  return m_base + static_cast<size_t>(m_header->slotsOffset) + static_cast<size_t>(slotNo) * m_header->slotStride;
+}
+
+// ----------------------------------------------------------------------------
+// payload slots - lock-free stack
+// ----------------------------------------------------------------------------
+boost::uint32_t scShmTaskPool::allocSlot()
+{
+  for(;;) {
+    boost::uint64_t head = shm_pool_read64(&m_header->freeHead);
+    boost::uint32_t first = static_cast<boost::uint32_t>(head);
+    if (first == 0)
+      return 0;
+
+    boost::uint32_t next = reinterpret_cast<volatile scShmTaskSlot *>(getSlot(first - 1))->next;
+    boost::uint64_t newHead = (((head >> 32) + 1) << 32) | next;
+    if (shm_pool_cas64(&m_header->freeHead, newHead, head) == head)
+      return first;
+  }
+}
+
+void scShmTaskPool::freeSlot(boost::uint32_t slotNo)
+{
+  volatile scShmTaskSlot *slot = reinterpret_cast<volatile scShmTaskSlot *>(getSlot(slotNo - 1));
+  for(;;) {
+    boost::uint64_t head = shm_pool_read64(&m_header->freeHead);
+    slot->next = static_cast<boost::uint32_t>(head);
+    boost::uint64_t newHead = (((head >> 32) + 1) << 32) | slotNo;
+    if (shm_pool_cas64(&m_header->freeHead, newHead, head) == head)
+      return;
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Chase-Lev deque, push & pop by owner only
+// ----------------------------------------------------------------------------
+bool scShmTaskPool::dequePush(uint workerNo, boost::uint32_t slotNo)
+{
+  scShmTaskWorkerArea *worker = getWorker(workerNo);
+  boost::uint32_t b = atomic_read32(&worker->bottom);
+  boost::uint32_t t = atomic_read32(&worker->top);
+  if (static_cast<boost::int32_t>(b - t) >= static_cast<boost::int32_t>(m_header->capacity))
+    return false;
+
+  getDequeBuffer(workerNo)[b & (m_header->capacity - 1)] = slotNo;
+  shm_pool_fence();
+  atomic_write32(&worker->bottom, b + 1);
+  return true;
+}
+
+bool scShmTaskPool::dequePop(uint workerNo, boost::uint32_t &slotNo)
+{
+  scShmTaskWorkerArea *worker = getWorker(workerNo);
+  boost::uint32_t b = atomic_read32(&worker->bottom) - 1;
+  atomic_write32(&worker->bottom, b);
+  shm_pool_fence();
+  boost::uint32_t t = atomic_read32(&worker->top);
+
+  if (static_cast<boost::int32_t>(b - t) < 0) {
+    atomic_write32(&worker->bottom, b + 1);
+    return false;
+  }
+
+  slotNo = getDequeBuffer(workerNo)[b & (m_header->capacity - 1)];
+  if (b != t)
+    return true;
+
+  // last item - race with thieves
+  bool res = (atomic_cas32(&worker->top, t + 1, t) == t);
+  atomic_write32(&worker->bottom, b + 1);
+  return res;
+}
+
+bool scShmTaskPool::dequeSteal(uint workerNo, boost::uint32_t &slotNo)
+{
+  scShmTaskWorkerArea *worker = getWorker(workerNo);
+  boost::uint32_t t = atomic_read32(&worker->top);
+  shm_pool_fence();
+  boost::uint32_t b = atomic_read32(&worker->bottom);
+
+  if (static_cast<boost::int32_t>(b - t) <= 0)
+    return false;
+
+  slotNo = getDequeBuffer(workerNo)[t & (m_header->capacity - 1)];
+  return (atomic_cas32(&worker->top, t + 1, t) == t);
+}
+
+// ----------------------------------------------------------------------------
+// inbox - bounded MPMC queue (cells: sequence, slot)
+// ----------------------------------------------------------------------------
+bool scShmTaskPool::inboxPush(uint workerNo, boost::uint32_t slotNo)
+{
+  scShmTaskWorkerArea *worker = getWorker(workerNo);
+  volatile boost::uint32_t *cells = getInboxCells(workerNo);
+  boost::uint32_t mask = m_header->capacity - 1;
+  boost::uint32_t pos;
+
+  for(;;) {
+    pos = atomic_read32(&worker->enqueuePos);
+    boost::uint32_t seq = atomic_read32(&cells[2 * (pos & mask)]);
+    boost::int32_t diff = static_cast<boost::int32_t>(seq - pos);
+    if (diff == 0) {
+      if (atomic_cas32(&worker->enqueuePos, pos + 1, pos) == pos)
+        break;
+    } else if (diff < 0) {
+      return false;
+    }
+  }
+
+  cells[2 * (pos & mask) + 1] = slotNo;
+  shm_pool_fence();
+  atomic_write32(&cells[2 * (pos & mask)], pos + 1);
+  return true;
+}
+
+bool scShmTaskPool::inboxPop(uint workerNo, boost::uint32_t &slotNo)
+{
+  scShmTaskWorkerArea *worker = getWorker(workerNo);
+  volatile boost::uint32_t *cells = getInboxCells(workerNo);
+  boost::uint32_t mask = m_header->capacity - 1;
+  boost::uint32_t pos;
+
+  for(;;) {
+    pos = atomic_read32(&worker->dequeuePos);
+    boost::uint32_t seq = atomic_read32(&cells[2 * (pos & mask)]);
+    boost::int32_t diff = static_cast<boost::int32_t>(seq - (pos + 1));
+    if (diff == 0) {
+      if (atomic_cas32(&worker->dequeuePos, pos + 1, pos) == pos)
+        break;
+    } else if (diff < 0) {
+      return false;
+    }
+  }
+
+  slotNo = cells[2 * (pos & mask) + 1];
+  shm_pool_fence();
+  atomic_write32(&cells[2 * (pos & mask)], pos + mask + 1);
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+// scheduling
+// ----------------------------------------------------------------------------
+bool scShmTaskPool::findTask(uint workerNo, boost::uint32_t &slotNo, bool &stolen)
+{
+  stolen = false;
+  if (dequePop(workerNo, slotNo) || inboxPop(workerNo, slotNo))
+    return true;
+
+  uint workerCount = m_header->workerCount;
+  for(uint i = 1; i < workerCount; i++)
+  {
+    uint victim = (workerNo + i) % workerCount;
+    if (dequeSteal(victim, slotNo) || inboxPop(victim, slotNo)) {
+      stolen = true;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void scShmTaskPool::notifyWorker()
+{
+  // pairs with increment of sleepers in runNext
+  shm_pool_fence();
+  if (atomic_read32(&m_header->sleepers) == 0)
+    return;
+
+  atomic_inc32(&m_header->wakeSeq);
+#ifdef SCSHM_POOL_FUTEX
+  syscall(SYS_futex, &m_header->wakeSeq, FUTEX_WAKE, 1, SC_NULL, SC_NULL, 0);
+#endif
+}
+
+void scShmTaskPool::waitForTask(boost::uint32_t wakeSeq, uint waitMs)
+{
+#ifdef SCSHM_POOL_FUTEX
+  struct timespec timeout;
+  timeout.tv_sec = waitMs / 1000;
+  timeout.tv_nsec = (waitMs % 1000) * 1000000L;
+  // returns immediately if task was submitted after wakeSeq was read
+  syscall(SYS_futex, &m_header->wakeSeq, FUTEX_WAIT, wakeSeq, &timeout, SC_NULL, 0);
+#else
+  for(uint i = 0; (i < waitMs) && (atomic_read32(&m_header->wakeSeq) == wakeSeq); i++)
+    thread_sleep(1);
+#endif
+}
+
+bool scShmTaskPool::enqueue(boost::uint32_t slotNo, uint workerNo)
+{
+  uint workerCount = m_header->workerCount;
+  if (workerNo == SC_SHM_POOL_ANY_WORKER)
+    workerNo = atomic_inc32(&m_header->nextWorker) % workerCount;
+  else if (workerNo >= workerCount)
+    throw scError(scString("Incorrect worker number: ")+toString(workerNo));
+
+  // overflow goes to next inbox with free space
+  for(uint i = 0; i < workerCount; i++)
+    if (inboxPush((workerNo + i) % workerCount, slotNo)) {
+      notifyWorker();
+      return true;
+    }
+
+  freeSlot(slotNo);
+  return false;
+}
+
+bool scShmTaskPool::submit(const void *payload, size_t size, uint workerNo)
+{
+  if (size > m_header->payloadSize)
+    throw scError(scString("Task payload too large: ")+toString(size));
+
+  boost::uint32_t slotNo = allocSlot();
+  if (slotNo == 0)
+    return false;
+
+  scShmTaskSlot *slot = reinterpret_cast<scShmTaskSlot *>(getSlot(slotNo - 1));
+  if (size > 0)
+    std::memcpy(slot + 1, payload, size);
+  slot->size = static_cast<boost::uint32_t>(size);
+
+  return enqueue(slotNo, workerNo);
+}
+
+bool scShmTaskPool::submit(scShmWinWriterIntf *writer, uint workerNo)
+{
+  boost::uint32_t slotNo = allocSlot();
+  if (slotNo == 0)
+    return false;
+
+  scShmTaskSlot *slot = reinterpret_cast<scShmTaskSlot *>(getSlot(slotNo - 1));
+  size_t size;
+  try {
+    size = writer->write(reinterpret_cast<char *>(slot + 1), m_header->payloadSize);
+  }
+  catch(...) {
+    freeSlot(slotNo);
+    throw;
+  }
+  slot->size = static_cast<boost::uint32_t>(size);
+
+  return enqueue(slotNo, workerNo);
+}
+
+bool scShmTaskPool::spawn(uint workerNo, const void *payload, size_t size)
+{
+  if (size > m_header->payloadSize)
+    throw scError(scString("Task payload too large: ")+toString(size));
+  if (workerNo >= m_header->workerCount)
+    throw scError(scString("Incorrect worker number: ")+toString(workerNo));
+
+  boost::uint32_t slotNo = allocSlot();
+  if (slotNo == 0)
+    return false;
+
+  scShmTaskSlot *slot = reinterpret_cast<scShmTaskSlot *>(getSlot(slotNo - 1));
+  if (size > 0)
+    std::memcpy(slot + 1, payload, size);
+  slot->size = static_cast<boost::uint32_t>(size);
+
+  if (!dequePush(workerNo, slotNo))
+    return enqueue(slotNo, workerNo);
+
+  notifyWorker();
+  return true;
+}
+
+bool scShmTaskPool::runNext(uint workerNo, scShmWinConsumerIntf *consumer, uint waitMs)
+{
+  if (workerNo >= m_header->workerCount)
+    throw scError(scString("Incorrect worker number: ")+toString(workerNo));
+
+  boost::uint32_t slotNo;
+  bool stolen;
+  bool found = findTask(workerNo, slotNo, stolen);
+
+  if (!found && (waitMs > 0)) {
+    // announce sleep before last check, so submitter either sees sleeper
+    // or we see its task
+    atomic_inc32(&m_header->sleepers);
+    boost::uint32_t wakeSeq = atomic_read32(&m_header->wakeSeq);
+    found = findTask(workerNo, slotNo, stolen);
+    if (!found)
+      waitForTask(wakeSeq, waitMs);
+    atomic_dec32(&m_header->sleepers);
+    if (!found)
+      found = findTask(workerNo, slotNo, stolen);
+  }
+
+  if (!found)
+    return false;
+
+  scShmTaskSlot *slot = reinterpret_cast<scShmTaskSlot *>(getSlot(slotNo - 1));
+  try {
+    consumer->process(reinterpret_cast<const char *>(slot + 1), slot->size);
+  }
+  catch(...) {
+    freeSlot(slotNo);
+    throw;
+  }
+  freeSlot(slotNo);
+
+  scShmTaskWorkerArea *worker = getWorker(workerNo);
+  atomic_inc32(&worker->executed);
+  if (stolen)
+    atomic_inc32(&worker->stolen);
+
+  return true;
+}
+
+uint scShmTaskPool::getWorkerCount() const
+{
+  return m_header->workerCount;
+}
+
+size_t scShmTaskPool::getPayloadSize() const
+{
+  return m_header->payloadSize;
+}
+
+uint scShmTaskPool::getExecutedCount(uint workerNo) const
+{
+  return atomic_read32(&getWorker(workerNo)->executed);
+}
+
+uint scShmTaskPool::getStolenCount(uint workerNo) const
+{
+  return atomic_read32(&getWorker(workerNo)->stolen);
+}